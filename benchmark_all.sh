@@ -16,10 +16,12 @@ RESET='\033[0m'
 ARRAY_SIZES=(1000 5000 300000)
 THREAD_COUNTS=(1 3 5 7 9 11)
 PROCESS_COUNTS=(1 3 5 7 9 11)
+# Phân phối dữ liệu (ghi đè bằng biến môi trường OGT_DISTRIBUTIONS="uniform sorted ...")
+DISTRIBUTIONS=(${OGT_DISTRIBUTIONS:-uniform sorted reverse nearly-sorted few-unique zipf organ-pipe sawtooth all-equal sorted-runs})
 EXECUTABLE="./build/parallel_sort"
 
 # Lưu trữ kết quả (sử dụng mảng indexed thay vì associative)
-# Định dạng: kết quả được lưu như "size:threads:time"
+# Định dạng: kết quả được lưu như "dist:size:threads:time"
 openmp_results=()
 pthread_results=()
 mpi_results=()
@@ -53,7 +55,8 @@ echo -e "\n${CYAN}📊 Cấu Hình Test:${RESET}"
 echo -e "Kích thước mảng: ${ARRAY_SIZES[*]}"
 echo -e "Số lượng luồng: ${THREAD_COUNTS[*]}"
 echo -e "Số lượng tiến trình: ${PROCESS_COUNTS[*]}"
-echo -e "Tổng số test: $((${#ARRAY_SIZES[@]} * ${#THREAD_COUNTS[@]} * 3)) tests"
+echo -e "Phân phối dữ liệu: ${DISTRIBUTIONS[*]}"
+echo -e "Tổng số test: $((${#DISTRIBUTIONS[@]} * ${#ARRAY_SIZES[@]} * ${#THREAD_COUNTS[@]} * 3)) tests"
 
 # Xây dựng project
 echo -e "\n${YELLOW}🔨 Đang xây dựng project...${RESET}"
@@ -79,15 +82,16 @@ extract_time() {
     esac
     
     # Tìm phương pháp trong bảng so sánh và trích xuất thời gian
-    echo "$output" | grep -A 5 "Phương Pháp.*Thời Gian TB" | grep -E "^\s*${local_method}\s*\|" | awk -F'|' '{print $2}' | awk '{print $1}'
+    echo "$output" | grep -A 5 "Phương Pháp.*Trung Vị" | grep -E "^\s*${local_method}\s*\|" | awk -F'|' '{print $2}' | awk '{print $1}'
 }
 
-# Hàm lấy kết quả từ mảng theo kích thước và số luồng
+# Hàm lấy kết quả từ mảng theo phân phối, kích thước và số luồng
 get_result() {
     local array_name=$1
-    local size=$2
-    local threads=$3
-    local key="${size}:${threads}"
+    local dist=$2
+    local size=$3
+    local threads=$4
+    local key="${dist}:${size}:${threads}"
     
     case $array_name in
         "openmp")
@@ -120,52 +124,55 @@ get_result() {
 
 # Hàm chạy benchmark OpenMP
 run_openmp_benchmark() {
-    local size=$1
-    local threads=$2
+    local dist=$1
+    local size=$2
+    local threads=$3
     
-    echo -e "${BLUE}  Đang test: OpenMP - Kích thước: ${size}, Luồng: ${threads}${RESET}"
+    echo -e "${BLUE}  Đang test: OpenMP - Phân phối: ${dist}, Kích thước: ${size}, Luồng: ${threads}${RESET}"
     
     # Chạy benchmark OpenMP cụ thể (tùy chọn 2, tùy chọn phụ 2)
-    local output=$(echo -e "2\n2\n${size}\n${threads}\n0\n0\n0" | ${EXECUTABLE} 2>/dev/null)
+    local output=$(echo -e "2\n2\n${size}\n${threads}\n0\n0\n0" | OGT_DIST=${dist} ${EXECUTABLE} 2>/dev/null)
     
     if [ $? -eq 0 ] && [ -n "$output" ]; then
         # Trích xuất thời gian OpenMP cho số luồng cụ thể
-        local openmp_time=$(echo "$output" | grep -A 10 "Luồng.*Thời Gian TB" | grep -E "^\s*${threads}\s*\|" | awk -F'|' '{print $2}' | awk '{print $1}')
-        openmp_results+=("${size}:${threads}:${openmp_time}")
+        local openmp_time=$(echo "$output" | grep -A 10 "Luồng.*Trung Vị" | grep -E "^\s*${threads}\s*\|" | awk -F'|' '{print $2}' | awk '{print $1}')
+        openmp_results+=("${dist}:${size}:${threads}:${openmp_time}")
         echo -e "    ${GREEN}✓${RESET} OpenMP: ${openmp_time}s"
     else
         echo -e "    ${RED}✗ Test OpenMP thất bại${RESET}"
-        openmp_results+=("${size}:${threads}:FAIL")
+        openmp_results+=("${dist}:${size}:${threads}:FAIL")
     fi
 }
 
 # Hàm chạy benchmark Pthreads  
 run_pthread_benchmark() {
-    local size=$1
-    local threads=$2
+    local dist=$1
+    local size=$2
+    local threads=$3
     
-    echo -e "${BLUE}  Đang test: Pthreads - Kích thước: ${size}, Luồng: ${threads}${RESET}"
+    echo -e "${BLUE}  Đang test: Pthreads - Phân phối: ${dist}, Kích thước: ${size}, Luồng: ${threads}${RESET}"
     
     # Chạy benchmark Pthreads cụ thể (tùy chọn 3, tùy chọn phụ 2)
-    local output=$(echo -e "3\n2\n${size}\n${threads}\n0\n0\n0" | ${EXECUTABLE} 2>/dev/null)
+    local output=$(echo -e "3\n2\n${size}\n${threads}\n0\n0\n0" | OGT_DIST=${dist} ${EXECUTABLE} 2>/dev/null)
     
     if [ $? -eq 0 ] && [ -n "$output" ]; then
         # Trích xuất thời gian Pthreads cho số luồng cụ thể
-        local pthread_time=$(echo "$output" | grep -A 10 "Luồng.*Thời Gian TB" | grep -E "^\s*${threads}\s*\|" | awk -F'|' '{print $2}' | awk '{print $1}')
-        pthread_results+=("${size}:${threads}:${pthread_time}")
+        local pthread_time=$(echo "$output" | grep -A 10 "Luồng.*Trung Vị" | grep -E "^\s*${threads}\s*\|" | awk -F'|' '{print $2}' | awk '{print $1}')
+        pthread_results+=("${dist}:${size}:${threads}:${pthread_time}")
         echo -e "    ${GREEN}✓${RESET} Pthreads: ${pthread_time}s"
     else
         echo -e "    ${RED}✗ Test Pthreads thất bại${RESET}"
-        pthread_results+=("${size}:${threads}:FAIL")
+        pthread_results+=("${dist}:${size}:${threads}:FAIL")
     fi
 }
 
 # Hàm chạy benchmark MPI
 run_mpi_benchmark() {
-    local size=$1
-    local processes=$2
+    local dist=$1
+    local size=$2
+    local processes=$3
     
-    echo -e "${YELLOW}  Đang test: MPI - Kích thước: ${size}, Tiến trình: ${processes}${RESET}"
+    echo -e "${YELLOW}  Đang test: MPI - Phân phối: ${dist}, Kích thước: ${size}, Tiến trình: ${processes}${RESET}"
     
     # Chạy benchmark MPI cụ thể với oversubscribe nếu cần
     local mpi_cmd="mpirun"
@@ -174,16 +181,16 @@ run_mpi_benchmark() {
         echo -e "    ${YELLOW}⚠️  Sử dụng oversubscribe cho ${processes} > 10 cores${RESET}"
     fi
     
-    local output=$(echo -e "4\n2\n${size}\n0\n0\n0" | ${mpi_cmd} -np ${processes} ${EXECUTABLE} 2>/dev/null)
+    local output=$(echo -e "4\n2\n${size}\n0\n0\n0" | OGT_DIST=${dist} ${mpi_cmd} -np ${processes} ${EXECUTABLE} 2>/dev/null)
     
     if [ $? -eq 0 ] && [ -n "$output" ]; then
         # Trích xuất thời gian MPI cho số tiến trình cụ thể
-        local mpi_time=$(echo "$output" | grep -A 5 "Tiến Trình.*Thời Gian TB" | grep -E "^\s*${processes}\s*\|" | awk -F'|' '{print $2}' | awk '{print $1}')
-        mpi_results+=("${size}:${processes}:${mpi_time}")
+        local mpi_time=$(echo "$output" | grep -A 5 "Tiến Trình.*Trung Vị" | grep -E "^\s*${processes}\s*\|" | awk -F'|' '{print $2}' | awk '{print $1}')
+        mpi_results+=("${dist}:${size}:${processes}:${mpi_time}")
         echo -e "    ${GREEN}✓${RESET} MPI: ${mpi_time}s"
     else
         echo -e "    ${RED}✗ Test MPI thất bại${RESET}"
-        mpi_results+=("${size}:${processes}:FAIL")
+        mpi_results+=("${dist}:${size}:${processes}:FAIL")
     fi
 }
 
@@ -193,33 +200,37 @@ echo -e "\n${CYAN}🚀 Bắt đầu benchmark toàn diện...${RESET}"
 total_tests=0
 completed_tests=0
 
-# Test OpenMP (single process, multiple threads)
-echo -e "\n${MAGENTA}=== OPENMP BENCHMARK ===${RESET}"
-for size in "${ARRAY_SIZES[@]}"; do
-    for threads in "${THREAD_COUNTS[@]}"; do
-        ((total_tests++))
-        run_openmp_benchmark $size $threads
-        ((completed_tests++))
-        echo -e "${CYAN}Tiến độ: ${completed_tests}/${total_tests}${RESET}"
+for dist in "${DISTRIBUTIONS[@]}"; do
+    echo -e "\n${MAGENTA}##### PHÂN PHỐI: ${dist} #####${RESET}"
+
+    # Test OpenMP (single process, multiple threads)
+    echo -e "\n${MAGENTA}=== OPENMP BENCHMARK ===${RESET}"
+    for size in "${ARRAY_SIZES[@]}"; do
+        for threads in "${THREAD_COUNTS[@]}"; do
+            ((total_tests++))
+            run_openmp_benchmark $dist $size $threads
+            ((completed_tests++))
+            echo -e "${CYAN}Tiến độ: ${completed_tests}/${total_tests}${RESET}"
+        done
     done
-done
 
-# Test Pthreads (đơn tiến trình, đa luồng)
-echo -e "\n${MAGENTA}=== BENCHMARK PTHREADS ===${RESET}"
-for size in "${ARRAY_SIZES[@]}"; do
-    for threads in "${THREAD_COUNTS[@]}"; do
-        ((total_tests++))
-        run_pthread_benchmark $size $threads
-        ((completed_tests++))
-        echo -e "${CYAN}Tiến độ: ${completed_tests}/${total_tests}${RESET}"
+    # Test Pthreads (đơn tiến trình, đa luồng)
+    echo -e "\n${MAGENTA}=== BENCHMARK PTHREADS ===${RESET}"
+    for size in "${ARRAY_SIZES[@]}"; do
+        for threads in "${THREAD_COUNTS[@]}"; do
+            ((total_tests++))
+            run_pthread_benchmark $dist $size $threads
+            ((completed_tests++))
+            echo -e "${CYAN}Tiến độ: ${completed_tests}/${total_tests}${RESET}"
+        done
     done
-done
 
-# Test MPI (đa tiến trình)
-echo -e "\n${MAGENTA}=== BENCHMARK MPI ===${RESET}"
-for size in "${ARRAY_SIZES[@]}"; do
-    for processes in "${PROCESS_COUNTS[@]}"; do
-        run_mpi_benchmark $size $processes
+    # Test MPI (đa tiến trình)
+    echo -e "\n${MAGENTA}=== BENCHMARK MPI ===${RESET}"
+    for size in "${ARRAY_SIZES[@]}"; do
+        for processes in "${PROCESS_COUNTS[@]}"; do
+            run_mpi_benchmark $dist $size $processes
+        done
     done
 done
 
@@ -228,97 +239,99 @@ echo -e "\n${MAGENTA}╔══════════════════
 echo -e "${MAGENTA}║                 KẾT QUẢ TỔNG HỢP                    ║${RESET}"
 echo -e "${MAGENTA}╚══════════════════════════════════════════════════════╝${RESET}"
 
-echo -e "\n${CYAN}📊 KẾT QUẢ THỜI GIAN CHI TIẾT (giây)${RESET}"
-echo -e "\n${YELLOW}🔥 Kết Quả Kết Hợp (Count = Luồng cho OpenMP/Pthreads, Tiến trình cho MPI):${RESET}"
-printf "%-10s | %-8s | %-12s | %-12s | %-12s\n" "Kích Thước" "Số Lượng" "OpenMP" "Pthreads" "MPI"
-echo "---------------------------------------------------------------"
+for dist in "${DISTRIBUTIONS[@]}"; do
+    echo -e "\n${CYAN}📊 KẾT QUẢ THỜI GIAN CHI TIẾT (giây) - Phân phối: ${dist}${RESET}"
+    echo -e "\n${YELLOW}🔥 Kết Quả Kết Hợp (Count = Luồng cho OpenMP/Pthreads, Tiến trình cho MPI):${RESET}"
+    printf "%-10s | %-8s | %-12s | %-12s | %-12s\n" "Kích Thước" "Số Lượng" "OpenMP" "Pthreads" "MPI"
+    echo "---------------------------------------------------------------"
 
-for size in "${ARRAY_SIZES[@]}"; do
-    for count in "${THREAD_COUNTS[@]}"; do
-        openmp_time=$(get_result "openmp" "$size" "$count")
-        pthread_time=$(get_result "pthread" "$size" "$count")
-        mpi_time=$(get_result "mpi" "$size" "$count")
+    for size in "${ARRAY_SIZES[@]}"; do
+        for count in "${THREAD_COUNTS[@]}"; do
+            openmp_time=$(get_result "openmp" "$dist" "$size" "$count")
+            pthread_time=$(get_result "pthread" "$dist" "$size" "$count")
+            mpi_time=$(get_result "mpi" "$dist" "$size" "$count")
         
-        printf "%-10s | %-8s | %-12s | %-12s | %-12s\n" \
-            "$size" "$count" "$openmp_time" "$pthread_time" "$mpi_time"
+            printf "%-10s | %-8s | %-12s | %-12s | %-12s\n" \
+                "$size" "$count" "$openmp_time" "$pthread_time" "$mpi_time"
+        done
+        echo "---------------------------------------------------------------"
     done
-    echo "---------------------------------------------------------------"
-done
 
-# Tính toán và hiển thị thống kê tóm tắt
-echo -e "\n${CYAN}📈 TÓM TẮT HIỆU SUẤT${RESET}"
-echo -e "\n${YELLOW}Hiệu Suất Tốt Nhất Theo Kích Thước Mảng:${RESET}"
+    # Tính toán và hiển thị thống kê tóm tắt
+    echo -e "\n${CYAN}📈 TÓM TẮT HIỆU SUẤT${RESET}"
+    echo -e "\n${YELLOW}Hiệu Suất Tốt Nhất Theo Kích Thước Mảng (${dist}):${RESET}"
 
-for size in "${ARRAY_SIZES[@]}"; do
-    echo -e "\n${GREEN}Kích Thước Mảng: ${size} phần tử${RESET}"
+    for size in "${ARRAY_SIZES[@]}"; do
+        echo -e "\n${GREEN}Kích Thước Mảng: ${size} phần tử${RESET}"
     
-    best_openmp="N/A"
-    best_pthread="N/A" 
-    best_mpi="N/A"
-    best_openmp_time=999999
-    best_pthread_time=999999
-    best_mpi_time=999999
+        best_openmp="N/A"
+        best_pthread="N/A" 
+        best_mpi="N/A"
+        best_openmp_time=999999
+        best_pthread_time=999999
+        best_mpi_time=999999
     
-    # Tìm OpenMP và Pthreads tốt nhất (theo luồng)
-    for threads in "${THREAD_COUNTS[@]}"; do
-        openmp_time=$(get_result "openmp" "$size" "$threads")
-        pthread_time=$(get_result "pthread" "$size" "$threads")
+        # Tìm OpenMP và Pthreads tốt nhất (theo luồng)
+        for threads in "${THREAD_COUNTS[@]}"; do
+            openmp_time=$(get_result "openmp" "$dist" "$size" "$threads")
+            pthread_time=$(get_result "pthread" "$dist" "$size" "$threads")
         
-        if [[ "$openmp_time" != "FAIL" && "$openmp_time" != "N/A" && "$openmp_time" != "" ]]; then
-            if (( $(echo "$openmp_time < $best_openmp_time" | bc -l 2>/dev/null || echo 0) )); then
-                best_openmp_time=$openmp_time
-                best_openmp="${openmp_time}s (${threads} luồng)"
+            if [[ "$openmp_time" != "FAIL" && "$openmp_time" != "N/A" && "$openmp_time" != "" ]]; then
+                if (( $(echo "$openmp_time < $best_openmp_time" | bc -l 2>/dev/null || echo 0) )); then
+                    best_openmp_time=$openmp_time
+                    best_openmp="${openmp_time}s (${threads} luồng)"
+                fi
             fi
-        fi
         
-        if [[ "$pthread_time" != "FAIL" && "$pthread_time" != "N/A" && "$pthread_time" != "" ]]; then
-            if (( $(echo "$pthread_time < $best_pthread_time" | bc -l 2>/dev/null || echo 0) )); then
-                best_pthread_time=$pthread_time
-                best_pthread="${pthread_time}s (${threads} luồng)"
+            if [[ "$pthread_time" != "FAIL" && "$pthread_time" != "N/A" && "$pthread_time" != "" ]]; then
+                if (( $(echo "$pthread_time < $best_pthread_time" | bc -l 2>/dev/null || echo 0) )); then
+                    best_pthread_time=$pthread_time
+                    best_pthread="${pthread_time}s (${threads} luồng)"
+                fi
             fi
-        fi
-    done
+        done
     
-    # Tìm MPI tốt nhất (theo tiến trình)
-    for processes in "${PROCESS_COUNTS[@]}"; do
-        mpi_time=$(get_result "mpi" "$size" "$processes")
+        # Tìm MPI tốt nhất (theo tiến trình)
+        for processes in "${PROCESS_COUNTS[@]}"; do
+            mpi_time=$(get_result "mpi" "$dist" "$size" "$processes")
         
-        if [[ "$mpi_time" != "FAIL" && "$mpi_time" != "N/A" && "$mpi_time" != "" ]]; then
-            if (( $(echo "$mpi_time < $best_mpi_time" | bc -l 2>/dev/null || echo 0) )); then
-                best_mpi_time=$mpi_time
-                best_mpi="${mpi_time}s (${processes} tiến trình)"
+            if [[ "$mpi_time" != "FAIL" && "$mpi_time" != "N/A" && "$mpi_time" != "" ]]; then
+                if (( $(echo "$mpi_time < $best_mpi_time" | bc -l 2>/dev/null || echo 0) )); then
+                    best_mpi_time=$mpi_time
+                    best_mpi="${mpi_time}s (${processes} tiến trình)"
+                fi
             fi
-        fi
-    done
+        done
     
-    echo "  🚀 OpenMP tốt nhất:   $best_openmp"
-    echo "  🧵 Pthreads tốt nhất: $best_pthread" 
-    echo "  🌐 MPI tốt nhất:      $best_mpi"
+        echo "  🚀 OpenMP tốt nhất:   $best_openmp"
+        echo "  🧵 Pthreads tốt nhất: $best_pthread" 
+        echo "  🌐 MPI tốt nhất:      $best_mpi"
     
-    # Xác định tổng thể tốt nhất cho kích thước mảng này
-    overall_best_for_size=""
-    overall_best_time_for_size=999999
+        # Xác định tổng thể tốt nhất cho kích thước mảng này
+        overall_best_for_size=""
+        overall_best_time_for_size=999999
     
-    if [[ "$best_openmp_time" != "999999" && "$best_openmp_time" != "" ]] && (( $(echo "$best_openmp_time < $overall_best_time_for_size" | bc -l 2>/dev/null || echo 0) )); then
-        overall_best_time_for_size=$best_openmp_time
-        overall_best_for_size="OpenMP ($best_openmp)"
-    fi
+        if [[ "$best_openmp_time" != "999999" && "$best_openmp_time" != "" ]] && (( $(echo "$best_openmp_time < $overall_best_time_for_size" | bc -l 2>/dev/null || echo 0) )); then
+            overall_best_time_for_size=$best_openmp_time
+            overall_best_for_size="OpenMP ($best_openmp)"
+        fi
     
-    if [[ "$best_pthread_time" != "999999" && "$best_pthread_time" != "" ]] && (( $(echo "$best_pthread_time < $overall_best_time_for_size" | bc -l 2>/dev/null || echo 0) )); then
-        overall_best_time_for_size=$best_pthread_time
-        overall_best_for_size="Pthreads ($best_pthread)"
-    fi
+        if [[ "$best_pthread_time" != "999999" && "$best_pthread_time" != "" ]] && (( $(echo "$best_pthread_time < $overall_best_time_for_size" | bc -l 2>/dev/null || echo 0) )); then
+            overall_best_time_for_size=$best_pthread_time
+            overall_best_for_size="Pthreads ($best_pthread)"
+        fi
     
-    if [[ "$best_mpi_time" != "999999" && "$best_mpi_time" != "" ]] && (( $(echo "$best_mpi_time < $overall_best_time_for_size" | bc -l 2>/dev/null || echo 0) )); then
-        overall_best_time_for_size=$best_mpi_time
-        overall_best_for_size="MPI ($best_mpi)"
-    fi
+        if [[ "$best_mpi_time" != "999999" && "$best_mpi_time" != "" ]] && (( $(echo "$best_mpi_time < $overall_best_time_for_size" | bc -l 2>/dev/null || echo 0) )); then
+            overall_best_time_for_size=$best_mpi_time
+            overall_best_for_size="MPI ($best_mpi)"
+        fi
     
-    if [[ "$overall_best_for_size" != "" ]]; then
-        echo -e "  ${GREEN}→ Lựa chọn tốt nhất: $overall_best_for_size${RESET}"
-    else
-        echo "  → Lựa chọn tốt nhất: N/A"
-    fi
+        if [[ "$overall_best_for_size" != "" ]]; then
+            echo -e "  ${GREEN}→ Lựa chọn tốt nhất: $overall_best_for_size${RESET}"
+        else
+            echo "  → Lựa chọn tốt nhất: N/A"
+        fi
+    done
 done
 
 echo -e "\n${MAGENTA}🏆 NHẤT TOÀN DIỆN${RESET}"
@@ -328,34 +341,38 @@ overall_best_method=""
 overall_best_config=""
 
 # Kiểm tra OpenMP và Pthreads (theo luồng)
-for size in "${ARRAY_SIZES[@]}"; do
-    for threads in "${THREAD_COUNTS[@]}"; do
-        for method in "openmp" "pthread"; do
-            time_value=$(get_result "$method" "$size" "$threads")
-            
-            if [[ "$time_value" != "FAIL" && "$time_value" != "N/A" && "$time_value" != "" ]]; then
-                if (( $(echo "$time_value < $overall_best_time" | bc -l 2>/dev/null || echo 0) )); then
-                    overall_best_time=$time_value
-                    overall_best_method=$(echo $method | tr '[:lower:]' '[:upper:]')
-                    overall_best_config="Kích thước: ${size}, Luồng: ${threads}"
+for dist in "${DISTRIBUTIONS[@]}"; do
+    for size in "${ARRAY_SIZES[@]}"; do
+        for threads in "${THREAD_COUNTS[@]}"; do
+            for method in "openmp" "pthread"; do
+                time_value=$(get_result "$method" "$dist" "$size" "$threads")
+                
+                if [[ "$time_value" != "FAIL" && "$time_value" != "N/A" && "$time_value" != "" ]]; then
+                    if (( $(echo "$time_value < $overall_best_time" | bc -l 2>/dev/null || echo 0) )); then
+                        overall_best_time=$time_value
+                        overall_best_method=$(echo $method | tr '[:lower:]' '[:upper:]')
+                        overall_best_config="Phân phối: ${dist}, Kích thước: ${size}, Luồng: ${threads}"
+                    fi
                 fi
-            fi
+            done
         done
     done
 done
 
 # Kiểm tra MPI (theo tiến trình)
-for size in "${ARRAY_SIZES[@]}"; do
-    for processes in "${PROCESS_COUNTS[@]}"; do
-        time_value=$(get_result "mpi" "$size" "$processes")
-        
-        if [[ "$time_value" != "FAIL" && "$time_value" != "N/A" && "$time_value" != "" ]]; then
-            if (( $(echo "$time_value < $overall_best_time" | bc -l 2>/dev/null || echo 0) )); then
-                overall_best_time=$time_value
-                overall_best_method="MPI"
-                overall_best_config="Kích thước: ${size}, Tiến trình: ${processes}"
+for dist in "${DISTRIBUTIONS[@]}"; do
+    for size in "${ARRAY_SIZES[@]}"; do
+        for processes in "${PROCESS_COUNTS[@]}"; do
+            time_value=$(get_result "mpi" "$dist" "$size" "$processes")
+            
+            if [[ "$time_value" != "FAIL" && "$time_value" != "N/A" && "$time_value" != "" ]]; then
+                if (( $(echo "$time_value < $overall_best_time" | bc -l 2>/dev/null || echo 0) )); then
+                    overall_best_time=$time_value
+                    overall_best_method="MPI"
+                    overall_best_config="Phân phối: ${dist}, Kích thước: ${size}, Tiến trình: ${processes}"
+                fi
             fi
-        fi
+        done
     done
 done
 
@@ -13,6 +13,7 @@ CYAN='\033[36m'
 RESET='\033[0m'
 
 BENCHMARK_DIR="benchmark"
+OGT_BENCH="${OGT_BENCH:-./build/ogt_bench}"
 
 show_help() {
     echo -e "${CYAN}🔧 BENCHMARK MANAGER - Công cụ quản lý kết quả benchmark${RESET}"
@@ -22,7 +23,12 @@ show_help() {
     echo -e "  ${GREEN}list${RESET}     - Liệt kê tất cả file benchmark"
     echo -e "  ${GREEN}latest${RESET}   - Xem file benchmark mới nhất"
     echo -e "  ${GREEN}view${RESET}     - Xem file benchmark cụ thể"
-    echo -e "  ${GREEN}compare${RESET}  - So sánh 2 file benchmark"
+    echo -e "  ${GREEN}record${RESET}   - Chạy ogt_bench, lưu kết quả CSV vào benchmark/ogt_bench-vN.csv"
+    echo -e "             (tham số thêm được chuyển cho ogt_bench, vd: record -b pthreads -n 50000 -t 4)"
+    echo -e "  ${GREEN}compare${RESET}  - So sánh 2 file kết quả ogt_bench (mặc định: 2 file mới nhất)"
+    echo -e "             compare [BASE NEW] [--threshold P]; mã thoát 1 nếu có cấu hình chậm đi"
+    echo -e "  ${GREEN}scaling${RESET}  - Nghiên cứu mở rộng strong/weak (speedup, hiệu suất, Karp–Flatt)"
+    echo -e "             scaling [strong|weak] [tham số ogt_bench]; lưu benchmark/scaling-<chế độ>-vN.csv"
     echo -e "  ${GREEN}clean${RESET}    - Dọn dẹp file cũ (giữ lại 5 file gần nhất)"
     echo -e "  ${GREEN}stats${RESET}    - Thống kê tổng quan"
     echo -e "  ${GREEN}help${RESET}     - Hiển thị hướng dẫn này"
@@ -112,6 +118,81 @@ clean_old() {
     echo -e "${GREEN}✅ Dọn dẹp hoàn thành!${RESET}"
 }
 
+record_benchmark() {
+    if [ ! -x "$OGT_BENCH" ]; then
+        echo -e "${RED}❌ Không tìm thấy $OGT_BENCH (build trước hoặc đặt biến OGT_BENCH).${RESET}"
+        return 2
+    fi
+    
+    mkdir -p "$BENCHMARK_DIR"
+    local latest=$(ls $BENCHMARK_DIR/ogt_bench-v*.csv 2>/dev/null | sed 's/.*-v\([0-9]*\)\.csv/\1/' | sort -n | tail -1)
+    local output_file="$BENCHMARK_DIR/ogt_bench-v$(( ${latest:-0} + 1 )).csv"
+    
+    echo -e "${CYAN}📊 Đang chạy: $OGT_BENCH -f csv $*${RESET}"
+    if "$OGT_BENCH" -f csv -o "$output_file" "$@"; then
+        echo -e "${GREEN}✅ Đã lưu: $output_file${RESET}"
+    else
+        echo -e "${RED}❌ ogt_bench thất bại${RESET}"
+        return 1
+    fi
+}
+
+scaling_study() {
+    if [ ! -x "$OGT_BENCH" ]; then
+        echo -e "${RED}❌ Không tìm thấy $OGT_BENCH (build trước hoặc đặt biến OGT_BENCH).${RESET}"
+        return 2
+    fi
+    
+    local mode=strong
+    if [ "$1" = "strong" ] || [ "$1" = "weak" ]; then
+        mode=$1
+        shift
+    fi
+    
+    mkdir -p "$BENCHMARK_DIR"
+    local latest=$(ls $BENCHMARK_DIR/scaling-$mode-v*.csv 2>/dev/null | sed 's/.*-v\([0-9]*\)\.csv/\1/' | sort -n | tail -1)
+    local output_file="$BENCHMARK_DIR/scaling-$mode-v$(( ${latest:-0} + 1 )).csv"
+    
+    echo -e "${CYAN}📈 Đang chạy: $OGT_BENCH --scaling $mode -f csv --summary $*${RESET}"
+    if "$OGT_BENCH" --scaling "$mode" -f csv --summary -o "$output_file" "$@"; then
+        echo -e "${GREEN}✅ Đã lưu: $output_file${RESET} (cột workers, speedup, efficiency, karp_flatt để vẽ đồ thị)"
+    else
+        echo -e "${RED}❌ ogt_bench thất bại${RESET}"
+        return 1
+    fi
+}
+
+compare_benchmarks() {
+    if [ ! -x "$OGT_BENCH" ]; then
+        echo -e "${RED}❌ Không tìm thấy $OGT_BENCH (build trước hoặc đặt biến OGT_BENCH).${RESET}"
+        return 2
+    fi
+    
+    local base new
+    if [ $# -ge 2 ] && [[ "$1" != --* ]]; then
+        base=$1
+        new=$2
+        shift 2
+    else
+        # Mặc định: so sánh hai file ogt_bench mới nhất
+        local files=($(ls $BENCHMARK_DIR/ogt_bench-v*.csv $BENCHMARK_DIR/ogt_bench-v*.jsonl 2>/dev/null | sort -V | tail -2))
+        if [ ${#files[@]} -lt 2 ]; then
+            echo -e "${RED}❌ Cần ít nhất 2 file ogt_bench-v*.csv/.jsonl trong $BENCHMARK_DIR (dùng: $0 record).${RESET}"
+            return 2
+        fi
+        base=${files[0]}
+        new=${files[1]}
+    fi
+    
+    "$OGT_BENCH" --compare "$base" "$new" "$@"
+    local status=$?
+    
+    if [ $status -eq 1 ]; then
+        echo -e "${RED}⚠️  Phát hiện chậm đi có ý nghĩa thống kê.${RESET}"
+    fi
+    return $status
+}
+
 show_stats() {
     echo -e "${CYAN}📊 Thống kê benchmark:${RESET}"
     
@@ -148,6 +229,21 @@ case "${1:-help}" in
     "clean")
         clean_old
         ;;
+    "record")
+        shift
+        record_benchmark "$@"
+        exit $?
+        ;;
+    "compare")
+        shift
+        compare_benchmarks "$@"
+        exit $?
+        ;;
+    "scaling")
+        shift
+        scaling_study "$@"
+        exit $?
+        ;;
     "stats")
         show_stats
         ;;
@@ -28,30 +28,731 @@
 #define MAGENTA "\033[35m"
 #define CYAN    "\033[36m"
 
+// ========== BỘ ĐẾM PHẦN CỨNG ==========
+// Đo bằng perf_event_open trên Linux; bộ đếm không mở được sẽ bị bỏ qua
+typedef enum {
+    OGT_COUNTER_CYCLES = 0,
+    OGT_COUNTER_INSTRUCTIONS,
+    OGT_COUNTER_L1D_MISSES,     // L1 data, đọc trượt
+    OGT_COUNTER_LLC_MISSES,     // cache cấp cuối
+    OGT_COUNTER_BRANCH_MISSES,
+    OGT_COUNTER_DTLB_MISSES,
+    OGT_COUNTER_COUNT
+} OGTCounter;
+
+// Các file descriptor bộ đếm của một luồng (-1 nếu không khả dụng)
+typedef struct {
+    int fd[OGT_COUNTER_COUNT];
+} OGTCounterGroup;
+
+// Giá trị bộ đếm; bit c của valid bật nếu bộ đếm c đo được
+typedef struct {
+    double value[OGT_COUNTER_COUNT];
+    unsigned int valid;
+} OGTCounterValues;
+
+// Bật/tắt thu thập bộ đếm trong các hàm *Stats (phải gọi giống nhau trên mọi rank)
+void setHardwareCounters(int enabled);
+int getHardwareCounters(void);
+unsigned int hardwareCountersAvailable(void);
+const char* counterName(OGTCounter counter);
+int counterGroupOpen(OGTCounterGroup* group);
+void counterGroupStart(OGTCounterGroup* group);
+void counterGroupStop(OGTCounterGroup* group, OGTCounterValues* out);
+void counterGroupClose(OGTCounterGroup* group);
+int counterBegin(OGTCounterGroup* group);
+void counterEnd(OGTCounterGroup* group, OGTCounterValues* out);
+void addCounterValues(OGTCounterValues* sum, const OGTCounterValues* values);
+int counterValid(const OGTCounterValues* values, OGTCounter counter);
+double counterIPC(const OGTCounterValues* values);
+
+// ========== TRACE TIMELINE ==========
+// Sự kiện theo luồng/rank xuất ra JSON Chrome trace-event (Perfetto, chrome://tracing)
+// Dùng: unsigned long long t = traceNow(); ...; traceSpan("merge", t, n);
+int traceStart(const char* path);
+int traceStop(void);
+int traceEnabled(void);
+unsigned long long traceNow(void);
+void traceSpan(const char* name, unsigned long long start, long long count);
+
+// ========== KẾ TOÁN BỘ NHỚ ==========
+// Cấp phát tạm của các hàm sắp xếp đi qua ogtMalloc/ogtCalloc/ogtFree để được đếm
+void* ogtMalloc(size_t size);
+void* ogtCalloc(size_t count, size_t size);
+void ogtFree(void* ptr);
+long long memLiveBytes(void);
+// VmHWM/VmRSS trong /proc/self/status (kB), -1 nếu không có
+long peakRSSKB(void);
+long currentRSSKB(void);
+
+// Bộ nhớ của một lần sắp xếp
+typedef struct {
+    long long bytes_allocated;  // tổng byte đã cấp phát
+    long long allocations;      // số lần cấp phát
+    long long peak_bytes;       // đỉnh byte sống vượt mức lúc bắt đầu
+    long long peak_rss_kb;      // đỉnh RSS của tiến trình, -1 nếu không đọc được
+} OGTMemStats;
+
+typedef struct {
+    long long live;
+    long long allocated;
+    long long allocations;
+    int slot;                   // ô đỉnh riêng, -1 nếu hết ô
+} OGTMemScope;
+
+// Bao một lần sắp xếp; lồng nhau hay đồng thời đều được, đỉnh RSS đặt lại khi không phạm vi nào khác mở
+// Khi nhiều lần sắp xếp chạy đồng thời, số liệu gồm cả cấp phát của các lần kia (cận trên)
+void memScopeBegin(OGTMemScope* scope);
+void memScopeEnd(const OGTMemScope* scope, OGTMemStats* out);
+
+// ========== THỐNG KÊ THEO PHA ==========
+// Các pha của một lần sắp xếp
+typedef enum {
+    OGT_PHASE_SPLIT = 0,    // chia khối, cấp phát vùng làm việc
+    OGT_PHASE_COPY,         // copy dữ liệu vào vùng làm việc
+    OGT_PHASE_SORT,         // sắp xếp các khối
+    OGT_PHASE_MERGE,        // trộn các khối đã sắp xếp
+    OGT_PHASE_COPY_BACK,    // copy kết quả về mảng gốc
+    OGT_PHASE_COMM,         // giao tiếp giữa các tiến trình (MPI)
+    OGT_PHASE_COUNT
+} OGTPhase;
+
+#define OGT_STATS_MAX_THREADS 64
+
+// Thời gian (giây) theo pha của một lần sắp xếp
+// phase_time: thời gian thực của từng pha trên luồng gọi
+// thread_time: thời gian của từng luồng trong các pha song song
+// phase_counters/thread_counters: bộ đếm phần cứng (khi bật setHardwareCounters),
+// tổng theo pha và của pha sort trên từng luồng (từng rank với MPI)
+// phase_bytes: lượng dữ liệu tối thiểu pha copy/merge/copy-back phải di chuyển
+// memory: cấp phát và đỉnh RSS của lần sắp xếp (của rank 0 với MPI)
+typedef struct {
+    double total_time;
+    double phase_time[OGT_PHASE_COUNT];
+    int num_threads;
+    double thread_time[OGT_STATS_MAX_THREADS][OGT_PHASE_COUNT];
+    OGTCounterValues phase_counters[OGT_PHASE_COUNT];
+    OGTCounterValues thread_counters[OGT_STATS_MAX_THREADS];
+    double phase_bytes[OGT_PHASE_COUNT];    // byte tối thiểu đọc + ghi của pha chịu giới hạn bộ nhớ
+    OGTMemStats memory;
+} OGTSortStats;
+
+void resetSortStats(OGTSortStats* stats);
+const char* phaseName(OGTPhase phase);
+void accumulateSortStats(OGTSortStats* sum, const OGTSortStats* stats);
+void scaleSortStats(OGTSortStats* stats, double factor);
+
+// ========== BĂNG THÔNG BỘ NHỚ ==========
+// Đo kiểu STREAM: copy c = a, scale b = s*c, triad a = b + s*c (mảng double)
+typedef enum {
+    OGT_STREAM_COPY = 0,
+    OGT_STREAM_SCALE,
+    OGT_STREAM_TRIAD,
+    OGT_STREAM_COUNT
+} OGTStreamKernel;
+
+typedef struct {
+    int threads;
+    int node;                           // NUMA node được ghim, -1 nếu không ghim
+    double gbps[OGT_STREAM_COUNT];
+} OGTBandwidth;
+
+#define OGT_STREAM_DEFAULT_ELEMENTS (1 << 23)   // 64 MB mỗi mảng
+
+const char* streamKernelName(OGTStreamKernel kernel);
+int numaNodeCount(void);
+int measureBandwidth(int threads, int node, size_t elements, OGTBandwidth* out);
+const OGTBandwidth* peakBandwidth(int multi_threaded);
+void printBandwidthInfo(void);
+// GB/s đạt được của pha và % so với băng thông copy đỉnh (0 nếu pha không có số byte)
+double phaseBandwidth(const OGTSortStats* stats, OGTPhase phase);
+double phasePeakPercent(const OGTSortStats* stats, OGTPhase phase);
+
+// ========== THỐNG KÊ MẪU ĐO ==========
+// Thống kê thời gian của nhiều lần đo, tính trên các mẫu còn lại sau khi loại ngoại lai
+typedef struct {
+    int count;          // số mẫu được giữ lại
+    int outliers;       // số mẫu bị loại (ngoài hàng rào Tukey 1.5 IQR)
+    double mean;
+    double median;
+    double p95;
+    double stddev;      // độ lệch chuẩn mẫu
+    double min;
+    double max;
+    double ci_low;      // khoảng tin cậy 95% của trung bình
+    double ci_high;
+} OGTSampleStats;
+
+double studentT95(double dof);
+void computeSampleStats(const double samples[], int n, OGTSampleStats* out);
+// 1: cur nhanh hơn có ý nghĩa, -1: chậm hơn có ý nghĩa, 0: không đổi
+int compareSampleStats(const OGTSampleStats* base, const OGTSampleStats* cur, double min_effect);
+
+// ========== PHÂN TÍCH MỞ RỘNG ==========
+typedef enum {
+    OGT_SCALING_STRONG = 0,     // n cố định, tăng số worker
+    OGT_SCALING_WEAK            // n mỗi worker cố định
+} OGTScalingMode;
+
+// Một điểm đo so với điểm 1 worker cùng chế độ
+typedef struct {
+    int workers;
+    double time;            // trung vị thời gian (giây)
+    double speedup;         // weak: speedup mở rộng p * T1 / Tp
+    double efficiency;
+    double karp_flatt;      // tỉ lệ tuần tự ước lượng, 0 khi workers = 1
+} OGTScalingPoint;
+
+const char* scalingModeName(OGTScalingMode mode);
+int parseScalingMode(const char* name);
+double karpFlattFraction(double speedup, int workers);
+void computeScalingPoint(OGTScalingMode mode, int workers, double base_time, double time, OGTScalingPoint* point);
+
+// ========== TINH CHỈNH THEO MÁY ==========
+// Hằng số tốc độ đọc từ hồ sơ của máy (ogt_tune ghi); OGT_TUNING=path|off ghi đè đường dẫn
+#define OGT_TUNING_PATH_MAX  512
+#define OGT_TUNING_MAX_RUNS  64     // giới hạn bench_runs
+#define OGT_TUNING_MAX_CHUNKS 64    // khối tối đa mỗi luồng
+
+typedef enum {
+    OGT_MERGE_NATIVE = 0,           // cách trộn sẵn có của backend (OpenMP: tuyến tính, Pthreads: cây)
+    OGT_MERGE_LINEAR,               // k-chiều, quét tuyến tính mọi khối cho mỗi phần tử
+    OGT_MERGE_TREE,                 // trộn cặp đôi theo cây, log2(k) lượt
+    OGT_MERGE_COUNT
+} OGTMergeStrategy;
+
+typedef struct {
+    int seq_cutoff;                 // n nhỏ hơn: sắp xếp chèn tuần tự
+    int chunks_per_thread;          // hệ số chia khối (1: một khối mỗi luồng)
+    int block_size;                 // phần tử tối đa mỗi khối, 0: không giới hạn
+    OGTMergeStrategy merge;         // cách trộn các khối (OpenMP và Pthreads)
+    int max_threads;                // giới hạn số luồng (Pthreads, ogt_sort)
+    int bench_runs;                 // số lần đo mỗi cấu hình của các benchmark giao diện
+} OGTTuning;
+
+const char* mergeStrategyName(OGTMergeStrategy merge);
+int parseMergeStrategy(const char* name);
+void defaultTuning(OGTTuning* tuning);
+
+// Hồ sơ đang dùng, nạp ở lần gọi đầu tiên
+const OGTTuning* ogtTuning(void);
+const char* tuningSource(void);     // đường dẫn hồ sơ đã nạp hoặc "mặc định"
+void setTuning(const OGTTuning* tuning);    // NULL: trở lại mặc định; giá trị ngoài miền bị kẹp
+
+/**
+ * Đường dẫn hồ sơ của máy này
+ * @return 0 nếu có đường dẫn, -1 nếu OGT_TUNING=off hoặc không xác định được thư mục
+ */
+int tuningProfilePath(char* path, size_t size);
+int loadTuningProfile(const char* path, OGTTuning* tuning);
+int saveTuningProfile(const char* path, const OGTTuning* tuning, const char* comment);
+
+// Số khối sắp xếp cho n phần tử với num_threads luồng theo hồ sơ đang dùng
+int tuningChunkCount(int n, int num_threads);
+
 // ========== CÁC HÀM SẮP XẾP TUẦN TỰ ==========
 void insertionSortAsc(int a[], int n);
 void insertionSortDesc(int a[], int n);
+void insertionSortStats(int a[], int n, int ascending, OGTSortStats* stats);
 
 // ========== CÁC HÀM SẮP XẾP SONG SONG ==========
+// Các biến thể *Stats ghi thời gian theo pha vào stats (stats có thể NULL)
+// OpenMP và Pthreads: số khối theo num_threads, số luồng chạy do governor đồng thời cấp
+
 // Triển khai OpenMP
 void parallelInsertionSortAsc(int a[], int n, int num_threads);
 void parallelInsertionSortDesc(int a[], int n, int num_threads);
+void parallelInsertionSortStats(int a[], int n, int num_threads, int ascending, OGTSortStats* stats);
+// Như trên, khối tạm và mảng trộn lấy từ scratch (2 * n phần tử) thay vì cấp phát
+void parallelInsertionSortScratch(int a[], int n, int num_threads, int ascending, int scratch[],
+                                  OGTSortStats* stats);
 
 // Triển khai Pthreads
 void parallelInsertionSortPthreadsAsc(int a[], int n, int num_threads);
 void parallelInsertionSortPthreadsDesc(int a[], int n, int num_threads);
+void parallelInsertionSortPthreadsStats(int a[], int n, int num_threads, int ascending, OGTSortStats* stats);
 
 // Triển khai MPI (luôn khả dụng, nhưng có stub khi MPI bị tắt)
 void parallelInsertionSortMPIAsc(int a[], int n);
 void parallelInsertionSortMPIDesc(int a[], int n);
+void parallelInsertionSortMPIStats(int a[], int n, int ascending, OGTSortStats* stats);
+
+// Các pha của sắp xếp MPI, đo riêng trên từng rank bằng MPI_Wtime
+typedef enum {
+    OGT_MPI_PHASE_SCATTER = 0,  // nhận phân đoạn từ rank 0
+    OGT_MPI_PHASE_LOCAL_SORT,   // sắp xếp phân đoạn cục bộ
+    OGT_MPI_PHASE_GATHER,       // gửi phân đoạn đã sắp xếp về rank 0
+    OGT_MPI_PHASE_MERGE,        // trộn tại rank 0
+    OGT_MPI_PHASE_COUNT
+} OGTMPIPhase;
+
+// Thời gian từng pha gộp trên mọi rank (min/avg/max), rank chậm nhất và tổng số byte của pha
+// root_memory là của rank 0, other_memory lấy max trên các rank còn lại
+typedef struct {
+    int num_ranks;
+    double min_time[OGT_MPI_PHASE_COUNT];
+    double avg_time[OGT_MPI_PHASE_COUNT];
+    double max_time[OGT_MPI_PHASE_COUNT];
+    int max_rank[OGT_MPI_PHASE_COUNT];
+    long long bytes[OGT_MPI_PHASE_COUNT];
+    OGTMemStats root_memory;
+    OGTMemStats other_memory;
+} OGTMPIPhaseStats;
+
+// Hàm tập thể; rank_stats hợp lệ tại rank 0
+void parallelInsertionSortMPIRankStats(int a[], int n, int ascending,
+                                       OGTSortStats* stats, OGTMPIPhaseStats* rank_stats);
+const char* mpiPhaseName(OGTMPIPhase phase);
+double mpiLoadImbalance(const OGTMPIPhaseStats* rank_stats);
+double mpiCommCompRatio(const OGTMPIPhaseStats* rank_stats);
+
+// Bật/tắt nén run đã sắp xếp khi gather về rank 0 (phải gọi giống nhau trên mọi rank)
+void setMPICompression(int enabled);
+int getMPICompression(void);
+
+#ifdef HAVE_MPI
+// Communicator cho sắp xếp MPI, mặc định MPI_COMM_WORLD (MPI_COMM_NULL để khôi phục)
+// Chỉ các rank thuộc comm gọi hàm sắp xếp; dùng cho nghiên cứu mở rộng theo số rank
+void setMPICommunicator(MPI_Comm comm);
+MPI_Comm getMPICommunicator(void);
+#endif
+
+// ========== SẮP XẾP PHÂN ĐOẠN ==========
+/**
+ * Sắp xếp từng đoạn data[offsets[s], offsets[s + 1]) độc lập trong một vùng song song
+ * Đoạn nhỏ hơn ngưỡng tuần tự chia động cho các luồng, đoạn lớn được chia khối giữa các luồng rồi trộn
+ * @param offsets num_segments + 1 phần tử, không giảm
+ * @param num_threads <= 0 để dùng số luồng OpenMP mặc định; số luồng chạy do governor cấp
+ * @return 0 nếu thành công, -1 nếu offset không hợp lệ hoặc thiếu bộ nhớ
+ */
+int segmentedSort(int data[], const long long offsets[], int num_segments, int num_threads,
+                  int ascending, OGTSortStats* stats);
+
+// ========== TRỘN K MẢNG ĐÃ SẮP XẾP ==========
+/**
+ * Trộn k mảng đã sắp xếp inputs[i][0..lengths[i]) vào out song song, ổn định
+ * Phần tử bằng nhau giữ thứ tự đầu vào; đầu ra chia theo hạng nên các luồng nhận việc bằng nhau
+ * @param out Tổng lengths phần tử, không chồng lên đầu vào
+ * @param sources NULL hoặc mảng cỡ out: nhận chỉ số đầu vào của từng phần tử
+ * @param num_threads <= 0 để dùng số luồng OpenMP mặc định; số luồng chạy do governor cấp
+ * @return 0 nếu thành công, -1 nếu đầu vào không hợp lệ hoặc thiếu bộ nhớ
+ */
+int mergeSortedArrays(int* const inputs[], const int lengths[], int k, int out[], int sources[],
+                      int num_threads, int ascending, OGTSortStats* stats);
+
+// ========== CHÈN LÔ VÀO MẢNG ĐÃ SẮP XẾP ==========
+/**
+ * Sắp xếp lô batch[0..m) rồi trộn vào arr[0..n) đã sắp xếp, kết quả arr[0..n + m)
+ * Chi phí theo cỡ lô và phần đuôi từ vị trí chèn của khóa nhỏ nhất, không sắp xếp lại arr
+ * @param arr Sức chứa >= n + m
+ * @param batch Có thể bị sắp xếp tại chỗ; được phép nằm trong đuôi arr (ví dụ batch = arr + n)
+ * @param num_threads 1: tuần tự; <= 0: mặc định; lô từ ngưỡng tuần tự của hồ sơ trở lên trộn song song
+ * @return n + m, hoặc -1 nếu lỗi (arr giữ nguyên)
+ */
+int sortedInsertBatch(int arr[], int n, int batch[], int m, int num_threads, int ascending,
+                      OGTSortStats* stats);
+
+// ========== SẮP XẾP FILE (MMAP) ==========
+// Backend sắp xếp, dùng khi chọn backend lúc chạy
+typedef enum {
+    OGT_BACKEND_SEQ = 0,
+    OGT_BACKEND_OPENMP,
+    OGT_BACKEND_PTHREADS,
+    OGT_BACKEND_MPI,
+    OGT_BACKEND_COUNT
+} OGTBackend;
+
+const char* backendName(OGTBackend backend);
+int parseBackend(const char* name);
+
+// Kiểu khóa trong file nhị phân (little-endian, không header)
+typedef enum {
+    OGT_KEY_INT32 = 0,
+    OGT_KEY_INT64,
+    OGT_KEY_COUNT
+} OGTKeyType;
+
+#define OGT_MMAP_POPULATE   0x1     // đọc trước toàn bộ file khi map (MAP_POPULATE / MADV_WILLNEED)
+#define OGT_MMAP_HUGE_PAGES 0x2     // MADV_HUGEPAGE (chỉ có tác dụng khi kernel hỗ trợ THP cho file)
+
+// Thời gian (giây) của một lần sắp xếp file
+typedef struct {
+    long long n;                // số khóa
+    double map_time;            // open + mmap (+ populate)
+    double copy_time;           // copy đầu vào sang vùng map đầu ra (0 nếu tại chỗ)
+    double sort_time;
+    double sync_time;           // msync + munmap
+    double total_time;
+    OGTSortStats sort_stats;    // thời gian theo pha và bộ nhớ của backend
+} OGTFileSortStats;
+
+const char* keyTypeName(OGTKeyType key);
+int parseKeyType(const char* name);
+size_t keyTypeSize(OGTKeyType key);
+// Đổi giữa thứ tự byte của file (little-endian) và của máy; không làm gì trên máy little-endian
+void swapKeyBytes(void* keys, size_t n, OGTKeyType key);
+// Sắp xếp vùng khóa int32/int64 bằng backend đã chọn (int64 không hỗ trợ mpi); lỗi in nguyên nhân
+int sortKeys(void* keys, long long n, OGTKeyType key, OGTBackend backend,
+             int num_threads, int ascending, OGTSortStats* stats);
+// output NULL để sắp xếp tại chỗ; với mpi là hàm tập thể, chỉ rank 0 mở file
+int sortFile(const char* input, const char* output, OGTKeyType key, OGTBackend backend,
+             int num_threads, int ascending, int flags, OGTFileSortStats* stats);
+int fileIsSorted(const char* path, OGTKeyType key, int ascending);
+
+// ========== SẮP XẾP NGOÀI ==========
+// Cho file lớn hơn RAM: sinh run vừa ngân sách bộ nhớ bằng backend đã chọn, rồi trộn k-chiều
+// từ file tạm với I/O tuần tự, bất đồng bộ và bộ đệm kép
+#define OGT_EXTERNAL_DEFAULT_BUDGET ((size_t)256 * 1024 * 1024)
+
+typedef struct {
+    size_t memory_budget;       // byte cho mọi bộ đệm và vùng tạm, 0 để dùng mặc định
+    const char* temp_dir;       // NULL: $TMPDIR hoặc /tmp
+    OGTBackend backend;         // backend sinh run (mpi: hàm tập thể, chỉ rank 0 làm I/O)
+    int num_threads;
+    int ascending;
+    OGTKeyType key;
+} OGTExternalSortOptions;
+
+typedef struct {
+    long long n;
+    int runs;
+    int fanin;                  // số run trộn cùng lúc
+    int merge_passes;
+    size_t run_bytes;
+    size_t merge_buffer_bytes;  // mỗi bộ đệm của một run khi trộn
+    double run_time;            // sinh run (đọc + sắp xếp + ghi)
+    double merge_time;
+    double total_time;
+    double io_wait_time;        // thời gian chờ I/O không che được bằng tính toán
+    long long bytes_read;
+    long long bytes_written;
+    OGTSortStats sort_stats;    // cộng dồn trên các run
+    OGTMemStats memory;         // toàn bộ lần sắp xếp (đỉnh byte sống <= ngân sách)
+} OGTExternalSortStats;
+
+void defaultExternalSortOptions(OGTExternalSortOptions* opts);
+int externalSortFile(const char* input, const char* output, const OGTExternalSortOptions* opts,
+                     OGTExternalSortStats* stats);
+
+// ========== FILE VĂN BẢN ==========
+// Mỗi dòng một số nguyên thập phân; parse và định dạng song song trên vùng mmap
+typedef struct {
+    long long n;
+    long long bytes_read;
+    long long bytes_written;
+    double parse_time;          // map + đếm dòng + parse
+    double sort_time;
+    double format_time;         // định dạng + ghi
+    double total_time;
+    OGTSortStats sort_stats;
+    OGTMemStats memory;         // toàn bộ lần sắp xếp, gồm mảng khóa
+} OGTTextSortStats;
+
+/**
+ * Đọc file văn bản vào mảng khóa mới (giải phóng bằng ogtFree)
+ * @param num_threads Số luồng parse, 0 để dùng mọi lõi
+ * @return 0 nếu thành công, -1 nếu lỗi (file không mở được, dòng không phải số hợp lệ)
+ */
+int readTextKeys(const char* path, OGTKeyType key, int num_threads, void** keys, long long* n);
+int writeTextKeys(const char* path, const void* keys, long long n, OGTKeyType key, int num_threads);
+
+/**
+ * Parse một khối văn bản trong bộ nhớ (một luồng), keys phải chứa được bytes / 2 + 1 khóa
+ * @param error_offset Vị trí đầu dòng lỗi (có thể NULL)
+ * @return Số khóa, -1 nếu có dòng không hợp lệ
+ */
+long long parseTextKeys(const char* text, size_t bytes, OGTKeyType key, void* keys, size_t* error_offset);
+
+/**
+ * Sắp xếp file văn bản: parse song song, sortKeys, định dạng song song
+ * @param output File đầu ra, NULL để ghi đè đầu vào
+ * Với mpi: hàm tập thể, chỉ rank 0 đọc và ghi file
+ */
+int sortTextFile(const char* input, const char* output, OGTKeyType key, OGTBackend backend,
+                 int num_threads, int ascending, OGTTextSortStats* stats);
+int textFileIsSorted(const char* path, OGTKeyType key, int ascending);
+
+// ========== SẮP XẾP DẠNG LUỒNG ==========
+// Sắp xếp trong lúc dữ liệu còn đang đến: worker nền sắp xếp từng run ngay khi đầy
+// và trộn dần các run cùng cỡ; finish chỉ trộn vài run còn lại
+#define OGT_STREAM_DEFAULT_RUN 4096     // phần tử mỗi run (kernel chèn: O(run^2))
+
+typedef struct OGTStreamSort OGTStreamSort;
+
+typedef struct {
+    long long n;
+    int runs;                   // run worker đã sắp xếp
+    int merges;                 // lần trộn nền
+    int final_runs;             // run còn lại khi finish
+    double ingest_time;         // từ create tới lúc gọi finish
+    double finish_time;         // đợi worker + trộn cuối
+    double worker_time;         // tổng thời gian bận của các worker
+    double total_time;
+    OGTMemStats memory;
+} OGTStreamSortStats;
+
+/**
+ * Tạo stream sort với tối đa num_workers worker nền (governor cấp, giữ tới streamSortDestroy)
+ * @param run_size Phần tử mỗi run, <= 0 để dùng OGT_STREAM_DEFAULT_RUN
+ * @return NULL nếu lỗi
+ */
+OGTStreamSort* streamSortCreate(int num_workers, int run_size, int ascending);
+
+/**
+ * Đẩy một lô vào stream (dữ liệu được chép); chỉ một luồng đẩy
+ * Mỗi run đầy được giao ngay cho worker; phần lẻ gom với lô sau hoặc chờ finish
+ */
+int streamSortPush(OGTStreamSort* s, const int* batch, int n);
+
+/**
+ * Đọc tới hết fd (pipe, stdin, file) và đẩy theo từng khối
+ * @param text 1: mỗi dòng một số int32, 0: int32 little-endian nhị phân
+ */
+int streamSortReadFd(OGTStreamSort* s, int fd, int text);
+
+/**
+ * Kết thúc stream: đợi worker, trộn các run còn lại
+ * @param result Mảng kết quả mới (giải phóng bằng ogtFree), NULL nếu rỗng
+ * Sau finish chỉ còn gọi được streamSortDestroy
+ */
+int streamSortFinish(OGTStreamSort* s, int** result, int* n, OGTStreamSortStats* stats);
+void streamSortDestroy(OGTStreamSort* s);
+
+// ========== SẮP XẾP ĐỘ TRỄ THẤP ==========
+// Cho nhiều lần sắp xếp mảng nhỏ liên tiếp (1K-50K phần tử): worker thường trực quay chờ việc
+// thay vì fork/join mỗi lần; dưới ngưỡng hòa vốn đo trên máy thì chạy tuần tự
+#define OGT_LATENCY_DEFAULT_SPIN_US 100     // worker quay chờ sau mỗi việc trước khi ngủ
+
+typedef struct OGTLatencyPool OGTLatencyPool;
+
+/**
+ * Tạo nhóm worker thường trực
+ * @param workers Số luồng tham gia kể cả luồng gọi, <= 0 để dùng số lõi
+ * @param break_even n nhỏ nhất chạy song song, <= 0 để đo trên máy khi tạo
+ * @param spin_us Thời gian quay chờ trước khi ngủ, < 0 để dùng OGT_LATENCY_DEFAULT_SPIN_US
+ * @return NULL nếu lỗi
+ */
+OGTLatencyPool* latencyPoolCreate(int workers, int break_even, int spin_us);
+
+/**
+ * Sắp xếp a bằng nhóm worker; không cấp phát khi n không vượt cỡ lớn nhất đã gặp
+ * Gọi đồng thời được: khi nhóm đang bận, lần gọi sau sắp xếp tuần tự thay vì chờ
+ * @return Số luồng đã tham gia (1: tuần tự), -1 nếu lỗi
+ */
+int latencySort(OGTLatencyPool* pool, int a[], int n, int ascending);
+int latencyPoolBreakEven(const OGTLatencyPool* pool);   // INT_MAX: không bao giờ song song
+int latencyPoolWorkers(const OGTLatencyPool* pool);
+void latencyPoolDestroy(OGTLatencyPool* pool);
+
+// ========== SẮP XẾP TỰ ĐỘNG ==========
+// ogt_sort chọn thuật toán (chèn tuần tự hoặc chia khối + trộn), backend và số worker
+// theo mô hình chi phí đo trên máy và độ lộn xộn lấy mẫu từ chính mảng đầu vào
+#define OGT_BACKEND_AUTO (-1)
+
+typedef enum {
+    OGT_OBJECTIVE_LATENCY = 0,  // thời gian nhỏ nhất
+    OGT_OBJECTIVE_THROUGHPUT    // lõi * giây nhỏ nhất (nhiều lần sắp xếp chạy cùng lúc)
+} OGTObjective;
+
+// Hằng số của mô hình chi phí
+typedef struct {
+    double insertion_ns;        // mỗi nghịch thế của sắp xếp chèn
+    double scan_ns;             // mỗi phần tử sắp xếp chèn đi qua
+    double copy_ns;             // mỗi phần tử copy
+    double kway_ns;             // mỗi phần tử mỗi khối, trộn k-chiều tuyến tính (openmp)
+    double merge_ns;            // mỗi phần tử mỗi lượt trộn cặp đôi (pthreads)
+    double spawn_us;            // tạo + join một pthread
+    double fork_us;             // một vùng song song OpenMP
+    int cores;
+} OGTCostModel;
+
+typedef struct {
+    OGTObjective objective;
+    int ascending;
+    int max_threads;            // 0: tới 4 x số lõi (tối đa 32)
+    int backend;                // OGT_BACKEND_AUTO hoặc ép một OGTBackend (mpi: mọi rank cùng gọi)
+    const OGTCostModel* model;  // NULL: mô hình đo trên máy này
+    OGTSortStats* stats;        // có thể NULL
+} OGTSortOptions;
+
+typedef struct {
+    OGTBackend backend;
+    int threads;
+    double inversion_ratio;     // tỉ lệ cặp ngược thứ tự ước lượng trong một khối
+    double predicted_time;      // giây; 0 khi chỉ có một ứng viên (không lấy mẫu)
+    double predicted_cost;      // lõi * giây
+} OGTSortPlan;
+
+void ogt_sort_default_options(OGTSortOptions* opts);
+const char* objectiveName(OGTObjective objective);
+int parseObjective(const char* name);
+
+/**
+ * Đo các hằng số của mô hình trên máy này (vài chục ms)
+ * @return 0 nếu thành công, -1 nếu thiếu bộ nhớ
+ */
+int ogt_calibrate(OGTCostModel* model);
+
+// Mô hình của máy, đo một lần ở lần gọi đầu tiên
+const OGTCostModel* ogt_host_model(void);
+
+/**
+ * Chọn backend và số worker cho a[0..n) mà không sắp xếp
+ * @param opts NULL để dùng mặc định
+ */
+int ogt_sort_plan(const int a[], int n, const OGTSortOptions* opts, OGTSortPlan* plan);
+
+/**
+ * Sắp xếp a[0..n) bằng kế hoạch của ogt_sort_plan, dưới governor đồng thời (trừ mpi)
+ * @return 0 nếu thành công, -1 nếu tùy chọn không hợp lệ
+ */
+int ogt_sort(int a[], int n, const OGTSortOptions* opts);
+
+// ========== CONTEXT VÀ GOVERNOR ĐỒNG THỜI ==========
+// Governor toàn tiến trình chia số lõi cho các lần sắp xếp đồng thời: các kernel song song (OpenMP,
+// Pthreads, latencySort, stream sort, sắp xếp file, segmentedSort, mergeSortedArrays) xin luồng khi
+// bắt đầu và trả khi xong. Tổng số luồng được cấp không vượt giới hạn, lần sắp xếp đến khi đã hết chỗ chạy trên luồng gọi.
+// Không áp dụng cho backend mpi và các tiện ích không sắp xếp (sinh dữ liệu, đọc văn bản, băng thông)
+void setConcurrencyLimit(int threads);      // <= 0: số lõi (mặc định)
+int concurrencyLimit(void);
+
+/**
+ * Xin luồng cho một lần sắp xếp, không bao giờ chặn
+ * @return Số luồng được cấp (>= 1), tối đa wanted và phần chia đều giữa các lần sắp xếp đang chạy
+ */
+int governorAcquire(int wanted);
+void governorRelease(int granted);
+int governorInUse(void);
+
+// Context mang ngân sách luồng (opts.max_threads), tùy chọn và vùng tạm dùng lại giữa các lần gọi;
+// chỉ đọc sau khi tạo nên dùng chung được giữa nhiều luồng
+typedef struct ogt_context ogt_context;
+
+/**
+ * @param opts NULL để dùng mặc định; opts->stats bị bỏ qua, backend mpi không hợp lệ.
+ *             opts->model (nếu có) phải sống lâu hơn context
+ * @return NULL nếu lỗi
+ */
+ogt_context* ogt_context_create(const OGTSortOptions* opts);
+void ogt_context_destroy(ogt_context* ctx);
+
+/**
+ * Sắp xếp a[0..n) theo kế hoạch của tùy chọn context, dưới governor
+ * @param stats Thống kê của lời gọi này, có thể NULL
+ * @return 0 nếu thành công, -1 nếu lỗi
+ */
+int ogt_context_sort(ogt_context* ctx, int a[], int n, OGTSortStats* stats);
+
+/**
+ * Thực thi một kế hoạch bằng kernel của plan->backend: số khối theo plan->threads, số luồng theo governor
+ * @param ctx Nguồn vùng tạm (backend openmp), NULL để kernel tự cấp phát
+ */
+int ogt_sort_with_plan(ogt_context* ctx, int a[], int n, const OGTSortPlan* plan, int ascending,
+                       OGTSortStats* stats);
+
+// ========== SẮP XẾP BẤT ĐỒNG BỘ ==========
+// ogt_sort chạy trên worker nền của thư viện; người gọi tiếp tục việc khác rồi wait/test handle
+typedef struct ogt_sort_handle ogt_sort_handle;
+
+// Gọi trên worker nền khi sắp xếp xong, trước khi ogt_sort_wait trả về; không được wait chính handle đó
+typedef void (*ogt_sort_callback)(int* a, int n, int status, void* user_data);
+
+/**
+ * Đưa a[0..n) vào hàng đợi sắp xếp nền và trả về ngay
+ * a (và opts->stats, opts->model nếu có) phải còn sống tới khi xong; opts được chép
+ * @param opts NULL để dùng mặc định; backend mpi không hợp lệ
+ * @param callback Có thể NULL
+ * @return Handle, giải phóng bằng ogt_sort_release; NULL nếu lỗi
+ */
+ogt_sort_handle* ogt_sort_async(int a[], int n, const OGTSortOptions* opts,
+                                ogt_sort_callback callback, void* user_data);
+int ogt_sort_test(ogt_sort_handle* handle);     // 1 nếu đã xong (kể cả callback), không chặn
+int ogt_sort_wait(ogt_sort_handle* handle);     // chặn tới khi xong, trả về kết quả của ogt_sort
+
+// Buông handle; gọi được trước khi xong (việc vẫn chạy, callback vẫn được gọi)
+void ogt_sort_release(ogt_sort_handle* handle);
+
+// Chạy hết hàng đợi rồi dừng worker nền; không gọi đồng thời với ogt_sort_async
+void ogt_async_shutdown(void);
+
+// ========== CÁC KERNEL TRỘN ==========
+// Dùng nội bộ bởi các triển khai song song, công khai để đo riêng trong bench_kernels
+void merge_openmp_chunks(int* chunks[], const int chunk_sizes[], int num_chunks, int result[], int n, int ascending);
+void merge_two_arrays(int arr[], int left, int mid, int right, int ascending);
+void merge_two_arrays_mpi(int arr[], int left, int mid, int right, int ascending);
+void merge_mpi_chunks(int arr[], int* chunk_sizes, int num_procs, int total_size, int ascending);
+void merge_tree_chunks(int* chunks[], const int chunk_sizes[], int num_chunks, int result[], int n, int ascending);
+// Trộn cây các run liền kề arr[bounds[r], bounds[r + 1]) qua scratch[n], kết quả về arr; bounds bị ghi đè
+void merge_adjacent_runs(int arr[], int scratch[], int bounds[], int num_runs, int n, int ascending);
+// Số phần tử của a[0..n) đã sắp xếp đứng trước hoặc bằng x (vị trí chèn sau các khóa bằng x)
+int sortedCountUpTo(const int a[], int n, int x, int ascending);
+
+// ========== CODEC NÉN RUN ĐÃ SẮP XẾP ==========
+#define OGT_CODEC_BLOCK 128
+
+// Bộ giải nén tuần tự, đọc từng phần tử từ dạng nén
+typedef struct {
+    const unsigned char* src;
+    int remaining;
+    int ascending;
+    int first;
+    int last;
+    int block_len;
+    int block_pos;
+    int block[OGT_CODEC_BLOCK];
+} DeltaDecoder;
+
+size_t deltaCodecMaxBytes(int n);
+size_t deltaCodecEncode(const int src[], int n, int ascending, unsigned char* out);
+void deltaDecoderInit(DeltaDecoder* d, const unsigned char* buf, int n, int ascending);
+int deltaDecoderNext(DeltaDecoder* d, int* out);
 
 // ========== CÁC HÀM TIỆN ÍCH ==========
 double getCurrentTime(void);
+unsigned long long getTimestampCounter(void);
+double getTimestampCounterHz(void);
 void copyArray(int src[], int dest[], int n);
 void generateRandomArray(int arr[], int n, int max_val);
 
+// Sinh số ngẫu nhiên tái lập được (Philox4x32-10, song song, không lệch modulo)
+void setRandomSeed(unsigned long long seed);
+unsigned long long getRandomSeed(void);
+long long reserveRandomStream(int n);
+void generateRandomRange(int arr[], long long first_index, int count, int max_val, unsigned long long seed);
+void generateRandomArraySeeded(int arr[], int n, int max_val, unsigned long long seed);
+// Hàm tập thể: mỗi rank sinh phân đoạn của mình rồi gather về rank 0
+void generateRandomArrayMPI(int a[], int n, int max_val);
+
+// Các phân phối dữ liệu đầu vào cho benchmark
+typedef enum {
+    OGT_DIST_UNIFORM = 0,       // ngẫu nhiên đều
+    OGT_DIST_SORTED,            // đã sắp xếp tăng dần
+    OGT_DIST_REVERSE,           // sắp xếp ngược
+    OGT_DIST_NEARLY_SORTED,     // đã sắp xếp, K cặp bị hoán đổi (mặc định n/100)
+    OGT_DIST_FEW_UNIQUE,        // chỉ 8 giá trị khác nhau
+    OGT_DIST_ZIPF,              // Zipf s = 1
+    OGT_DIST_ORGAN_PIPE,        // tăng rồi giảm
+    OGT_DIST_SAWTOOTH,          // 16 răng cưa tăng dần
+    OGT_DIST_ALL_EQUAL,         // mọi phần tử bằng nhau
+    OGT_DIST_SORTED_RUNS,       // 16 dãy tăng dần nối tiếp
+    OGT_DIST_COUNT
+} OGTDistribution;
+
+#define OGT_DIST_DEFAULT_PARAM (-1)   // tham số mặc định của phân phối (nearly-sorted: n/100 cặp)
+
+const char* distributionName(OGTDistribution dist);
+int parseDistribution(const char* name);
+// "tên[:K]", K chỉ cho nearly-sorted; param nhận K hoặc OGT_DIST_DEFAULT_PARAM. -1 nếu không hợp lệ
+int parseDistributionSpec(const char* spec, int* param);
+// Tên kèm ":K" khi có tham số, ghi vào buf
+const char* distributionSpec(OGTDistribution dist, int param, char* buf, size_t size);
+void generateDistributionArray(int arr[], int n, int max_val, OGTDistribution dist, unsigned long long seed);
+void generateDistributionArrayParam(int arr[], int n, int max_val, OGTDistribution dist, int param,
+                                    unsigned long long seed);
+
 // ========== CÁC HÀM BENCHMARK ==========
 void printBenchmarkResults(const char* sort_type, int array_size, int threads, double avg_time, double speedup);
+void printSortStats(const char* label, const OGTSortStats* stats);
 void runSingleBenchmark(int array_size);
 void runDetailedBenchmarkAnalysis(void);
 void demonstrateSortingCorrectness(void);
@@ -0,0 +1,174 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <pthread.h>
+
+/**
+ * Sắp xếp bất đồng bộ
+ *
+ * ogt_sort_async đưa việc vào hàng đợi FIFO của một nhóm worker pthread của thư viện (khởi
+ * động ở lần gọi đầu tiên, concurrencyLimit() worker) rồi trả về ngay. Mỗi worker chạy
+ * ogt_sort, nên các lần sắp xếp nền vẫn chịu governor đồng thời như lần gọi đồng bộ.
+ *
+ * Handle được đếm tham chiếu giữa người gọi và worker: ogt_sort_release trước khi xong là
+ * hợp lệ (kiểu "gửi rồi quên" với callback), handle được giải phóng khi cả hai đã buông.
+ */
+
+struct ogt_sort_handle {
+    int* a;
+    int n;
+    OGTSortOptions opts;
+    ogt_sort_callback callback;
+    void* user_data;
+    int status;
+    int done;                   // đọc bằng __atomic cho ogt_sort_test
+    int refs;                   // người gọi + worker, dưới executor.lock
+    struct ogt_sort_handle* next;
+};
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    pthread_t* threads;
+    int num_threads;
+    int stopping;
+    ogt_sort_handle* head;
+    ogt_sort_handle* tail;
+} executor = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+               NULL, 0, 0, NULL, NULL };
+
+// Buông một tham chiếu; gọi khi giữ executor.lock
+static void dropHandle(ogt_sort_handle* handle) {
+    if (--handle->refs == 0) ogtFree(handle);
+}
+
+static void* asyncWorker(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&executor.lock);
+    for (;;) {
+        while (!executor.head && !executor.stopping) {
+            pthread_cond_wait(&executor.work_ready, &executor.lock);
+        }
+        // Khi dừng, các việc còn trong hàng đợi vẫn được chạy hết
+        if (!executor.head) break;
+
+        ogt_sort_handle* handle = executor.head;
+        executor.head = handle->next;
+        if (!executor.head) executor.tail = NULL;
+        pthread_mutex_unlock(&executor.lock);
+
+        unsigned long long trace_sort = traceNow();
+        handle->status = ogt_sort(handle->a, handle->n, &handle->opts);
+        traceSpan("async-sort", trace_sort, handle->n);
+        // callback chạy trước khi handle xong: ogt_sort_wait trả về sau callback
+        if (handle->callback) handle->callback(handle->a, handle->n, handle->status, handle->user_data);
+
+        pthread_mutex_lock(&executor.lock);
+        __atomic_store_n(&handle->done, 1, __ATOMIC_RELEASE);
+        pthread_cond_broadcast(&executor.work_done);
+        dropHandle(handle);
+    }
+    pthread_mutex_unlock(&executor.lock);
+    return NULL;
+}
+
+// Khởi động worker nếu chưa có; gọi khi giữ executor.lock
+static int startExecutor(void) {
+    if (executor.num_threads > 0) return 0;
+    int workers = concurrencyLimit();
+    executor.threads = (pthread_t*)ogtMalloc(workers * sizeof(pthread_t));
+    if (!executor.threads) return -1;
+    executor.stopping = 0;
+    for (; executor.num_threads < workers; executor.num_threads++) {
+        if (pthread_create(&executor.threads[executor.num_threads], NULL, asyncWorker, NULL) != 0) break;
+    }
+    if (executor.num_threads == 0) {
+        ogtFree(executor.threads);
+        executor.threads = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+ogt_sort_handle* ogt_sort_async(int a[], int n, const OGTSortOptions* opts,
+                                ogt_sort_callback callback, void* user_data) {
+    if (opts && opts->backend == OGT_BACKEND_MPI) {
+        printf(RED "Lỗi: Backend mpi là hàm tập thể, không chạy bất đồng bộ\n" RESET);
+        return NULL;
+    }
+
+    ogt_sort_handle* handle = (ogt_sort_handle*)ogtCalloc(1, sizeof(ogt_sort_handle));
+    if (!handle) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho handle sắp xếp\n" RESET);
+        return NULL;
+    }
+    handle->a = a;
+    handle->n = n;
+    if (opts) {
+        handle->opts = *opts;
+    } else {
+        ogt_sort_default_options(&handle->opts);
+    }
+    handle->callback = callback;
+    handle->user_data = user_data;
+    handle->refs = 2;
+
+    pthread_mutex_lock(&executor.lock);
+    if (startExecutor() != 0) {
+        pthread_mutex_unlock(&executor.lock);
+        printf(RED "Lỗi: Không tạo được worker sắp xếp bất đồng bộ\n" RESET);
+        ogtFree(handle);
+        return NULL;
+    }
+    if (executor.tail) {
+        executor.tail->next = handle;
+    } else {
+        executor.head = handle;
+    }
+    executor.tail = handle;
+    pthread_cond_signal(&executor.work_ready);
+    pthread_mutex_unlock(&executor.lock);
+    return handle;
+}
+
+int ogt_sort_test(ogt_sort_handle* handle) {
+    return __atomic_load_n(&handle->done, __ATOMIC_ACQUIRE);
+}
+
+int ogt_sort_wait(ogt_sort_handle* handle) {
+    if (!ogt_sort_test(handle)) {
+        pthread_mutex_lock(&executor.lock);
+        while (!handle->done) pthread_cond_wait(&executor.work_done, &executor.lock);
+        pthread_mutex_unlock(&executor.lock);
+    }
+    return handle->status;
+}
+
+void ogt_sort_release(ogt_sort_handle* handle) {
+    if (!handle) return;
+    pthread_mutex_lock(&executor.lock);
+    dropHandle(handle);
+    pthread_mutex_unlock(&executor.lock);
+}
+
+void ogt_async_shutdown(void) {
+    pthread_mutex_lock(&executor.lock);
+    if (executor.num_threads == 0) {
+        pthread_mutex_unlock(&executor.lock);
+        return;
+    }
+    executor.stopping = 1;
+    pthread_cond_broadcast(&executor.work_ready);
+    pthread_mutex_unlock(&executor.lock);
+
+    for (int i = 0; i < executor.num_threads; i++) {
+        pthread_join(executor.threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&executor.lock);
+    ogtFree(executor.threads);
+    executor.threads = NULL;
+    executor.num_threads = 0;
+    executor.stopping = 0;
+    pthread_mutex_unlock(&executor.lock);
+}
@@ -0,0 +1,272 @@
+#ifdef __linux__
+#define _GNU_SOURCE     // sched_setaffinity, cpu_set_t
+#endif
+
+#include "sort_ogt.h"
+#include <string.h>
+#include <omp.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+/**
+ * Đo băng thông bộ nhớ kiểu STREAM (copy, scale, triad)
+ *
+ * Mỗi kernel chạy OGT_STREAM_REPEATS lần, lấy lần nhanh nhất như STREAM.
+ * Số byte tính theo quy ước STREAM: copy/scale 16 byte, triad 24 byte mỗi phần tử
+ * (không tính write-allocate). Dữ liệu được khởi tạo song song cùng lịch static
+ * để mỗi luồng chạm trang của mình trước (first-touch), nên khi ghim luồng vào
+ * một NUMA node thì bộ nhớ cũng nằm trên node đó.
+ */
+
+#define OGT_STREAM_REPEATS 5
+#define OGT_STREAM_SCALAR 3.0
+
+const char* streamKernelName(OGTStreamKernel kernel) {
+    static const char* names[OGT_STREAM_COUNT] = { "copy", "scale", "triad" };
+    if (kernel < 0 || kernel >= OGT_STREAM_COUNT) return "?";
+    return names[kernel];
+}
+
+#ifdef __linux__
+
+int numaNodeCount(void) {
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (!dir) return 1;
+
+    int count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        int node;
+        if (sscanf(entry->d_name, "node%d", &node) == 1) count++;
+    }
+    closedir(dir);
+    return count > 0 ? count : 1;
+}
+
+// Đọc danh sách CPU của node (vd "0-3,8-11"), trả về số CPU
+static int numaNodeCpus(int node, cpu_set_t* set) {
+    char path[64];
+    char list[1024];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+    if (!fgets(list, sizeof(list), file)) list[0] = '\0';
+    fclose(file);
+
+    CPU_ZERO(set);
+    char* cursor = list;
+    while (*cursor && *cursor != '\n') {
+        char* end;
+        long first = strtol(cursor, &end, 10);
+        long last = first;
+        if (end == cursor) break;
+        if (*end == '-') {
+            cursor = end + 1;
+            last = strtol(cursor, &end, 10);
+        }
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) CPU_SET((int)cpu, set);
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return CPU_COUNT(set);
+}
+
+#else // không phải Linux: coi như một node, không ghim luồng
+
+int numaNodeCount(void) {
+    return 1;
+}
+
+#endif // __linux__
+
+static double runStreamKernel(OGTStreamKernel kernel, double* a, double* b, double* c, long n, int threads) {
+    double start = getCurrentTime();
+    switch (kernel) {
+        case OGT_STREAM_COPY:
+            #pragma omp parallel for num_threads(threads) schedule(static)
+            for (long i = 0; i < n; i++) c[i] = a[i];
+            break;
+        case OGT_STREAM_SCALE:
+            #pragma omp parallel for num_threads(threads) schedule(static)
+            for (long i = 0; i < n; i++) b[i] = OGT_STREAM_SCALAR * c[i];
+            break;
+        case OGT_STREAM_TRIAD:
+        default:
+            #pragma omp parallel for num_threads(threads) schedule(static)
+            for (long i = 0; i < n; i++) a[i] = b[i] + OGT_STREAM_SCALAR * c[i];
+            break;
+    }
+    return getCurrentTime() - start;
+}
+
+/**
+ * Đo băng thông copy/scale/triad
+ * @param threads: Số luồng OpenMP, <= 0 để dùng mọi CPU của node (hoặc của máy)
+ * @param node: NUMA node để ghim luồng (và bộ nhớ qua first-touch), -1 nếu không ghim
+ * @param elements: Số phần tử double mỗi mảng (nên >= 4 lần LLC / 8)
+ * @param out: Kết quả GB/s (10^9 byte/giây)
+ * @return 0 nếu thành công, -1 nếu không cấp phát được hoặc node không hợp lệ
+ */
+int measureBandwidth(int threads, int node, size_t elements, OGTBandwidth* out) {
+    memset(out, 0, sizeof(*out));
+
+#ifdef __linux__
+    cpu_set_t node_set;
+    int node_cpus = 0;
+    if (node >= 0 && (node_cpus = numaNodeCpus(node, &node_set)) == 0) return -1;
+    if (threads <= 0) threads = node >= 0 ? node_cpus : omp_get_num_procs();
+#else
+    if (node > 0) return -1;
+    node = -1;
+    if (threads <= 0) threads = omp_get_num_procs();
+#endif
+    out->threads = threads;
+    out->node = node;
+
+    long n = (long)elements;
+    double* a = (double*)malloc(elements * sizeof(double));
+    double* b = (double*)malloc(elements * sizeof(double));
+    double* c = (double*)malloc(elements * sizeof(double));
+    if (!a || !b || !c) {
+        free(a);
+        free(b);
+        free(c);
+        return -1;
+    }
+
+#ifdef __linux__
+    // Ghim từng luồng của team vào node, lưu affinity cũ để khôi phục
+    cpu_set_t* saved_sets = NULL;
+    if (node >= 0) {
+        saved_sets = (cpu_set_t*)malloc(threads * sizeof(cpu_set_t));
+        #pragma omp parallel num_threads(threads)
+        {
+            int tid = omp_get_thread_num();
+            sched_getaffinity(0, sizeof(cpu_set_t), &saved_sets[tid]);
+            sched_setaffinity(0, sizeof(cpu_set_t), &node_set);
+        }
+    }
+#endif
+
+    // Khởi tạo cùng lịch static với các kernel (first-touch)
+    #pragma omp parallel for num_threads(threads) schedule(static)
+    for (long i = 0; i < n; i++) {
+        a[i] = 1.0;
+        b[i] = 2.0;
+        c[i] = 0.0;
+    }
+
+    static const double bytes_per_element[OGT_STREAM_COUNT] = { 16.0, 16.0, 24.0 };
+    double best[OGT_STREAM_COUNT];
+    for (int k = 0; k < OGT_STREAM_COUNT; k++) best[k] = -1.0;
+
+    for (int r = 0; r < OGT_STREAM_REPEATS; r++) {
+        for (int k = 0; k < OGT_STREAM_COUNT; k++) {
+            double t = runStreamKernel((OGTStreamKernel)k, a, b, c, n, threads);
+            if (best[k] < 0.0 || t < best[k]) best[k] = t;
+        }
+    }
+
+    for (int k = 0; k < OGT_STREAM_COUNT; k++) {
+        out->gbps[k] = best[k] > 0.0 ? bytes_per_element[k] * n / best[k] / 1e9 : 0.0;
+    }
+
+#ifdef __linux__
+    if (saved_sets) {
+        #pragma omp parallel num_threads(threads)
+        {
+            int tid = omp_get_thread_num();
+            sched_setaffinity(0, sizeof(cpu_set_t), &saved_sets[tid]);
+        }
+        free(saved_sets);
+    }
+#endif
+
+    free(a);
+    free(b);
+    free(c);
+    return 0;
+}
+
+/**
+ * Băng thông đỉnh (đo một lần, lưu lại cho các lần gọi sau)
+ * @param multi_threaded: 1 cho mọi luồng OpenMP, 0 cho một luồng
+ * @return Kết quả đo, NULL nếu đo thất bại
+ */
+const OGTBandwidth* peakBandwidth(int multi_threaded) {
+    static OGTBandwidth peaks[2];
+    static int measured[2] = {0, 0};
+    static int failed[2] = {0, 0};
+
+    int index = multi_threaded ? 1 : 0;
+    if (!measured[index] && !failed[index]) {
+        if (measureBandwidth(multi_threaded ? 0 : 1, -1, OGT_STREAM_DEFAULT_ELEMENTS, &peaks[index]) == 0) {
+            measured[index] = 1;
+        } else {
+            failed[index] = 1;
+        }
+    }
+    return measured[index] ? &peaks[index] : NULL;
+}
+
+// Băng thông đạt được của một pha (GB/s), 0 nếu pha không có số byte
+double phaseBandwidth(const OGTSortStats* stats, OGTPhase phase) {
+    if (phase < 0 || phase >= OGT_PHASE_COUNT) return 0.0;
+    if (stats->phase_bytes[phase] <= 0.0 || stats->phase_time[phase] <= 0.0) return 0.0;
+    return stats->phase_bytes[phase] / stats->phase_time[phase] / 1e9;
+}
+
+/**
+ * Băng thông của pha so với copy đỉnh (%)
+ * Pha copy chạy song song trên mọi luồng nên so với đỉnh nhiều luồng,
+ * merge/copy-back chạy trên một luồng nên so với đỉnh một luồng
+ */
+double phasePeakPercent(const OGTSortStats* stats, OGTPhase phase) {
+    double achieved = phaseBandwidth(stats, phase);
+    if (achieved <= 0.0) return 0.0;
+
+    int parallel = phase == OGT_PHASE_COPY && stats->num_threads > 1;
+    const OGTBandwidth* peak = peakBandwidth(parallel);
+    if (!peak || peak->gbps[OGT_STREAM_COPY] <= 0.0) return 0.0;
+    return 100.0 * achieved / peak->gbps[OGT_STREAM_COPY];
+}
+
+// In bảng băng thông một luồng, mọi luồng và từng NUMA node
+void printBandwidthInfo(void) {
+    printf("Băng thông bộ nhớ (STREAM, GB/s, %d MB mỗi mảng):\n",
+           (int)(OGT_STREAM_DEFAULT_ELEMENTS * sizeof(double) / (1024 * 1024)));
+    printf("%-16s | %-7s | %-9s | %-9s | %-9s\n", "Cấu Hình", "Luồng", "copy", "scale", "triad");
+    printf("----------------------------------------------------------------\n");
+
+    const OGTBandwidth* single = peakBandwidth(0);
+    const OGTBandwidth* multi = peakBandwidth(1);
+    if (single) {
+        printf("%-16s | %-7d | %-9.2f | %-9.2f | %-9.2f\n", "1 luồng", single->threads,
+               single->gbps[OGT_STREAM_COPY], single->gbps[OGT_STREAM_SCALE], single->gbps[OGT_STREAM_TRIAD]);
+    }
+    if (multi) {
+        printf("%-16s | %-7d | %-9.2f | %-9.2f | %-9.2f\n", "Mọi luồng", multi->threads,
+               multi->gbps[OGT_STREAM_COPY], multi->gbps[OGT_STREAM_SCALE], multi->gbps[OGT_STREAM_TRIAD]);
+    }
+
+    // Mỗi node đo riêng khi máy có nhiều node
+    int nodes = numaNodeCount();
+    if (nodes > 1) {
+        for (int node = 0; node < nodes; node++) {
+            OGTBandwidth result;
+            char label[32];
+            snprintf(label, sizeof(label), "NUMA node %d", node);
+            if (measureBandwidth(0, node, OGT_STREAM_DEFAULT_ELEMENTS, &result) != 0) {
+                printf("%-16s | %-7s | không đo được\n", label, "-");
+                continue;
+            }
+            printf("%-16s | %-7d | %-9.2f | %-9.2f | %-9.2f\n", label, result.threads,
+                   result.gbps[OGT_STREAM_COPY], result.gbps[OGT_STREAM_SCALE], result.gbps[OGT_STREAM_TRIAD]);
+        }
+    } else {
+        printf("(1 NUMA node)\n");
+    }
+}
@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sort_ogt.h"
+
+/**
+ * bench_kernels - microbenchmark từng kernel của thư viện
+ *
+ * Mỗi (kernel, kích thước) được chạy lặp lại tới khi đủ BENCH_MIN_SAMPLES mẫu
+ * và BENCH_MIN_TIME giây; dữ liệu đầu vào được dựng lại ngoài vùng đo.
+ * Báo cáo trung vị ns/phần tử và bytes/chu kỳ, với số byte là lượng dữ liệu
+ * tối thiểu kernel phải đọc + ghi và chu kỳ đo bằng bộ đếm TSC.
+ *
+ * Cách dùng: bench_kernels [--csv] [tên kernel ...]
+ */
+
+#define BENCH_MIN_SAMPLES 5
+#define BENCH_MAX_SAMPLES 1000
+#define BENCH_MIN_TIME 0.05
+#define BENCH_MAX_VALUE 1000000
+#define BENCH_MERGE_WAYS 8
+
+// Vùng làm việc chung của các kernel
+typedef struct {
+    int n;
+    int* input;             // dữ liệu ngẫu nhiên gốc
+    int* work;              // mảng kernel thao tác
+    int* out;               // mảng kết quả (k-way merge, copy)
+    int* chunks[BENCH_MERGE_WAYS];
+    int chunk_sizes[BENCH_MERGE_WAYS];
+} KernelData;
+
+typedef struct {
+    const char* name;
+    int max_n;                                  // kích thước lớn nhất cần đo
+    void (*prepare)(KernelData* d);             // dựng lại đầu vào, không tính giờ
+    void (*run)(KernelData* d);                 // kernel được đo
+    double (*bytes)(int n);                     // byte đọc + ghi tối thiểu
+} Kernel;
+
+static int compareInt(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Chia input thành BENCH_MERGE_WAYS run đã sắp xếp nằm liên tiếp trong work
+static void prepareSortedRuns(KernelData* d) {
+    int base = d->n / BENCH_MERGE_WAYS;
+    int offset = 0;
+    copyArray(d->input, d->work, d->n);
+    for (int k = 0; k < BENCH_MERGE_WAYS; k++) {
+        d->chunk_sizes[k] = k == BENCH_MERGE_WAYS - 1 ? d->n - offset : base;
+        d->chunks[k] = d->work + offset;
+        qsort(d->chunks[k], d->chunk_sizes[k], sizeof(int), compareInt);
+        offset += d->chunk_sizes[k];
+    }
+}
+
+// ---------- insertionSortAsc ----------
+static void prepareInsertion(KernelData* d) {
+    copyArray(d->input, d->work, d->n);
+}
+
+static void runInsertion(KernelData* d) {
+    insertionSortAsc(d->work, d->n);
+}
+
+static double bytesReadWrite(int n) {
+    return 2.0 * n * sizeof(int);
+}
+
+// ---------- merge_openmp_chunks (k-way) ----------
+static void runKWayMerge(KernelData* d) {
+    merge_openmp_chunks(d->chunks, d->chunk_sizes, BENCH_MERGE_WAYS, d->out, d->n, 1);
+}
+
+// ---------- mergeSortedArrays (k-way, một luồng) ----------
+static void runMergeSortedArrays(KernelData* d) {
+    mergeSortedArrays(d->chunks, d->chunk_sizes, BENCH_MERGE_WAYS, d->out, NULL, 1, 1, NULL);
+}
+
+// ---------- merge_two_arrays ----------
+static void prepareTwoRuns(KernelData* d) {
+    int half = d->n / 2;
+    copyArray(d->input, d->work, d->n);
+    qsort(d->work, half, sizeof(int), compareInt);
+    qsort(d->work + half, d->n - half, sizeof(int), compareInt);
+}
+
+static void runMergeTwo(KernelData* d) {
+    merge_two_arrays(d->work, 0, d->n / 2 - 1, d->n - 1, 1);
+}
+
+// copy ra mảng tạm rồi trộn ngược lại: đọc + ghi hai lần
+static double bytesMergeTwo(int n) {
+    return 4.0 * n * sizeof(int);
+}
+
+// ---------- merge_mpi_chunks ----------
+static void runMPIChunkMerge(KernelData* d) {
+    // merge_mpi_chunks ghi đè chunk_sizes, prepare dựng lại mỗi lần
+    merge_mpi_chunks(d->work, d->chunk_sizes, BENCH_MERGE_WAYS, d->n, 1);
+}
+
+// trộn cặp đôi log2(k) vòng, mỗi vòng như merge_two_arrays
+static double bytesMPIChunkMerge(int n) {
+    int passes = 0;
+    for (int k = 1; k < BENCH_MERGE_WAYS; k *= 2) passes++;
+    return passes * bytesMergeTwo(n);
+}
+
+// ---------- copyArray ----------
+static void prepareNothing(KernelData* d) {
+    (void)d;
+}
+
+static void runCopy(KernelData* d) {
+    copyArray(d->input, d->out, d->n);
+}
+
+// ---------- generateRandomArray ----------
+static void runGenerate(KernelData* d) {
+    generateRandomArray(d->work, d->n, BENCH_MAX_VALUE);
+}
+
+static double bytesWriteOnly(int n) {
+    return 1.0 * n * sizeof(int);
+}
+
+static const Kernel kernels[] = {
+    {"insertionSortAsc",    1 << 14, prepareInsertion,  runInsertion,         bytesReadWrite},
+    {"merge_openmp_chunks", 1 << 22, prepareSortedRuns, runKWayMerge,         bytesReadWrite},
+    {"mergeSortedArrays",   1 << 22, prepareSortedRuns, runMergeSortedArrays, bytesReadWrite},
+    {"merge_two_arrays",    1 << 22, prepareTwoRuns,    runMergeTwo,          bytesMergeTwo},
+    {"merge_mpi_chunks",    1 << 22, prepareSortedRuns, runMPIChunkMerge,     bytesMPIChunkMerge},
+    {"copyArray",           1 << 22, prepareNothing,    runCopy,              bytesReadWrite},
+    {"generateRandomArray", 1 << 22, prepareNothing,    runGenerate,          bytesWriteOnly},
+};
+#define NUM_KERNELS (int)(sizeof(kernels) / sizeof(kernels[0]))
+
+// Đo một kernel ở kích thước n, trả về trung vị số chu kỳ TSC mỗi lần gọi
+static double measureKernel(const Kernel* kernel, KernelData* d, int* samples_out) {
+    double samples[BENCH_MAX_SAMPLES];
+    int count = 0;
+    double elapsed = 0.0;
+
+    // Một lần khởi động để làm nóng cache và trang bộ nhớ
+    kernel->prepare(d);
+    kernel->run(d);
+
+    while (count < BENCH_MAX_SAMPLES && (count < BENCH_MIN_SAMPLES || elapsed < BENCH_MIN_TIME)) {
+        kernel->prepare(d);
+        double t0 = getCurrentTime();
+        unsigned long long c0 = getTimestampCounter();
+        kernel->run(d);
+        unsigned long long c1 = getTimestampCounter();
+        elapsed += getCurrentTime() - t0;
+        samples[count++] = (double)(c1 - c0);
+    }
+
+    OGTSampleStats stats;
+    computeSampleStats(samples, count, &stats);
+    *samples_out = count;
+    return stats.median;
+}
+
+static int kernelSelected(const char* name, int argc, char* argv[], int first) {
+    if (first >= argc) return 1;
+    for (int i = first; i < argc; i++) {
+        if (strcmp(argv[i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int csv = 0;
+    int first = 1;
+    if (argc > 1 && strcmp(argv[1], "--csv") == 0) {
+        csv = 1;
+        first = 2;
+    }
+    for (int i = first; i < argc; i++) {
+        int known = 0;
+        for (int k = 0; k < NUM_KERNELS; k++) {
+            if (strcmp(argv[i], kernels[k].name) == 0) known = 1;
+        }
+        if (!known) {
+            fprintf(stderr, RED "Kernel không hợp lệ: %s\n" RESET, argv[i]);
+            fprintf(stderr, "Cách dùng: %s [--csv] [kernel ...]\nKernel:", argv[0]);
+            for (int k = 0; k < NUM_KERNELS; k++) fprintf(stderr, " %s", kernels[k].name);
+            fprintf(stderr, "\n");
+            return 2;
+        }
+    }
+
+    int max_n = 0;
+    for (int k = 0; k < NUM_KERNELS; k++) {
+        if (kernels[k].max_n > max_n) max_n = kernels[k].max_n;
+    }
+
+    KernelData d;
+    memset(&d, 0, sizeof(d));
+    d.input = malloc((size_t)max_n * sizeof(int));
+    d.work = malloc((size_t)max_n * sizeof(int));
+    d.out = malloc((size_t)max_n * sizeof(int));
+    if (!d.input || !d.work || !d.out) {
+        fprintf(stderr, RED "Không đủ bộ nhớ cho %d phần tử\n" RESET, max_n);
+        return 1;
+    }
+    generateRandomArraySeeded(d.input, max_n, BENCH_MAX_VALUE, getRandomSeed());
+
+    double hz = getTimestampCounterHz();
+
+    if (csv) {
+        printf("kernel,n,samples,ns_per_elem,cycles_per_elem,bytes_per_cycle\n");
+    } else {
+        printf(CYAN "=== MICROBENCHMARK KERNEL ===" RESET "\n");
+        printf("Tần số TSC: %.2f GHz, trộn k-chiều với k = %d\n\n", hz / 1e9, BENCH_MERGE_WAYS);
+        printf("%-20s | %-9s | %-7s | %-12s | %-12s | %-10s\n",
+               "Kernel", "n", "Mẫu", "ns/phần tử", "chu kỳ/pt", "bytes/chu kỳ");
+        printf("------------------------------------------------------------------------------------\n");
+    }
+
+    for (int k = 0; k < NUM_KERNELS; k++) {
+        const Kernel* kernel = &kernels[k];
+        if (!kernelSelected(kernel->name, argc, argv, first)) continue;
+
+        // Kích thước tăng theo lũy thừa 4, từ 16 phần tử tới max_n
+        for (int n = 16; n <= kernel->max_n; n *= 4) {
+            int samples;
+            d.n = n;
+            double cycles = measureKernel(kernel, &d, &samples);
+            double ns_per_elem = cycles / hz * 1e9 / n;
+            double bytes_per_cycle = cycles > 0.0 ? kernel->bytes(n) / cycles : 0.0;
+
+            if (csv) {
+                printf("%s,%d,%d,%.4f,%.4f,%.4f\n", kernel->name, n, samples,
+                       ns_per_elem, cycles / n, bytes_per_cycle);
+            } else {
+                printf("%-20s | %-9d | %-7d | %-12.4f | %-12.4f | %-10.4f\n", kernel->name, n, samples,
+                       ns_per_elem, cycles / n, bytes_per_cycle);
+            }
+            fflush(stdout);
+        }
+    }
+
+    free(d.input);
+    free(d.work);
+    free(d.out);
+    return 0;
+}
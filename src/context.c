@@ -0,0 +1,209 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/**
+ * Context sắp xếp và governor đồng thời toàn tiến trình
+ *
+ * Governor giữ tổng số luồng các lần sắp xếp đang dùng không vượt concurrencyLimit (mặc định
+ * số lõi). Mỗi lần sắp xếp xin số luồng của kế hoạch và được cấp tối đa phần chia đều
+ * limit / (số lần sắp xếp đang chạy + 1) trong số còn trống. Lời xin không bao giờ chặn: khi
+ * hết chỗ, lần sắp xếp chạy trên chính luồng gọi (vốn đã chạy), nên governor không tạo thêm
+ * luồng nào vượt giới hạn. Số luồng được cấp cố định trong suốt một lần sắp xếp.
+ *
+ * Governor được xin bên trong các kernel song song (OpenMP, Pthreads, latencySort, stream sort,
+ * sắp xếp file, segmentedSort, mergeSortedArrays), nên mọi đường sắp xếp của thư viện đều chịu
+ * giới hạn, không riêng ogt_sort. Kế hoạch chạy đúng backend đã chọn: số khối và cách trộn theo
+ * kế hoạch và hồ sơ tinh chỉnh (khối nhỏ rút ngắn sắp xếp chèn kể cả khi chạy ít luồng), chỉ số luồng theo governor.
+ * Không lệnh nào đổi trạng thái OpenMP toàn cục. Ngoài phạm vi: backend mpi (mỗi rank một tiến
+ * trình) và các tiện ích không sắp xếp (sinh dữ liệu, đọc văn bản, đo băng thông, hiệu chuẩn).
+ *
+ * ogt_context chỉ đọc sau khi tạo; vùng tạm của backend OpenMP lấy từ danh sách rảnh dưới khóa,
+ * mỗi lời gọi đồng thời dùng một vùng riêng và trả lại khi xong để lần sau dùng lại.
+ */
+
+typedef struct OGTWorkspace {
+    int* scratch;               // khối tạm + mảng trộn của parallelInsertionSortScratch
+    size_t capacity;
+    struct OGTWorkspace* next;
+} OGTWorkspace;
+
+struct ogt_context {
+    OGTSortOptions opts;        // stats luôn NULL, thống kê truyền theo từng lời gọi
+    pthread_mutex_t lock;
+    OGTWorkspace* free_list;
+};
+
+static pthread_mutex_t governor_lock = PTHREAD_MUTEX_INITIALIZER;
+static int governor_limit = 0;      // 0: chưa đặt, dùng số lõi
+static int governor_in_use = 0;
+static int governor_active = 0;     // lần sắp xếp đang giữ luồng
+
+static int hardwareThreads(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+void setConcurrencyLimit(int threads) {
+    pthread_mutex_lock(&governor_lock);
+    governor_limit = threads > 0 ? threads : 0;
+    pthread_mutex_unlock(&governor_lock);
+}
+
+int concurrencyLimit(void) {
+    pthread_mutex_lock(&governor_lock);
+    int limit = governor_limit > 0 ? governor_limit : hardwareThreads();
+    pthread_mutex_unlock(&governor_lock);
+    return limit;
+}
+
+int governorAcquire(int wanted) {
+    if (wanted < 1) wanted = 1;
+    pthread_mutex_lock(&governor_lock);
+    int limit = governor_limit > 0 ? governor_limit : hardwareThreads();
+    int share = limit / (governor_active + 1);
+    int available = limit - governor_in_use;
+    int granted = wanted;
+    if (granted > share) granted = share;
+    if (granted > available) granted = available;
+    if (granted < 1) granted = 1;       // luồng gọi luôn được chạy
+    governor_in_use += granted;
+    governor_active++;
+    pthread_mutex_unlock(&governor_lock);
+    return granted;
+}
+
+void governorRelease(int granted) {
+    pthread_mutex_lock(&governor_lock);
+    governor_in_use -= granted;
+    governor_active--;
+    pthread_mutex_unlock(&governor_lock);
+}
+
+int governorInUse(void) {
+    pthread_mutex_lock(&governor_lock);
+    int in_use = governor_in_use;
+    pthread_mutex_unlock(&governor_lock);
+    return in_use;
+}
+
+// ========== VÙNG TẠM ==========
+
+static OGTWorkspace* acquireWorkspace(ogt_context* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    OGTWorkspace* ws = ctx->free_list;
+    if (ws) ctx->free_list = ws->next;
+    pthread_mutex_unlock(&ctx->lock);
+    if (!ws) ws = (OGTWorkspace*)ogtCalloc(1, sizeof(OGTWorkspace));
+    return ws;
+}
+
+static void freeWorkspace(OGTWorkspace* ws) {
+    ogtFree(ws->scratch);
+    ogtFree(ws);
+}
+
+static void releaseWorkspace(ogt_context* ctx, OGTWorkspace* ws) {
+    pthread_mutex_lock(&ctx->lock);
+    ws->next = ctx->free_list;
+    ctx->free_list = ws;
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+// Nới vùng tạm cho n phần tử (2 * n: khối tạm và mảng trộn)
+static int reserveWorkspace(OGTWorkspace* ws, int n) {
+    size_t needed = 2 * (size_t)n;
+    if (needed > ws->capacity) {
+        int* scratch = (int*)ogtMalloc(needed * sizeof(int));
+        if (!scratch) return -1;
+        ogtFree(ws->scratch);
+        ws->scratch = scratch;
+        ws->capacity = needed;
+    }
+    return 0;
+}
+
+// ========== THỰC THI KẾ HOẠCH ==========
+
+int ogt_sort_with_plan(ogt_context* ctx, int a[], int n, const OGTSortPlan* plan, int ascending,
+                       OGTSortStats* stats) {
+    if (plan->backend == OGT_BACKEND_MPI) {
+        printf(RED "Lỗi: Backend mpi là hàm tập thể, không chạy qua governor\n" RESET);
+        return -1;
+    }
+    if (stats) resetSortStats(stats);
+    if (n <= 1) return 0;
+
+    switch (plan->backend) {
+        case OGT_BACKEND_SEQ:
+            insertionSortStats(a, n, ascending, stats);
+            return 0;
+        case OGT_BACKEND_PTHREADS:
+            parallelInsertionSortPthreadsStats(a, n, plan->threads, ascending, stats);
+            return 0;
+        case OGT_BACKEND_OPENMP:
+        default:
+            break;
+    }
+
+    // OpenMP: có context thì dùng lại vùng tạm của context, không thì kernel tự cấp phát
+    if (!ctx) {
+        parallelInsertionSortStats(a, n, plan->threads, ascending, stats);
+        return 0;
+    }
+    OGTWorkspace* ws = acquireWorkspace(ctx);
+    if (!ws || reserveWorkspace(ws, n) != 0) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho vùng tạm %d phần tử\n" RESET, n);
+        if (ws) releaseWorkspace(ctx, ws);
+        return -1;
+    }
+    parallelInsertionSortScratch(a, n, plan->threads, ascending, ws->scratch, stats);
+    releaseWorkspace(ctx, ws);
+    return 0;
+}
+
+// ========== CONTEXT ==========
+
+ogt_context* ogt_context_create(const OGTSortOptions* opts) {
+    if (opts && opts->backend == OGT_BACKEND_MPI) {
+        printf(RED "Lỗi: Context không hỗ trợ backend mpi (hàm tập thể)\n" RESET);
+        return NULL;
+    }
+    if (opts && opts->backend != OGT_BACKEND_AUTO &&
+        (opts->backend < 0 || opts->backend >= OGT_BACKEND_COUNT)) {
+        printf(RED "Lỗi: Backend không hợp lệ\n" RESET);
+        return NULL;
+    }
+
+    ogt_context* ctx = (ogt_context*)ogtCalloc(1, sizeof(ogt_context));
+    if (!ctx) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho context\n" RESET);
+        return NULL;
+    }
+    if (opts) {
+        ctx->opts = *opts;
+    } else {
+        ogt_sort_default_options(&ctx->opts);
+    }
+    ctx->opts.stats = NULL;
+    pthread_mutex_init(&ctx->lock, NULL);
+    return ctx;
+}
+
+void ogt_context_destroy(ogt_context* ctx) {
+    if (!ctx) return;
+    while (ctx->free_list) {
+        OGTWorkspace* ws = ctx->free_list;
+        ctx->free_list = ws->next;
+        freeWorkspace(ws);
+    }
+    pthread_mutex_destroy(&ctx->lock);
+    ogtFree(ctx);
+}
+
+int ogt_context_sort(ogt_context* ctx, int a[], int n, OGTSortStats* stats) {
+    OGTSortPlan plan;
+    if (ogt_sort_plan(a, n, &ctx->opts, &plan) != 0) return -1;
+    return ogt_sort_with_plan(ctx, a, n, &plan, ctx->opts.ascending, stats);
+}
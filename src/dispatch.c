@@ -0,0 +1,342 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <stdint.h>
+#include <omp.h>
+#include <pthread.h>
+
+/**
+ * ogt_sort: một điểm vào, tự chọn thuật toán, backend và số worker theo mô hình chi phí
+ *
+ * Mô hình tách thời gian của mỗi backend thành các hạng mục đo được trên máy:
+ *   seq      = dời * nghịch_thế(n) + quét * n
+ *   openmp   = fork + đợt * (copy + dời * nghịch_thế(n/t) + quét) * n/t + k_chiều * n * t + copy * n
+ *   pthreads = spawn * t + đợt * (dời * nghịch_thế(n/t) + quét * n/t) + cặp_đôi * n * ceil(log2 t)
+ * với đợt = ceil(t / số lõi). Số nghịch thế trong một khối được ước lượng bằng cách lấy mẫu
+ * các cặp phần tử trong cùng khối của chính mảng đầu vào, nên mô hình nhận ra dữ liệu đã
+ * (gần) sắp xếp hoặc đảo ngược. Mẫu được dùng lại cho các cỡ khối cùng lũy thừa của 2, nên một
+ * lần lập kế hoạch lấy mẫu tối đa log2(n) lần; khi chỉ còn một ứng viên (mảng dưới ngưỡng tuần
+ * tự của hồ sơ, hoặc backend bị ép với một số luồng) thì không lấy mẫu. Các hằng số đến từ một
+ * lần đo ngắn trên máy (ogt_calibrate).
+ *
+ * OGT_OBJECTIVE_LATENCY chọn thời gian nhỏ nhất; OGT_OBJECTIVE_THROUGHPUT chọn lõi*giây
+ * nhỏ nhất, hợp khi nhiều lần sắp xếp chạy song song với nhau.
+ */
+
+#define OGT_PROBE_SIZE      65536   // phần tử cho các phép đo tuyến tính
+#define OGT_PROBE_INSERTION 2048    // phần tử cho phép đo sắp xếp chèn ngẫu nhiên
+#define OGT_PROBE_REPS      3
+#define OGT_PLAN_SAMPLES    128     // cặp lấy mẫu cho mỗi cỡ khối
+#define OGT_PLAN_BUCKETS    32      // nhóm cỡ khối theo lũy thừa của 2
+
+static OGTCostModel host_model;
+static pthread_once_t host_model_once = PTHREAD_ONCE_INIT;
+
+static void* idleThread(void* arg) {
+    return arg;
+}
+
+// Thời gian nhỏ nhất (giây) của một phép đo, data được khởi tạo lại trước mỗi lần
+#define PROBE_MIN(result, setup, body)                      \
+    do {                                                    \
+        result = 1e30;                                      \
+        for (int rep = 0; rep < OGT_PROBE_REPS; rep++) {    \
+            setup;                                          \
+            double t_probe = getCurrentTime();              \
+            body;                                           \
+            double elapsed = getCurrentTime() - t_probe;    \
+            if (elapsed < result) result = elapsed;         \
+        }                                                   \
+    } while (0)
+
+int ogt_calibrate(OGTCostModel* model) {
+    memset(model, 0, sizeof(*model));
+    model->cores = omp_get_num_procs();
+
+    int n = OGT_PROBE_SIZE;
+    int* a = (int*)ogtMalloc((size_t)n * sizeof(int));
+    int* b = (int*)ogtMalloc((size_t)n * sizeof(int));
+    if (!a || !b) {
+        printf(RED "Lỗi: Không đủ bộ nhớ để đo mô hình chi phí\n" RESET);
+        ogtFree(a);
+        ogtFree(b);
+        return -1;
+    }
+    double t;
+
+    // Sắp xếp chèn trên dữ liệu đã sắp xếp: chỉ còn chi phí quét
+    PROBE_MIN(t, for (int i = 0; i < n; i++) a[i] = i, insertionSortAsc(a, n));
+    model->scan_ns = t * 1e9 / n;
+
+    // Dữ liệu ngẫu nhiên: m(m-1)/4 nghịch thế kỳ vọng
+    int m = OGT_PROBE_INSERTION;
+    PROBE_MIN(t, generateRandomArraySeeded(a, m, 1 << 30, 0x0C057ULL), insertionSortAsc(a, m));
+    double inversions = (double)m * (m - 1) / 4.0;
+    model->insertion_ns = (t * 1e9 - model->scan_ns * m) / inversions;
+    if (model->insertion_ns <= 0) model->insertion_ns = t * 1e9 / inversions;
+
+    PROBE_MIN(t, (void)0, copyArray(a, b, n));
+    model->copy_ns = t * 1e9 / n;
+
+    // Trộn k-chiều tuyến tính (openmp) trên 8 khối đã sắp xếp
+    int k = 8;
+    int* chunks[8];
+    int sizes[8];
+    for (int c = 0; c < k; c++) {
+        chunks[c] = b + c * (n / k);
+        sizes[c] = n / k;
+        for (int i = 0; i < n / k; i++) chunks[c][i] = i * k + c;
+    }
+    PROBE_MIN(t, (void)0, merge_openmp_chunks(chunks, sizes, k, a, n, 1));
+    model->kway_ns = t * 1e9 / ((double)n * k);
+
+    // Một lượt trộn cặp đôi (pthreads) trên hai nửa đã sắp xếp
+    PROBE_MIN(t, for (int i = 0; i < n; i++) a[i] = i < n / 2 ? 2 * i : 2 * (i - n / 2) + 1,
+              merge_two_arrays(a, 0, n / 2 - 1, n - 1, 1));
+    model->merge_ns = t * 1e9 / n;
+
+    pthread_t threads[8];
+    PROBE_MIN(t, (void)0, {
+        int created = 0;
+        for (; created < 8; created++) {
+            if (pthread_create(&threads[created], NULL, idleThread, NULL) != 0) break;
+        }
+        for (int i = 0; i < created; i++) pthread_join(threads[i], NULL);
+    });
+    model->spawn_us = t * 1e6 / 8;
+
+    // Vùng song song rỗng; #pragma không đặt được trong đối số macro nên đo trực tiếp
+    volatile int sink = 0;
+    t = 1e30;
+    for (int rep = 0; rep < OGT_PROBE_REPS; rep++) {
+        double t_probe = getCurrentTime();
+        for (int r = 0; r < 16; r++) {
+            #pragma omp parallel num_threads(model->cores)
+            {
+                if (omp_get_thread_num() == 0) sink++;
+            }
+        }
+        double elapsed = getCurrentTime() - t_probe;
+        if (elapsed < t) t = elapsed;
+    }
+    model->fork_us = t * 1e6 / 16;
+
+    ogtFree(a);
+    ogtFree(b);
+    return 0;
+}
+
+static void calibrateHostModel(void) {
+    if (ogt_calibrate(&host_model) != 0) {
+        // Hằng số thô để vẫn chọn được backend khi không đo được
+        host_model.cores = omp_get_num_procs();
+        host_model.insertion_ns = 0.5;
+        host_model.scan_ns = 1.0;
+        host_model.copy_ns = 0.3;
+        host_model.kway_ns = 1.0;
+        host_model.merge_ns = 3.0;
+        host_model.spawn_us = 20.0;
+        host_model.fork_us = 5.0;
+    }
+}
+
+const OGTCostModel* ogt_host_model(void) {
+    pthread_once(&host_model_once, calibrateHostModel);
+    return &host_model;
+}
+
+void ogt_sort_default_options(OGTSortOptions* opts) {
+    memset(opts, 0, sizeof(*opts));
+    opts->objective = OGT_OBJECTIVE_LATENCY;
+    opts->ascending = 1;
+    opts->max_threads = 0;
+    opts->backend = OGT_BACKEND_AUTO;
+    opts->model = NULL;
+    opts->stats = NULL;
+}
+
+const char* objectiveName(OGTObjective objective) {
+    return objective == OGT_OBJECTIVE_THROUGHPUT ? "throughput" : "latency";
+}
+
+int parseObjective(const char* name) {
+    if (strcmp(name, "latency") == 0) return OGT_OBJECTIVE_LATENCY;
+    if (strcmp(name, "throughput") == 0) return OGT_OBJECTIVE_THROUGHPUT;
+    return -1;
+}
+
+static uint64_t nextSample(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Tỉ lệ cặp (i < j) cùng một khối dài block bị ngược thứ tự mong muốn
+static double inversionRatio(const int a[], int n, int block, int ascending) {
+    if (block < 2) return 0.0;
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ (uint64_t)n ^ ((uint64_t)block << 32);
+    int inverted = 0;
+    for (int s = 0; s < OGT_PLAN_SAMPLES; s++) {
+        int start = (int)(nextSample(&state) % (uint64_t)(n - block + 1));
+        int i = start + (int)(nextSample(&state) % (uint64_t)block);
+        int j = start + (int)(nextSample(&state) % (uint64_t)block);
+        if (i == j) continue;
+        if (i > j) {
+            int swap = i;
+            i = j;
+            j = swap;
+        }
+        if (ascending ? a[i] > a[j] : a[i] < a[j]) inverted++;
+    }
+    return (double)inverted / OGT_PLAN_SAMPLES;
+}
+
+// Tỉ lệ nghịch thế dùng chung cho các khối cùng nhóm floor(log2(block)); ratios[] khởi tạo -1
+static double cachedInversionRatio(double ratios[], const int a[], int n, int block, int ascending) {
+    int bucket = 0;
+    while (bucket < OGT_PLAN_BUCKETS - 1 && (block >> (bucket + 1)) > 0) bucket++;
+    if (ratios[bucket] < 0) ratios[bucket] = inversionRatio(a, n, block, ascending);
+    return ratios[bucket];
+}
+
+// Thời gian sắp xếp chèn một khối (ns)
+static double insertionCost(const OGTCostModel* model, double ratio, double block) {
+    return model->insertion_ns * ratio * block * (block - 1) / 2.0 + model->scan_ns * block;
+}
+
+// Thời gian trộn k khối (ns) theo chiến lược của hồ sơ; tree_default: cách trộn sẵn có là cây
+static double mergeCost(const OGTCostModel* model, int n, int k, int tree_default) {
+    OGTMergeStrategy merge = ogtTuning()->merge;
+    int tree = merge == OGT_MERGE_TREE || (merge == OGT_MERGE_NATIVE && tree_default);
+    if (k <= 1) return 0.0;
+    if (!tree) return model->kway_ns * (double)n * k;
+    int passes = 0;
+    for (int m = 1; m < k; m *= 2) passes++;
+    return model->merge_ns * (double)n * passes;
+}
+
+// Thời gian dự đoán (ns) của backend với t worker và k khối (k >= t, chia đều xoay vòng)
+// Governor cấp tối đa số lõi, nên k khối chạy trên đội min(t, số lõi) luồng
+static double predictTime(const OGTCostModel* model, OGTBackend backend, int n, int t, int k, double ratio) {
+    int cores = model->cores > 0 ? model->cores : 1;
+    int team = t < cores ? t : cores;
+    double per_thread = (double)((k + team - 1) / team);
+    double block = (double)n / k;
+
+    switch (backend) {
+        case OGT_BACKEND_SEQ:
+            return insertionCost(model, ratio, n);
+        case OGT_BACKEND_OPENMP:
+            return model->fork_us * 1e3 +
+                   per_thread * (model->copy_ns * block + insertionCost(model, ratio, block)) +
+                   mergeCost(model, n, k, 0) + model->copy_ns * n;
+        case OGT_BACKEND_PTHREADS: {
+            double merge = mergeCost(model, n, k, 1);
+            // trộn tuyến tính của pthreads ghi vào vùng tạm rồi copy lại
+            if (k > 1 && ogtTuning()->merge == OGT_MERGE_LINEAR) merge += model->copy_ns * n;
+            return model->spawn_us * 1e3 * team + per_thread * insertionCost(model, ratio, block) +
+                   merge;
+        }
+        default:
+            return 1e30;
+    }
+}
+
+int ogt_sort_plan(const int a[], int n, const OGTSortOptions* opts, OGTSortPlan* plan) {
+    OGTSortOptions defaults;
+    if (!opts) {
+        ogt_sort_default_options(&defaults);
+        opts = &defaults;
+    }
+    const OGTCostModel* model = opts->model ? opts->model : ogt_host_model();
+    int cores = model->cores > 0 ? model->cores : 1;
+
+    memset(plan, 0, sizeof(*plan));
+    plan->backend = OGT_BACKEND_SEQ;
+    plan->threads = 1;
+    if (n <= 1) return 0;
+
+    // Mặc định thử tới 4 x số lõi: khối nhỏ hơn rút ngắn sắp xếp chèn kể cả khi vượt số lõi
+    int max_threads = opts->max_threads > 0 ? opts->max_threads : 4 * cores;
+    const OGTTuning* tuning = ogtTuning();
+    if (max_threads > tuning->max_threads) max_threads = tuning->max_threads;
+    if (max_threads > n) max_threads = n;
+
+    if (opts->backend != OGT_BACKEND_AUTO) {
+        if (opts->backend < 0 || opts->backend >= OGT_BACKEND_COUNT) {
+            printf(RED "Lỗi: Backend không hợp lệ\n" RESET);
+            return -1;
+        }
+        plan->backend = (OGTBackend)opts->backend;
+    }
+
+    // Khoảng số luồng thử của mỗi backend; rỗng khi lo > hi
+    int lo[OGT_BACKEND_MPI], hi[OGT_BACKEND_MPI];
+    int candidates = 0;
+    for (int b = 0; b < OGT_BACKEND_MPI; b++) {
+        lo[b] = b == OGT_BACKEND_SEQ ? 1 : 2;
+        hi[b] = b == OGT_BACKEND_SEQ ? 1 : max_threads;
+        if (opts->backend != OGT_BACKEND_AUTO && b != opts->backend) hi[b] = 0;
+        // OpenMP tự chuyển sang tuần tự dưới ngưỡng của hồ sơ; khi tự chọn, ngưỡng áp cho mọi backend
+        if (b != OGT_BACKEND_SEQ && n < tuning->seq_cutoff &&
+            (b == OGT_BACKEND_OPENMP || opts->backend == OGT_BACKEND_AUTO)) {
+            hi[b] = 1;
+        }
+        if (hi[b] >= lo[b]) candidates += hi[b] - lo[b] + 1;
+    }
+
+    // Một ứng viên: không có gì để so sánh, bỏ qua lấy mẫu và dự đoán
+    if (candidates <= 1) {
+        for (int b = 0; b < OGT_BACKEND_MPI; b++) {
+            if (hi[b] < lo[b]) continue;
+            plan->backend = (OGTBackend)b;
+            plan->threads = lo[b];
+        }
+        if (opts->backend == OGT_BACKEND_MPI) plan->threads = 1;
+        return 0;
+    }
+
+    double ratios[OGT_PLAN_BUCKETS];
+    for (int i = 0; i < OGT_PLAN_BUCKETS; i++) ratios[i] = -1.0;
+
+    double best = 1e300;
+    for (int b = 0; b < OGT_BACKEND_MPI; b++) {
+        for (int t = lo[b]; t <= hi[b]; t++) {
+            int k = b == OGT_BACKEND_SEQ ? 1 : tuningChunkCount(n, t);
+            double ratio = cachedInversionRatio(ratios, a, n, n / k, opts->ascending);
+            double time = predictTime(model, (OGTBackend)b, n, t, k, ratio) * 1e-9;
+            double cost = time * (t < cores ? t : cores);
+            double score = opts->objective == OGT_OBJECTIVE_THROUGHPUT ? cost : time;
+            if (score < best) {
+                best = score;
+                plan->backend = (OGTBackend)b;
+                plan->threads = t;
+                plan->inversion_ratio = ratio;
+                plan->predicted_time = time;
+                plan->predicted_cost = cost;
+            }
+        }
+    }
+
+    // MPI chỉ khi được ép: hàm tập thể, mọi rank phải cùng gọi ogt_sort
+    if (opts->backend == OGT_BACKEND_MPI) plan->threads = 1;
+    return 0;
+}
+
+int ogt_sort(int a[], int n, const OGTSortOptions* opts) {
+    OGTSortOptions defaults;
+    if (!opts) {
+        ogt_sort_default_options(&defaults);
+        opts = &defaults;
+    }
+
+    OGTSortPlan plan;
+    if (ogt_sort_plan(a, n, opts, &plan) != 0) return -1;
+
+    // MPI là hàm tập thể trên các rank; các backend còn lại chạy dưới governor đồng thời
+    if (plan.backend == OGT_BACKEND_MPI) {
+        parallelInsertionSortMPIStats(a, n, opts->ascending, opts->stats);
+        return 0;
+    }
+    return ogt_sort_with_plan(NULL, a, n, &plan, opts->ascending, opts->stats);
+}
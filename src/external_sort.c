@@ -0,0 +1,637 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef OGT_HAVE_POSIX_AIO
+#include <aio.h>
+#endif
+
+/**
+ * Sắp xếp ngoài (out-of-core) cho file khóa lớn hơn RAM
+ *
+ * 1. Sinh run: đọc từng đoạn vừa ngân sách bộ nhớ, sắp xếp bằng backend đã chọn,
+ *    ghi vào file tạm ở cùng vị trí. Ba bộ đệm xoay vòng để đọc run kế tiếp và ghi
+ *    run trước trong lúc sắp xếp run hiện tại.
+ * 2. Trộn: trộn k-chiều bằng heap, mỗi run đọc tuần tự qua hai bộ đệm lớn (một bộ đệm
+ *    đang trộn, một bộ đệm đang đọc trước), đầu ra cũng ghi qua hai bộ đệm.
+ *    Khi số run vượt quá fan-in mà ngân sách cho phép thì trộn nhiều lượt giữa hai file tạm.
+ *
+ * I/O bất đồng bộ dùng POSIX AIO nếu có (OGT_HAVE_POSIX_AIO), ngược lại mỗi yêu cầu
+ * chạy pread/pwrite trên một pthread riêng. Mọi bộ đệm cấp phát qua ogtMalloc nên
+ * đỉnh byte sống của lần sắp xếp phản ánh đúng ngân sách.
+ */
+
+#define OGT_EXTERNAL_MIN_BUFFER (256 * 1024)    // bộ đệm trộn nhỏ nhất mỗi luồng dữ liệu (byte)
+#define OGT_EXTERNAL_RESERVE (16 * 1024)        // dành cho bảng khối/tham số luồng của backend (byte)
+
+// ========== I/O BẤT ĐỒNG BỘ ==========
+
+typedef struct {
+    double wait_time;           // thời gian chờ I/O không che được
+    long long bytes_read;
+    long long bytes_written;
+} IOStats;
+
+typedef struct {
+    int fd;
+    void* buffer;
+    size_t bytes;
+    off_t offset;
+    int is_write;
+    int active;
+    ssize_t result;
+#ifdef OGT_HAVE_POSIX_AIO
+    int submitted;              // 0 nếu aio_* từ chối và đã chạy đồng bộ
+    struct aiocb cb;
+#else
+    pthread_t thread;
+#endif
+} IORequest;
+
+// Đọc/ghi đủ bytes (hoặc tới EOF khi đọc), trả về số byte, -1 nếu lỗi
+static ssize_t transferAll(int fd, void* buffer, size_t bytes, off_t offset, int is_write) {
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t r = is_write ? pwrite(fd, (char*)buffer + done, bytes - done, offset + (off_t)done)
+                             : pread(fd, (char*)buffer + done, bytes - done, offset + (off_t)done);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (r == 0) break;
+        done += (size_t)r;
+    }
+    return (ssize_t)done;
+}
+
+#ifndef OGT_HAVE_POSIX_AIO
+static void* ioThread(void* arg) {
+    IORequest* request = (IORequest*)arg;
+    request->result = transferAll(request->fd, request->buffer, request->bytes,
+                                  request->offset, request->is_write);
+    return NULL;
+}
+#endif
+
+static void ioSubmit(IORequest* request, int fd, void* buffer, size_t bytes, off_t offset, int is_write) {
+    request->fd = fd;
+    request->buffer = buffer;
+    request->bytes = bytes;
+    request->offset = offset;
+    request->is_write = is_write;
+    request->active = 1;
+    request->result = -1;
+
+#ifdef OGT_HAVE_POSIX_AIO
+    memset(&request->cb, 0, sizeof(request->cb));
+    request->cb.aio_fildes = fd;
+    request->cb.aio_buf = buffer;
+    request->cb.aio_nbytes = bytes;
+    request->cb.aio_offset = offset;
+    request->cb.aio_sigevent.sigev_notify = SIGEV_NONE;
+    request->submitted = (is_write ? aio_write(&request->cb) : aio_read(&request->cb)) == 0;
+    if (!request->submitted) request->result = transferAll(fd, buffer, bytes, offset, is_write);
+#else
+    if (pthread_create(&request->thread, NULL, ioThread, request) != 0) {
+        request->thread = pthread_self();
+        request->result = transferAll(fd, buffer, bytes, offset, is_write);
+    }
+#endif
+}
+
+/**
+ * Chờ yêu cầu hoàn tất
+ * @return Số byte đã đọc/ghi, -1 nếu lỗi; 0 nếu không có yêu cầu đang chạy
+ */
+static ssize_t ioWait(IORequest* request, IOStats* io) {
+    if (!request->active) return 0;
+    double start = getCurrentTime();
+
+#ifdef OGT_HAVE_POSIX_AIO
+    if (request->submitted) {
+        const struct aiocb* list[1] = { &request->cb };
+        while (aio_error(&request->cb) == EINPROGRESS) aio_suspend(list, 1, NULL);
+        ssize_t done = aio_return(&request->cb);
+        // Phần còn lại của lần đọc/ghi ngắn được làm nốt đồng bộ
+        if (done >= 0 && (size_t)done < request->bytes && (request->is_write || done > 0)) {
+            ssize_t rest = transferAll(request->fd, (char*)request->buffer + done, request->bytes - (size_t)done,
+                                       request->offset + (off_t)done, request->is_write);
+            done = rest < 0 ? -1 : done + rest;
+        }
+        request->result = done;
+    }
+#else
+    if (!pthread_equal(request->thread, pthread_self())) pthread_join(request->thread, NULL);
+#endif
+
+    request->active = 0;
+    io->wait_time += getCurrentTime() - start;
+    if (request->result > 0) {
+        if (request->is_write) {
+            io->bytes_written += request->result;
+        } else {
+            io->bytes_read += request->result;
+        }
+    }
+    if (request->is_write && request->result >= 0 && (size_t)request->result != request->bytes) return -1;
+    return request->result;
+}
+
+// Tạo file tạm trong dir, xóa tên ngay để file tự biến mất khi đóng
+static int openTempFile(const char* dir) {
+    char path[1024];
+    if (!dir || !*dir) dir = getenv("TMPDIR");
+    if (!dir || !*dir) dir = "/tmp";
+    if (snprintf(path, sizeof(path), "%s/ogt_runs_XXXXXX", dir) >= (int)sizeof(path)) return -1;
+
+    int fd = mkstemp(path);
+    if (fd >= 0) unlink(path);
+    return fd;
+}
+
+// ========== SINH RUN ==========
+
+typedef struct {
+    long long start;            // vị trí phần tử đầu tiên trong file
+    long long count;
+} RunInfo;
+
+/**
+ * Sinh các run đã sắp xếp vào run_fd; hàm tập thể với backend mpi (chỉ rank 0 làm I/O)
+ * @return 0 nếu thành công, -1 nếu lỗi (giống nhau trên mọi rank)
+ */
+static int generateRuns(int input_fd, int run_fd, long long n, long long run_elems,
+                        const OGTExternalSortOptions* opts, int rank, IOStats* io,
+                        OGTExternalSortStats* stats) {
+    size_t width = keyTypeSize(opts->key);
+    int num_runs = (int)((n + run_elems - 1) / run_elems);
+    void* buffers[3] = { NULL, NULL, NULL };
+    IORequest reads[3], writes[3];
+    memset(reads, 0, sizeof(reads));
+    memset(writes, 0, sizeof(writes));
+
+    int status = 0;
+    if (rank == 0) {
+        for (int b = 0; b < 3 && b < num_runs; b++) {
+            buffers[b] = ogtMalloc((size_t)run_elems * width);
+            if (!buffers[b]) status = -1;
+        }
+        if (status == 0) {
+            long long count = n < run_elems ? n : run_elems;
+            ioSubmit(&reads[0], input_fd, buffers[0], (size_t)count * width, 0, 0);
+        }
+    }
+
+    for (int r = 0; r < num_runs; r++) {
+        int b = r % 3;
+        long long start = (long long)r * run_elems;
+        long long count = n - start < run_elems ? n - start : run_elems;
+
+        if (rank == 0 && status == 0) {
+            if (ioWait(&reads[b], io) != (ssize_t)((size_t)count * width)) status = -1;
+
+            // Đọc trước run kế tiếp vào bộ đệm mà lần ghi cũ đã xong
+            if (status == 0 && r + 1 < num_runs) {
+                int next = (r + 1) % 3;
+                long long next_start = start + count;
+                long long next_count = n - next_start < run_elems ? n - next_start : run_elems;
+                if (ioWait(&writes[next], io) < 0) status = -1;
+                ioSubmit(&reads[next], input_fd, buffers[next], (size_t)next_count * width,
+                         (off_t)((size_t)next_start * width), 0);
+            }
+        }
+
+#ifdef HAVE_MPI
+        if (opts->backend == OGT_BACKEND_MPI) MPI_Bcast(&status, 1, MPI_INT, 0, getMPICommunicator());
+#endif
+        if (status != 0) break;
+
+        OGTSortStats run_stats;
+        unsigned long long trace_run = traceNow();
+        if (rank == 0) swapKeyBytes(buffers[b], (size_t)count, opts->key);
+        if (sortKeys(buffers[b], count, opts->key, opts->backend, opts->num_threads,
+                     opts->ascending, &run_stats) != 0) {
+            status = -1;
+            break;
+        }
+        if (rank == 0) swapKeyBytes(buffers[b], (size_t)count, opts->key);
+        traceSpan("run-sort", trace_run, count);
+        accumulateSortStats(&stats->sort_stats, &run_stats);
+
+        if (rank == 0) {
+            ioSubmit(&writes[b], run_fd, buffers[b], (size_t)count * width, (off_t)((size_t)start * width), 1);
+        }
+    }
+
+    if (rank == 0) {
+        for (int b = 0; b < 3; b++) {
+            ioWait(&reads[b], io);      // chỉ còn lần đọc trước dang dở khi đã lỗi
+            if (ioWait(&writes[b], io) < 0) status = -1;
+            ogtFree(buffers[b]);
+        }
+    }
+#ifdef HAVE_MPI
+    if (opts->backend == OGT_BACKEND_MPI) MPI_Bcast(&status, 1, MPI_INT, 0, getMPICommunicator());
+#endif
+    return status;
+}
+
+// ========== TRỘN K-CHIỀU ==========
+
+// Một run đang trộn: hai bộ đệm, một đang đọc, một đọc trước
+typedef struct {
+    char* buffer[2];
+    size_t count[2];
+    int current;
+    size_t pos;
+    long long next;             // phần tử kế tiếp chưa yêu cầu đọc
+    long long end;
+    IORequest request;
+} RunStream;
+
+// Đầu ra: điền một bộ đệm trong khi bộ đệm kia đang ghi
+typedef struct {
+    char* buffer[2];
+    size_t capacity;
+    size_t count;
+    int current;
+    long long offset;           // vị trí phần tử của bộ đệm hiện tại
+    IORequest request[2];
+} OutputStream;
+
+typedef struct {
+    int64_t value;
+    int stream;
+} HeapEntry;
+
+static int64_t keyAt(const char* buffer, size_t index, OGTKeyType key) {
+    if (key == OGT_KEY_INT64) {
+        int64_t value;
+        memcpy(&value, buffer + index * sizeof(int64_t), sizeof(value));
+        return value;
+    }
+    int32_t value;
+    memcpy(&value, buffer + index * sizeof(int32_t), sizeof(value));
+    return value;
+}
+
+static void streamRequest(RunStream* stream, int b, int fd, size_t buffer_elems, size_t width) {
+    long long count = stream->end - stream->next;
+    if (count > (long long)buffer_elems) count = (long long)buffer_elems;
+    stream->count[b] = (size_t)count;
+    if (count > 0) {
+        ioSubmit(&stream->request, fd, stream->buffer[b], (size_t)count * width,
+                 (off_t)((size_t)stream->next * width), 0);
+    }
+    stream->next += count;
+}
+
+// Chờ bộ đệm đọc trước, đổi sang nó và yêu cầu đọc tiếp; trả về 0 nếu hết run, -1 nếu lỗi
+static int streamAdvance(RunStream* stream, int fd, size_t buffer_elems, OGTKeyType key, IOStats* io) {
+    size_t width = keyTypeSize(key);
+    int b = 1 - stream->current;
+    if (stream->count[b] == 0) return 0;
+    if (ioWait(&stream->request, io) != (ssize_t)(stream->count[b] * width)) return -1;
+    swapKeyBytes(stream->buffer[b], stream->count[b], key);
+
+    stream->current = b;
+    stream->pos = 0;
+    streamRequest(stream, 1 - b, fd, buffer_elems, width);
+    return 1;
+}
+
+static int outputFlush(OutputStream* out, int fd, OGTKeyType key, IOStats* io) {
+    if (out->count == 0) return 0;
+    size_t width = keyTypeSize(key);
+    int b = out->current;
+    swapKeyBytes(out->buffer[b], out->count, key);
+    ioSubmit(&out->request[b], fd, out->buffer[b], out->count * width, (off_t)((size_t)out->offset * width), 1);
+    out->offset += (long long)out->count;
+    out->count = 0;
+    out->current = 1 - b;
+    // Bộ đệm kế tiếp phải ghi xong trước khi điền lại
+    return ioWait(&out->request[out->current], io) < 0 ? -1 : 0;
+}
+
+static int heapBefore(const HeapEntry* a, const HeapEntry* b, int ascending) {
+    if (a->value != b->value) return ascending ? a->value < b->value : a->value > b->value;
+    return a->stream < b->stream;
+}
+
+static void heapSiftDown(HeapEntry heap[], int size, int i, int ascending) {
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= size) return;
+        if (child + 1 < size && heapBefore(&heap[child + 1], &heap[child], ascending)) child++;
+        if (!heapBefore(&heap[child], &heap[i], ascending)) return;
+        HeapEntry tmp = heap[i];
+        heap[i] = heap[child];
+        heap[child] = tmp;
+        i = child;
+    }
+}
+
+/**
+ * Trộn runs[0..k) của in_fd thành một run ở cùng vị trí trong out_fd
+ * streams/heap/out đã được cấp phát bộ đệm cho ít nhất k luồng dữ liệu
+ * @return 0 nếu thành công, -1 nếu lỗi I/O
+ */
+static int mergeRuns(int in_fd, int out_fd, const RunInfo runs[], int k, size_t buffer_elems,
+                     RunStream streams[], HeapEntry heap[], OutputStream* out,
+                     const OGTExternalSortOptions* opts, IOStats* io) {
+    size_t width = keyTypeSize(opts->key);
+    int heap_size = 0;
+    int status = 0;
+
+    out->offset = runs[0].start;
+    out->count = 0;
+
+    for (int s = 0; s < k; s++) {
+        RunStream* stream = &streams[s];
+        stream->next = runs[s].start;
+        stream->end = runs[s].start + runs[s].count;
+        stream->current = 1;
+        stream->count[0] = stream->count[1] = 0;
+        stream->request.active = 0;
+        streamRequest(stream, 0, in_fd, buffer_elems, width);
+    }
+    for (int s = 0; s < k; s++) {
+        int advanced = streamAdvance(&streams[s], in_fd, buffer_elems, opts->key, io);
+        if (advanced < 0) status = -1;
+        if (advanced <= 0) continue;
+        heap[heap_size].value = keyAt(streams[s].buffer[streams[s].current], 0, opts->key);
+        heap[heap_size].stream = s;
+        heap_size++;
+    }
+    for (int i = heap_size / 2 - 1; i >= 0; i--) heapSiftDown(heap, heap_size, i, opts->ascending);
+
+    unsigned long long trace_merge = traceNow();
+    while (heap_size > 0 && status == 0) {
+        RunStream* stream = &streams[heap[0].stream];
+        memcpy(out->buffer[out->current] + out->count * width,
+               stream->buffer[stream->current] + stream->pos * width, width);
+        if (++out->count == out->capacity && outputFlush(out, out_fd, opts->key, io) != 0) status = -1;
+
+        if (++stream->pos == stream->count[stream->current]) {
+            int advanced = streamAdvance(stream, in_fd, buffer_elems, opts->key, io);
+            if (advanced < 0) status = -1;
+            if (advanced <= 0) {
+                heap[0] = heap[--heap_size];
+                heapSiftDown(heap, heap_size, 0, opts->ascending);
+                continue;
+            }
+        }
+        heap[0].value = keyAt(stream->buffer[stream->current], stream->pos, opts->key);
+        heapSiftDown(heap, heap_size, 0, opts->ascending);
+    }
+    traceSpan("k-way-merge", trace_merge, runs[k - 1].start + runs[k - 1].count - runs[0].start);
+
+    if (status == 0 && outputFlush(out, out_fd, opts->key, io) != 0) status = -1;
+    for (int b = 0; b < 2; b++) {
+        if (ioWait(&out->request[b], io) < 0) status = -1;
+    }
+    for (int s = 0; s < k; s++) ioWait(&streams[s].request, io);
+    return status;
+}
+
+/**
+ * Trộn mọi run vào output_fd, nhiều lượt qua các file tạm nếu số run vượt fan-in
+ * @return 0 nếu thành công, -1 nếu lỗi
+ */
+static int mergeAllRuns(int run_fd, int output_fd, RunInfo runs[], int num_runs, size_t budget,
+                        const OGTExternalSortOptions* opts, IOStats* io, OGTExternalSortStats* stats) {
+    size_t width = keyTypeSize(opts->key);
+
+    // Fan-in lớn nhất sao cho mỗi luồng dữ liệu (2 bộ đệm mỗi run + 2 bộ đệm ra) có đủ bộ đệm tối thiểu
+    int max_fanin = (int)(budget / (2 * OGT_EXTERNAL_MIN_BUFFER)) - 1;
+    if (max_fanin < 2) max_fanin = 2;
+    int fanin = num_runs < max_fanin ? num_runs : max_fanin;
+    if (fanin < 1) fanin = 1;
+    // Bảng run, luồng và heap cũng tính vào ngân sách
+    size_t overhead = (size_t)num_runs * sizeof(RunInfo) + (size_t)fanin * (sizeof(RunStream) + sizeof(HeapEntry));
+    size_t available = budget > overhead ? budget - overhead : 0;
+    size_t buffer_elems = available / ((size_t)(2 * fanin + 2) * width);
+    if (buffer_elems < 1) buffer_elems = 1;
+    stats->fanin = fanin;
+    stats->merge_buffer_bytes = buffer_elems * width;
+
+    RunStream* streams = (RunStream*)ogtCalloc(fanin, sizeof(RunStream));
+    HeapEntry* heap = (HeapEntry*)ogtMalloc(fanin * sizeof(HeapEntry));
+    OutputStream out;
+    memset(&out, 0, sizeof(out));
+    out.capacity = buffer_elems;
+    int status = streams && heap ? 0 : -1;
+    for (int s = 0; s < fanin && status == 0; s++) {
+        for (int b = 0; b < 2; b++) {
+            streams[s].buffer[b] = (char*)ogtMalloc(buffer_elems * width);
+            if (!streams[s].buffer[b]) status = -1;
+        }
+    }
+    for (int b = 0; b < 2 && status == 0; b++) {
+        out.buffer[b] = (char*)ogtMalloc(buffer_elems * width);
+        if (!out.buffer[b]) status = -1;
+    }
+    if (status != 0) printf(RED "Lỗi: Không đủ bộ nhớ cho bộ đệm trộn\n" RESET);
+
+    int in_fd = run_fd;         // hàm này sở hữu run_fd từ đây
+    int spare_fd = -1;
+    while (status == 0) {
+        int final_pass = num_runs <= fanin;
+        int out_fd = output_fd;
+        if (!final_pass) {
+            if (spare_fd < 0 && (spare_fd = openTempFile(opts->temp_dir)) < 0) {
+                printf(RED "Lỗi: Không tạo được file tạm\n" RESET);
+                status = -1;
+                break;
+            }
+            out_fd = spare_fd;
+        }
+
+        // Mỗi nhóm fan-in run liên tiếp thành một run ở cùng vị trí
+        int merged = 0;
+        for (int first = 0; first < num_runs && status == 0; first += fanin) {
+            int k = num_runs - first < fanin ? num_runs - first : fanin;
+            status = mergeRuns(in_fd, out_fd, &runs[first], k, buffer_elems, streams, heap, &out, opts, io);
+            runs[merged].start = runs[first].start;
+            runs[merged].count = runs[first + k - 1].start + runs[first + k - 1].count - runs[first].start;
+            merged++;
+        }
+        stats->merge_passes++;
+        num_runs = merged;
+        if (final_pass) break;
+
+        // File vừa ghi thành đầu vào của lượt sau; lượt sau ghi đè toàn bộ file cũ nên dùng lại được
+        int used = in_fd;
+        in_fd = spare_fd;
+        spare_fd = used;
+    }
+
+    close(in_fd);
+    if (spare_fd >= 0) close(spare_fd);
+
+    for (int s = 0; streams && s < fanin; s++) {
+        ogtFree(streams[s].buffer[0]);
+        ogtFree(streams[s].buffer[1]);
+    }
+    ogtFree(out.buffer[0]);
+    ogtFree(out.buffer[1]);
+    ogtFree(streams);
+    ogtFree(heap);
+    return status;
+}
+
+// ========== API ==========
+
+// Bộ nhớ lúc sinh run tính theo số lần kích thước run: 3 bộ đệm I/O + vùng tạm của backend
+static int runMemoryFactor(const OGTExternalSortOptions* opts) {
+    if (opts->key == OGT_KEY_INT64) return opts->backend == OGT_BACKEND_SEQ ? 3 : 4;
+    switch (opts->backend) {
+        case OGT_BACKEND_SEQ:
+            return 3;
+        case OGT_BACKEND_OPENMP:
+            return 5;       // các khối copy ra vùng tạm rồi trộn vào mảng kết quả
+        case OGT_BACKEND_MPI:
+            return 5;       // root giữ thêm khối cục bộ và bộ đệm nhận khi gom kết quả
+        default:
+            return 4;
+    }
+}
+
+void defaultExternalSortOptions(OGTExternalSortOptions* opts) {
+    memset(opts, 0, sizeof(*opts));
+    opts->memory_budget = OGT_EXTERNAL_DEFAULT_BUDGET;
+    opts->temp_dir = NULL;
+    opts->backend = OGT_BACKEND_OPENMP;
+    opts->num_threads = omp_get_max_threads();
+    opts->ascending = 1;
+    opts->key = OGT_KEY_INT32;
+}
+
+/**
+ * Sắp xếp ngoài file khóa nhị phân little-endian
+ * @param input: File đầu vào
+ * @param output: File đầu ra; NULL hoặc trùng input để ghi đè đầu vào (sau khi sinh run xong)
+ * @param opts: Ngân sách bộ nhớ, thư mục tạm, backend, kiểu khóa; NULL để dùng mặc định
+ * @param stats: Thống kê (có thể NULL, hợp lệ tại rank 0)
+ * @return 0 nếu thành công, -1 nếu lỗi (giống nhau trên mọi rank với backend mpi)
+ */
+int externalSortFile(const char* input, const char* output, const OGTExternalSortOptions* opts,
+                     OGTExternalSortStats* stats) {
+    OGTExternalSortOptions defaults;
+    OGTExternalSortStats local;
+    if (!opts) {
+        defaultExternalSortOptions(&defaults);
+        opts = &defaults;
+    }
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    resetSortStats(&stats->sort_stats);
+
+    if (opts->key < 0 || opts->key >= OGT_KEY_COUNT || opts->backend < 0 || opts->backend >= OGT_BACKEND_COUNT) {
+        printf(RED "Lỗi: Kiểu khóa hoặc backend không hợp lệ\n" RESET);
+        return -1;
+    }
+    if (opts->key == OGT_KEY_INT64 && opts->backend == OGT_BACKEND_MPI) {
+        printf(RED "Lỗi: Khóa int64 chưa hỗ trợ backend mpi\n" RESET);
+        return -1;
+    }
+
+    int rank = 0;
+#ifdef HAVE_MPI
+    if (opts->backend == OGT_BACKEND_MPI) MPI_Comm_rank(getMPICommunicator(), &rank);
+#endif
+
+    size_t width = keyTypeSize(opts->key);
+    size_t budget = opts->memory_budget > 0 ? opts->memory_budget : OGT_EXTERNAL_DEFAULT_BUDGET;
+
+    size_t run_budget = budget > 2 * OGT_EXTERNAL_RESERVE ? budget - OGT_EXTERNAL_RESERVE : budget;
+    long long run_elems = (long long)(run_budget / ((size_t)runMemoryFactor(opts) * width));
+    if (run_elems > INT_MAX) run_elems = INT_MAX;
+    if (run_elems < 1) run_elems = 1;
+
+    OGTMemScope memory;
+    memScopeBegin(&memory);
+    double t_begin = getCurrentTime();
+    IOStats io = { 0.0, 0, 0 };
+    int input_fd = -1, run_fd = -1;
+    long long n = 0;
+    int status = 0;
+
+    if (rank == 0) {
+        struct stat st;
+        input_fd = open(input, O_RDONLY);
+        if (input_fd < 0 || fstat(input_fd, &st) != 0) {
+            printf(RED "Lỗi: Không mở được file %s\n" RESET, input);
+            status = -1;
+        } else if (st.st_size % (off_t)width != 0) {
+            printf(RED "Lỗi: Kích thước file %s không phải bội số của %zu byte\n" RESET, input, width);
+            status = -1;
+        } else if ((run_fd = openTempFile(opts->temp_dir)) < 0) {
+            printf(RED "Lỗi: Không tạo được file tạm\n" RESET);
+            status = -1;
+        } else {
+            n = (long long)(st.st_size / (off_t)width);
+        }
+    }
+#ifdef HAVE_MPI
+    if (opts->backend == OGT_BACKEND_MPI) {
+        MPI_Bcast(&status, 1, MPI_INT, 0, getMPICommunicator());
+        MPI_Bcast(&n, 1, MPI_LONG_LONG, 0, getMPICommunicator());
+    }
+#endif
+
+    stats->n = n;
+    stats->runs = n > 0 ? (int)((n + run_elems - 1) / run_elems) : 0;
+    stats->run_bytes = (size_t)run_elems * width;
+
+    if (status == 0 && n > 0) {
+        status = generateRuns(input_fd, run_fd, n, run_elems, opts, rank, &io, stats);
+        if (status != 0 && rank == 0) printf(RED "Lỗi: Sinh run thất bại\n" RESET);
+    }
+    if (input_fd >= 0) close(input_fd);
+    double t_runs = getCurrentTime();
+    stats->run_time = t_runs - t_begin;
+
+    // Trộn chỉ chạy trên rank 0
+    if (rank == 0 && status == 0) {
+        int output_fd = open(output ? output : input, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (output_fd < 0) {
+            printf(RED "Lỗi: Không tạo được file %s\n" RESET, output ? output : input);
+            status = -1;
+        } else if (n > 0) {
+            RunInfo* runs = (RunInfo*)ogtMalloc((size_t)stats->runs * sizeof(RunInfo));
+            if (!runs) {
+                status = -1;
+            } else {
+                for (int r = 0; r < stats->runs; r++) {
+                    runs[r].start = (long long)r * run_elems;
+                    runs[r].count = n - runs[r].start < run_elems ? n - runs[r].start : run_elems;
+                }
+                status = mergeAllRuns(run_fd, output_fd, runs, stats->runs, budget, opts, &io, stats);
+                run_fd = -1;
+                ogtFree(runs);
+            }
+            if (status == 0 && fsync(output_fd) != 0) status = -1;
+            if (status != 0) printf(RED "Lỗi: Trộn run thất bại\n" RESET);
+        }
+        if (output_fd >= 0) close(output_fd);
+    }
+    if (run_fd >= 0) close(run_fd);
+#ifdef HAVE_MPI
+    if (opts->backend == OGT_BACKEND_MPI) MPI_Bcast(&status, 1, MPI_INT, 0, getMPICommunicator());
+#endif
+
+    double t_end = getCurrentTime();
+    stats->merge_time = t_end - t_runs;
+    stats->total_time = t_end - t_begin;
+    stats->io_wait_time = io.wait_time;
+    stats->bytes_read = io.bytes_read;
+    stats->bytes_written = io.bytes_written;
+    memScopeEnd(&memory, &stats->memory);
+    return status;
+}
@@ -0,0 +1,543 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Sắp xếp file khóa nhị phân (int32/int64 little-endian) trực tiếp trên vùng mmap
+ *
+ * Không có read/write vào bộ đệm riêng: sắp xếp tại chỗ ghi thẳng vào page cache của file
+ * (MAP_SHARED), còn khi có file đầu ra thì đầu vào được map chỉ đọc và copy một lần
+ * sang vùng map của file đầu ra rồi sắp xếp ở đó. int32 chạy qua đúng các backend
+ * in-memory; int64 dùng sắp xếp chèn theo khối (tuần tự, OpenMP hoặc Pthreads) rồi trộn cặp đôi
+ * theo cây như merge_adjacent_runs (các kernel trộn của thư viện chỉ nhận int).
+ *
+ * Với MPI chỉ rank 0 mở file; các rank khác nhận phân đoạn qua các hàm MPI như thường.
+ */
+
+static const char* key_type_names[OGT_KEY_COUNT] = { "int32", "int64" };
+
+const char* keyTypeName(OGTKeyType key) {
+    if (key < 0 || key >= OGT_KEY_COUNT) return "?";
+    return key_type_names[key];
+}
+
+int parseKeyType(const char* name) {
+    for (int k = 0; k < OGT_KEY_COUNT; k++) {
+        if (strcmp(name, key_type_names[k]) == 0) return k;
+    }
+    return -1;
+}
+
+size_t keyTypeSize(OGTKeyType key) {
+    return key == OGT_KEY_INT64 ? sizeof(int64_t) : sizeof(int32_t);
+}
+
+// File luôn là little-endian; máy big-endian đảo byte khi vào và ra
+void swapKeyBytes(void* data, size_t n, OGTKeyType key) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    if (key == OGT_KEY_INT64) {
+        uint64_t* keys = (uint64_t*)data;
+        for (size_t i = 0; i < n; i++) keys[i] = __builtin_bswap64(keys[i]);
+    } else {
+        uint32_t* keys = (uint32_t*)data;
+        for (size_t i = 0; i < n; i++) keys[i] = __builtin_bswap32(keys[i]);
+    }
+#else
+    (void)data;
+    (void)n;
+    (void)key;
+#endif
+}
+
+// ========== SẮP XẾP INT64 ==========
+
+static void insertionSortInt64(int64_t a[], long n, int ascending) {
+    for (long i = 1; i < n; i++) {
+        int64_t key = a[i];
+        long j = i - 1;
+        if (ascending) {
+            while (j >= 0 && a[j] > key) {
+                a[j + 1] = a[j];
+                j--;
+            }
+        } else {
+            while (j >= 0 && a[j] < key) {
+                a[j + 1] = a[j];
+                j--;
+            }
+        }
+        a[j + 1] = key;
+    }
+}
+
+typedef struct {
+    int64_t* data;
+    long count;
+    int ascending;
+} Int64Chunk;
+
+static void* sortInt64Chunk(void* arg) {
+    Int64Chunk* chunk = (Int64Chunk*)arg;
+    unsigned long long trace_sort = traceNow();
+    insertionSortInt64(chunk->data, chunk->count, chunk->ascending);
+    traceSpan("chunk-sort", trace_sort, chunk->count);
+    return NULL;
+}
+
+// Trộn hai run đã sắp xếp vào dst; bằng nhau lấy run trái trước (ổn định)
+static void mergeInt64Pair(const int64_t* left, long n1, const int64_t* right, long n2, int64_t* dst,
+                           int ascending) {
+    long i = 0, j = 0, k = 0;
+    while (i < n1 && j < n2) {
+        if (ascending ? left[i] <= right[j] : left[i] >= right[j]) {
+            dst[k++] = left[i++];
+        } else {
+            dst[k++] = right[j++];
+        }
+    }
+    if (i < n1) memcpy(dst + k, left + i, (size_t)(n1 - i) * sizeof(int64_t));
+    if (j < n2) memcpy(dst + k, right + j, (size_t)(n2 - j) * sizeof(int64_t));
+}
+
+/**
+ * Trộn cặp đôi các run liền kề [bounds[r], bounds[r + 1]) qua lại giữa a và scratch, log2 k lượt
+ * @param bounds: num_runs + 1 biên, bị ghi đè
+ * @return Số lượt trộn; lẻ nghĩa là kết quả nằm trong scratch
+ */
+static int mergeInt64Runs(int64_t a[], int64_t scratch[], long bounds[], int num_runs, long n, int ascending) {
+    int64_t* src = a;
+    int64_t* dst = scratch;
+    int count = num_runs;
+    int passes = 0;
+
+    while (count > 1) {
+        int next = 0;
+        for (int r = 0; r < count; r += 2) {
+            if (r + 1 < count) {
+                long left = bounds[r], mid = bounds[r + 1], right = bounds[r + 2];
+                mergeInt64Pair(src + left, mid - left, src + mid, right - mid, dst + left, ascending);
+            } else {
+                memcpy(dst + bounds[r], src + bounds[r], (size_t)(bounds[r + 1] - bounds[r]) * sizeof(int64_t));
+            }
+            bounds[next++] = bounds[r];
+        }
+        bounds[next] = n;
+        count = next;
+        int64_t* swap = src;
+        src = dst;
+        dst = swap;
+        passes++;
+    }
+    return passes;
+}
+
+/**
+ * Sắp xếp mảng int64: chia num_chunks khối, sắp xếp song song, trộn cặp đôi qua vùng tạm
+ * @param backend: OGT_BACKEND_OPENMP hoặc OGT_BACKEND_PTHREADS để sắp xếp khối song song
+ * @return 0 nếu thành công, -1 nếu không cấp phát được (đã in thông báo)
+ */
+static int sortInt64(int64_t a[], long n, OGTBackend backend, int num_threads, int ascending,
+                     OGTSortStats* stats) {
+    int num_chunks = backend == OGT_BACKEND_SEQ || n < ogtTuning()->seq_cutoff ? 1 : num_threads;
+    if (num_chunks < 1) num_chunks = 1;
+    if (num_chunks > n) num_chunks = (int)n;
+    stats->num_threads = num_chunks;
+    double t_begin = getCurrentTime();
+
+    Int64Chunk* chunks = (Int64Chunk*)ogtMalloc(num_chunks * sizeof(Int64Chunk));
+    long* bounds = (long*)ogtMalloc((num_chunks + 1) * sizeof(long));
+    int64_t* scratch = num_chunks > 1 ? (int64_t*)ogtMalloc(n * sizeof(int64_t)) : NULL;
+    if (!chunks || !bounds || (num_chunks > 1 && !scratch)) {
+        printf(RED "Lỗi: Không đủ bộ nhớ để trộn %ld khóa int64\n" RESET, n);
+        ogtFree(chunks);
+        ogtFree(bounds);
+        ogtFree(scratch);
+        return -1;
+    }
+
+    long base = n / num_chunks, remainder = n % num_chunks, start = 0;
+    for (int c = 0; c < num_chunks; c++) {
+        chunks[c].data = a + start;
+        chunks[c].count = base + (c < remainder ? 1 : 0);
+        chunks[c].ascending = ascending;
+        bounds[c] = start;
+        start += chunks[c].count;
+    }
+    bounds[num_chunks] = n;
+    double t_split = getCurrentTime();
+
+    // Số khối theo num_threads, số luồng do governor cấp
+    int team = num_chunks > 1 ? governorAcquire(num_chunks) : 1;
+    stats->num_threads = team;
+    if (num_chunks == 1) {
+        sortInt64Chunk(&chunks[0]);
+    } else if (backend == OGT_BACKEND_PTHREADS) {
+        // Mỗi đợt tối đa team luồng, một khối mỗi luồng
+        pthread_t* threads = (pthread_t*)ogtMalloc(team * sizeof(pthread_t));
+        for (int first = 0; first < num_chunks; first += team) {
+            int wave = num_chunks - first < team ? num_chunks - first : team;
+            int spawned = 0;
+            for (; threads && spawned < wave; spawned++) {
+                if (pthread_create(&threads[spawned], NULL, sortInt64Chunk, &chunks[first + spawned]) != 0) break;
+            }
+            // Khối không tạo được luồng thì sắp xếp trên luồng gọi
+            for (int c = spawned; c < wave; c++) sortInt64Chunk(&chunks[first + c]);
+            for (int c = 0; c < spawned; c++) pthread_join(threads[c], NULL);
+        }
+        ogtFree(threads);
+    } else {
+        #pragma omp parallel for num_threads(team) schedule(static, 1)
+        for (int c = 0; c < num_chunks; c++) {
+            sortInt64Chunk(&chunks[c]);
+        }
+    }
+    if (num_chunks > 1) governorRelease(team);
+    double t_sort = getCurrentTime();
+
+    int passes = 0;
+    if (num_chunks > 1) {
+        unsigned long long trace_merge = traceNow();
+        passes = mergeInt64Runs(a, scratch, bounds, num_chunks, n, ascending);
+        traceSpan("merge", trace_merge, n);
+        stats->phase_bytes[OGT_PHASE_MERGE] = 2.0 * passes * n * sizeof(int64_t);
+    }
+    double t_merge = getCurrentTime();
+
+    if (passes % 2 == 1) {
+        memcpy(a, scratch, n * sizeof(int64_t));
+        stats->phase_bytes[OGT_PHASE_COPY_BACK] = 2.0 * n * sizeof(int64_t);
+    }
+    double t_copy_back = getCurrentTime();
+
+    ogtFree(chunks);
+    ogtFree(bounds);
+    ogtFree(scratch);
+
+    stats->phase_time[OGT_PHASE_SPLIT] = t_split - t_begin;
+    stats->phase_time[OGT_PHASE_SORT] = t_sort - t_split;
+    stats->phase_time[OGT_PHASE_MERGE] = t_merge - t_sort;
+    stats->phase_time[OGT_PHASE_COPY_BACK] = t_copy_back - t_merge;
+    stats->total_time = t_copy_back - t_begin;
+    return 0;
+}
+
+// ========== MMAP ==========
+
+typedef struct {
+    int fd;
+    void* data;
+    size_t bytes;
+} FileMapping;
+
+static int mapFlags(int flags) {
+    int map_flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (flags & OGT_MMAP_POPULATE) map_flags |= MAP_POPULATE;
+#else
+    (void)flags;
+#endif
+    return map_flags;
+}
+
+// Gợi ý cho kernel sau khi map: đọc trước toàn bộ, huge page nếu được yêu cầu
+static void adviseMapping(void* data, size_t bytes, int flags, int sequential) {
+#ifndef MAP_POPULATE
+    if (flags & OGT_MMAP_POPULATE) madvise(data, bytes, MADV_WILLNEED);
+#endif
+#ifdef MADV_HUGEPAGE
+    if (flags & OGT_MMAP_HUGE_PAGES) madvise(data, bytes, MADV_HUGEPAGE);
+#endif
+    if (sequential) madvise(data, bytes, MADV_SEQUENTIAL);
+}
+
+static void unmapFile(FileMapping* mapping) {
+    if (mapping->data && mapping->bytes > 0) munmap(mapping->data, mapping->bytes);
+    if (mapping->fd >= 0) close(mapping->fd);
+    mapping->data = NULL;
+    mapping->fd = -1;
+}
+
+/**
+ * Map file khóa; writable = 1 để sắp xếp tại chỗ
+ * @return 0 nếu thành công, -1 nếu lỗi (đã in thông báo)
+ */
+static int mapInputFile(const char* path, OGTKeyType key, int writable, int flags, FileMapping* mapping) {
+    mapping->fd = open(path, writable ? O_RDWR : O_RDONLY);
+    mapping->data = NULL;
+    mapping->bytes = 0;
+    if (mapping->fd < 0) {
+        printf(RED "Lỗi: Không mở được file %s: %s\n" RESET, path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(mapping->fd, &st) != 0) {
+        printf(RED "Lỗi: Không đọc được kích thước file %s: %s\n" RESET, path, strerror(errno));
+        unmapFile(mapping);
+        return -1;
+    }
+    if (st.st_size % (off_t)keyTypeSize(key) != 0) {
+        printf(RED "Lỗi: Kích thước file %s không phải bội số của %zu byte\n" RESET, path, keyTypeSize(key));
+        unmapFile(mapping);
+        return -1;
+    }
+    mapping->bytes = (size_t)st.st_size;
+    if (mapping->bytes == 0) return 0;
+
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    int map_flags = writable ? mapFlags(flags) : (mapFlags(flags) & ~MAP_SHARED) | MAP_PRIVATE;
+    mapping->data = mmap(NULL, mapping->bytes, prot, map_flags, mapping->fd, 0);
+    if (mapping->data == MAP_FAILED) {
+        mapping->data = NULL;
+        printf(RED "Lỗi: Không mmap được file %s: %s\n" RESET, path, strerror(errno));
+        unmapFile(mapping);
+        return -1;
+    }
+    adviseMapping(mapping->data, mapping->bytes, flags, !writable);
+    return 0;
+}
+
+// Tạo file đầu ra cùng kích thước và map đọc/ghi
+static int mapOutputFile(const char* path, size_t bytes, int flags, FileMapping* mapping) {
+    mapping->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    mapping->data = NULL;
+    mapping->bytes = bytes;
+    if (mapping->fd < 0 || ftruncate(mapping->fd, (off_t)bytes) != 0) {
+        printf(RED "Lỗi: Không tạo được file %s: %s\n" RESET, path, strerror(errno));
+        unmapFile(mapping);
+        return -1;
+    }
+    if (bytes == 0) return 0;
+
+    mapping->data = mmap(NULL, bytes, PROT_READ | PROT_WRITE, mapFlags(flags), mapping->fd, 0);
+    if (mapping->data == MAP_FAILED) {
+        mapping->data = NULL;
+        printf(RED "Lỗi: Không mmap được file %s: %s\n" RESET, path, strerror(errno));
+        unmapFile(mapping);
+        return -1;
+    }
+    adviseMapping(mapping->data, bytes, flags, 0);
+    return 0;
+}
+
+/**
+ * Chuẩn bị vùng dữ liệu cần sắp xếp (chỉ rank 0)
+ * @return 0 nếu thành công, -1 nếu lỗi
+ */
+static int prepareFileSort(const char* input, const char* output, OGTKeyType key, int flags,
+                           FileMapping* target, OGTFileSortStats* stats) {
+    int in_place = !output || strcmp(output, input) == 0;
+    size_t width = keyTypeSize(key);
+
+    double t_begin = getCurrentTime();
+    if (in_place) {
+        if (mapInputFile(input, key, 1, flags, target) != 0) return -1;
+        stats->map_time = getCurrentTime() - t_begin;
+        swapKeyBytes(target->data, target->bytes / width, key);
+        stats->n = (long long)(target->bytes / width);
+        return 0;
+    }
+
+    FileMapping source;
+    if (mapInputFile(input, key, 0, flags, &source) != 0) return -1;
+    if (mapOutputFile(output, source.bytes, flags, target) != 0) {
+        unmapFile(&source);
+        return -1;
+    }
+    double t_mapped = getCurrentTime();
+    stats->map_time = t_mapped - t_begin;
+
+    // Bản copy duy nhất: page cache đầu vào -> page cache đầu ra
+    unsigned long long trace_copy = traceNow();
+    if (source.bytes > 0) memcpy(target->data, source.data, source.bytes);
+    traceSpan("file-copy", trace_copy, (long long)(source.bytes / width));
+    unmapFile(&source);
+    swapKeyBytes(target->data, target->bytes / width, key);
+    stats->copy_time = getCurrentTime() - t_mapped;
+    stats->n = (long long)(target->bytes / width);
+    return 0;
+}
+
+// Ghi xuống đĩa và bỏ map (chỉ rank 0)
+static int finishFileSort(FileMapping* target, OGTKeyType key, OGTFileSortStats* stats) {
+    int result = 0;
+    double t_sync = getCurrentTime();
+    if (target->data) {
+        swapKeyBytes(target->data, target->bytes / keyTypeSize(key), key);
+        if (msync(target->data, target->bytes, MS_SYNC) != 0) {
+            printf(RED "Lỗi: msync thất bại: %s\n" RESET, strerror(errno));
+            result = -1;
+        }
+    }
+    unmapFile(target);
+    stats->sync_time = getCurrentTime() - t_sync;
+    return result;
+}
+
+static void sortInt32(int a[], int n, OGTBackend backend, int num_threads, int ascending,
+                      OGTSortStats* stats) {
+    switch (backend) {
+        case OGT_BACKEND_SEQ:
+            insertionSortStats(a, n, ascending, stats);
+            break;
+        case OGT_BACKEND_OPENMP:
+            parallelInsertionSortStats(a, n, num_threads, ascending, stats);
+            break;
+        case OGT_BACKEND_PTHREADS:
+            parallelInsertionSortPthreadsStats(a, n, num_threads, ascending, stats);
+            break;
+        case OGT_BACKEND_MPI:
+        default:
+            parallelInsertionSortMPIStats(a, n, ascending, stats);
+            break;
+    }
+}
+
+/**
+ * Sắp xếp một vùng khóa đã ở thứ tự byte của máy bằng backend đã chọn
+ * @param keys: Mảng int32/int64; với mpi chỉ cần hợp lệ tại rank 0
+ * @param backend: OGT_BACKEND_MPI là hàm tập thể trên getMPICommunicator()
+ * @param stats: Thời gian theo pha và bộ nhớ (không được NULL)
+ * @return 0 nếu thành công, -1 nếu tham số không hợp lệ, n vượt giới hạn của backend hoặc hết bộ nhớ
+ *         (đã in nguyên nhân)
+ */
+int sortKeys(void* keys, long long n, OGTKeyType key, OGTBackend backend,
+             int num_threads, int ascending, OGTSortStats* stats) {
+    resetSortStats(stats);
+    if (key < 0 || key >= OGT_KEY_COUNT || backend < 0 || backend >= OGT_BACKEND_COUNT || n < 0) {
+        printf(RED "Lỗi: Kiểu khóa, backend hoặc số khóa không hợp lệ\n" RESET);
+        return -1;
+    }
+    if (key == OGT_KEY_INT64) {
+        if (backend == OGT_BACKEND_MPI) {
+            printf(RED "Lỗi: Khóa int64 chưa hỗ trợ backend mpi\n" RESET);
+            return -1;
+        }
+        if (n > LONG_MAX) {
+            printf(RED "Lỗi: %lld khóa vượt quá giới hạn long\n" RESET, n);
+            return -1;
+        }
+        OGTMemScope memory;
+        memScopeBegin(&memory);
+        int status = sortInt64((int64_t*)keys, (long)n, backend, num_threads, ascending, stats);
+        memScopeEnd(&memory, &stats->memory);
+        return status;
+    }
+    if (n > INT_MAX) {
+        printf(RED "Lỗi: %lld khóa vượt quá giới hạn int\n" RESET, n);
+        return -1;
+    }
+    sortInt32((int*)keys, (int)n, backend, num_threads, ascending, stats);
+    return 0;
+}
+
+/**
+ * Sắp xếp file khóa nhị phân bằng mmap
+ * @param input: File đầu vào (little-endian)
+ * @param output: File đầu ra; NULL hoặc trùng input để sắp xếp tại chỗ
+ * @param key: OGT_KEY_INT32 (mọi backend) hoặc OGT_KEY_INT64 (seq, openmp, pthreads)
+ * @param backend: Backend sắp xếp; OGT_BACKEND_MPI là hàm tập thể trên getMPICommunicator(),
+ *                 chỉ input/output của rank 0 được dùng
+ * @param num_threads: Số luồng cho openmp/pthreads
+ * @param flags: OGT_MMAP_POPULATE, OGT_MMAP_HUGE_PAGES
+ * @param stats: Thời gian map/copy/sort/sync (có thể NULL, hợp lệ tại rank 0)
+ * @return 0 nếu thành công, -1 nếu lỗi (giống nhau trên mọi rank)
+ */
+int sortFile(const char* input, const char* output, OGTKeyType key, OGTBackend backend,
+             int num_threads, int ascending, int flags, OGTFileSortStats* stats) {
+    OGTFileSortStats local;
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    resetSortStats(&stats->sort_stats);
+
+    if (key < 0 || key >= OGT_KEY_COUNT || backend < 0 || backend >= OGT_BACKEND_COUNT) {
+        printf(RED "Lỗi: Kiểu khóa hoặc backend không hợp lệ\n" RESET);
+        return -1;
+    }
+    if (key == OGT_KEY_INT64 && backend == OGT_BACKEND_MPI) {
+        printf(RED "Lỗi: Khóa int64 chưa hỗ trợ backend mpi\n" RESET);
+        return -1;
+    }
+
+    int rank = 0;
+#ifdef HAVE_MPI
+    if (backend == OGT_BACKEND_MPI) MPI_Comm_rank(getMPICommunicator(), &rank);
+#endif
+
+    double t_begin = getCurrentTime();
+    FileMapping target = { -1, NULL, 0 };
+    long long n = 0;
+    int status = 0;
+
+    if (rank == 0) {
+        status = prepareFileSort(input, output, key, flags, &target, stats);
+        n = stats->n;
+        if (status == 0 && key == OGT_KEY_INT32 && n > INT_MAX) {
+            printf(RED "Lỗi: File có %lld khóa, vượt quá giới hạn int\n" RESET, n);
+            unmapFile(&target);
+            status = -1;
+        }
+    }
+
+#ifdef HAVE_MPI
+    if (backend == OGT_BACKEND_MPI) {
+        MPI_Bcast(&status, 1, MPI_INT, 0, getMPICommunicator());
+        MPI_Bcast(&n, 1, MPI_LONG_LONG, 0, getMPICommunicator());
+    }
+#endif
+    if (status != 0) return -1;
+    stats->n = n;
+
+    double t_sort = getCurrentTime();
+    unsigned long long trace_sort = traceNow();
+    status = sortKeys(target.data, n, key, backend, num_threads, ascending, &stats->sort_stats);
+    traceSpan("file-sort", trace_sort, n);
+    stats->sort_time = getCurrentTime() - t_sort;
+
+    if (rank == 0) {
+        if (finishFileSort(&target, key, stats) != 0) status = -1;
+    }
+#ifdef HAVE_MPI
+    if (backend == OGT_BACKEND_MPI) MPI_Bcast(&status, 1, MPI_INT, 0, getMPICommunicator());
+#endif
+
+    stats->total_time = getCurrentTime() - t_begin;
+    return status;
+}
+
+/**
+ * Kiểm tra file khóa đã sắp xếp chưa
+ * @return 1 nếu đã sắp xếp, 0 nếu chưa, -1 nếu không đọc được file
+ */
+int fileIsSorted(const char* path, OGTKeyType key, int ascending) {
+    FileMapping mapping;
+    if (mapInputFile(path, key, 0, 0, &mapping) != 0) return -1;
+
+    size_t n = mapping.bytes / keyTypeSize(key);
+    int sorted = 1;
+    for (size_t i = 1; i < n && sorted; i++) {
+        int64_t prev, next;
+        if (key == OGT_KEY_INT64) {
+            uint64_t raw[2];
+            memcpy(raw, (const uint64_t*)mapping.data + i - 1, sizeof(raw));
+            swapKeyBytes(raw, 2, key);
+            prev = (int64_t)raw[0];
+            next = (int64_t)raw[1];
+        } else {
+            uint32_t raw[2];
+            memcpy(raw, (const uint32_t*)mapping.data + i - 1, sizeof(raw));
+            swapKeyBytes(raw, 2, key);
+            prev = (int32_t)raw[0];
+            next = (int32_t)raw[1];
+        }
+        if (ascending ? next < prev : next > prev) sorted = 0;
+    }
+    unmapFile(&mapping);
+    return sorted;
+}
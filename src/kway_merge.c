@@ -0,0 +1,276 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <limits.h>
+#include <omp.h>
+
+/**
+ * Trộn k-chiều song song các mảng đã sắp xếp của người gọi
+ *
+ * Đầu ra được chia thành các phần bằng nhau theo hạng: với mỗi biên r, chọn đa dãy tìm giá trị
+ * x của phần tử hạng r rồi cắt từng đầu vào tại đó, phần tử bằng x lấy theo thứ tự đầu vào.
+ * Mỗi phần được một luồng trộn độc lập vào đúng vị trí của nó trong out, không cần đồng bộ.
+ *
+ * Thứ tự tổng (giá trị, chỉ số đầu vào, vị trí) làm kết quả ổn định và tất định: phần tử bằng
+ * nhau đi theo thứ tự đầu vào. Trong một phần, k nhỏ dùng quét tuyến tính qua các đầu lát
+ * (nằm gọn trong cache L1), k lớn dùng cây thua (log2 k phép so sánh mỗi phần tử).
+ */
+
+#define OGT_KWAY_LINEAR_MAX 8           // k tối đa cho quét tuyến tính
+#define OGT_KWAY_MIN_PART 16384         // số phần tử tối thiểu mỗi phần song song
+
+// Số phần tử đứng trước giá trị x (nhỏ hơn khi tăng dần, lớn hơn khi giảm dần)
+static int countBefore(const int* a, int n, int x, int ascending) {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ascending ? a[mid] < x : a[mid] > x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Số phần tử đứng trước hoặc bằng x (dùng chung với sortedInsertBatch)
+int sortedCountUpTo(const int a[], int n, int x, int ascending) {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ascending ? a[mid] <= x : a[mid] >= x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Cắt các đầu vào sao cho đúng rank phần tử đầu tiên của thứ tự trộn nằm trước vết cắt
+ * @param split: k vị trí cắt (đầu ra)
+ */
+static void selectSplit(int* const inputs[], const int lengths[], int k, long long rank,
+                        int ascending, int split[]) {
+    // Tìm nhị phân theo khóa thứ tự u (u = x khi tăng dần, u = -x khi giảm dần):
+    // u nhỏ nhất mà số phần tử đứng trước hoặc bằng x vượt rank
+    long long lo = ascending ? INT_MIN : -(long long)INT_MAX;
+    long long hi = ascending ? INT_MAX : -(long long)INT_MIN;
+    while (lo < hi) {
+        long long mid = lo + (hi - lo) / 2;
+        int x = (int)(ascending ? mid : -mid);
+        long long count = 0;
+        for (int i = 0; i < k; i++) count += sortedCountUpTo(inputs[i], lengths[i], x, ascending);
+        if (count > rank) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    int x = (int)(ascending ? lo : -lo);
+    long long need = rank;
+    for (int i = 0; i < k; i++) {
+        split[i] = countBefore(inputs[i], lengths[i], x, ascending);
+        need -= split[i];
+    }
+    // Phần tử bằng x: lấy từ đầu vào chỉ số nhỏ trước (ổn định)
+    for (int i = 0; i < k && need > 0; i++) {
+        int equal = sortedCountUpTo(inputs[i], lengths[i], x, ascending) - split[i];
+        int take = need < equal ? (int)need : equal;
+        split[i] += take;
+        need -= take;
+    }
+}
+
+// Nguồn a đứng trước nguồn b: theo giá trị đầu, bằng nhau thì chỉ số nhỏ trước; nguồn cạn đứng sau
+static inline int sourceBefore(const int* const heads[], const int* const ends[], int a, int b, int ascending) {
+    if (heads[a] == ends[a]) return 0;
+    if (heads[b] == ends[b]) return 1;
+    int va = *heads[a], vb = *heads[b];
+    if (va != vb) return ascending ? va < vb : va > vb;
+    return a < b;
+}
+
+/**
+ * Trộn tuần tự count phần tử từ các lát [heads[i], ends[i]) vào out
+ * @param ids: chỉ số đầu vào gốc của từng lát (ghi vào sources nếu khác NULL)
+ */
+static void mergeSlices(const int* heads[], const int* ends[], int ids[], int k, long long count,
+                        int out[], int sources[], int ascending, int tree[], int winners[]) {
+    if (k == 1) {
+        memcpy(out, heads[0], (size_t)count * sizeof(int));
+        if (sources) {
+            for (long long j = 0; j < count; j++) sources[j] = ids[0];
+        }
+        return;
+    }
+
+    if (k <= OGT_KWAY_LINEAR_MAX) {
+        // Lát cạn bị dời ra (giữ thứ tự còn lại), vòng trong không phải kiểm tra cạn
+        int active = k;
+        for (long long j = 0; j < count; j++) {
+            int best = 0;
+            int best_val = *heads[0];
+            for (int i = 1; i < active; i++) {
+                int v = *heads[i];
+                if (ascending ? v < best_val : v > best_val) {
+                    best_val = v;
+                    best = i;
+                }
+            }
+            out[j] = best_val;
+            if (sources) sources[j] = ids[best];
+            if (++heads[best] == ends[best]) {
+                active--;
+                for (int i = best; i < active; i++) {
+                    heads[i] = heads[i + 1];
+                    ends[i] = ends[i + 1];
+                    ids[i] = ids[i + 1];
+                }
+            }
+        }
+        return;
+    }
+
+    // Cây thua: lá i ở vị trí k + i, nút trong giữ nguồn thua trận tại đó
+    for (int i = 0; i < k; i++) winners[k + i] = i;
+    for (int node = k - 1; node >= 1; node--) {
+        int left = winners[2 * node], right = winners[2 * node + 1];
+        if (sourceBefore(heads, ends, left, right, ascending)) {
+            winners[node] = left;
+            tree[node] = right;
+        } else {
+            winners[node] = right;
+            tree[node] = left;
+        }
+    }
+
+    int winner = winners[1];
+    for (long long j = 0; j < count; j++) {
+        out[j] = *heads[winner]++;
+        if (sources) sources[j] = ids[winner];
+        for (int node = (k + winner) / 2; node >= 1; node /= 2) {
+            if (sourceBefore(heads, ends, tree[node], winner, ascending)) {
+                int swap = tree[node];
+                tree[node] = winner;
+                winner = swap;
+            }
+        }
+    }
+}
+
+// Trộn phần [split_lo, split_hi) của các đầu vào vào out; trả về -1 nếu thiếu bộ nhớ
+static int mergePart(int* const inputs[], int k, const int split_lo[], const int split_hi[],
+                     long long count, int out[], int sources[], int ascending) {
+    if (count == 0) return 0;
+
+    // Chỉ giữ các lát khác rỗng, theo thứ tự đầu vào để giữ tính ổn định
+    const int** heads = (const int**)ogtMalloc(2 * (size_t)k * sizeof(const int*));
+    int* ids = (int*)ogtMalloc(4 * (size_t)k * sizeof(int));
+    if (!heads || !ids) {
+        ogtFree(heads);
+        ogtFree(ids);
+        return -1;
+    }
+    const int** ends = heads + k;
+    int active = 0;
+    for (int i = 0; i < k; i++) {
+        if (split_hi[i] == split_lo[i]) continue;
+        heads[active] = inputs[i] + split_lo[i];
+        ends[active] = inputs[i] + split_hi[i];
+        ids[active] = i;
+        active++;
+    }
+
+    int* tree = ids + k;
+    int* winners = ids + 2 * k;
+    mergeSlices(heads, ends, ids, active, count, out, sources, ascending, tree, winners);
+
+    ogtFree(heads);
+    ogtFree(ids);
+    return 0;
+}
+
+int mergeSortedArrays(int* const inputs[], const int lengths[], int k, int out[], int sources[],
+                      int num_threads, int ascending, OGTSortStats* stats) {
+    if (stats) resetSortStats(stats);
+    if (k < 0) {
+        printf(RED "Lỗi: Số đầu vào không hợp lệ (%d)\n" RESET, k);
+        return -1;
+    }
+    long long total = 0;
+    for (int i = 0; i < k; i++) {
+        if (lengths[i] < 0 || (lengths[i] > 0 && !inputs[i])) {
+            printf(RED "Lỗi: Đầu vào %d không hợp lệ\n" RESET, i);
+            return -1;
+        }
+        total += lengths[i];
+    }
+    if (total > INT_MAX) {
+        printf(RED "Lỗi: Tổng %lld phần tử vượt giới hạn mảng kết quả\n" RESET, total);
+        return -1;
+    }
+    if (total == 0) return 0;
+    if (num_threads < 1) num_threads = omp_get_max_threads();
+
+    // Phần nhỏ không bù được chi phí chọn vết cắt (k * 32 lần tìm nhị phân mỗi biên)
+    long long max_parts = total / OGT_KWAY_MIN_PART;
+    int parts = num_threads < max_parts ? num_threads : (int)(max_parts > 1 ? max_parts : 1);
+
+    OGTMemScope memory;
+    if (stats) memScopeBegin(&memory);
+    unsigned long long trace_begin = traceNow();
+    double t_begin = getCurrentTime();
+
+    // splits[p * k + i]: vị trí cắt đầu vào i tại biên phần p
+    int* splits = (int*)ogtMalloc((size_t)(parts + 1) * k * sizeof(int));
+    if (!splits) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho bảng cắt %d x %d\n" RESET, parts + 1, k);
+        if (stats) memScopeEnd(&memory, &stats->memory);
+        return -1;
+    }
+    memset(splits, 0, (size_t)k * sizeof(int));
+    memcpy(splits + (size_t)parts * k, lengths, (size_t)k * sizeof(int));
+
+    // Số phần theo num_threads, đội luồng do governor cấp
+    int team = parts > 1 ? governorAcquire(parts) : 1;
+    int failed = 0;
+    double t_split = t_begin;
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        #pragma omp for schedule(dynamic, 1)
+        for (int p = 1; p < parts; p++) {
+            selectSplit(inputs, lengths, k, total * p / parts, ascending, splits + (size_t)p * k);
+        }
+
+        #pragma omp single
+        t_split = getCurrentTime();
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int p = 0; p < parts; p++) {
+            long long first = total * p / parts;
+            long long count = total * (p + 1) / parts - first;
+            if (mergePart(inputs, k, splits + (size_t)p * k, splits + (size_t)(p + 1) * k, count,
+                          out + first, sources ? sources + first : NULL, ascending) != 0) {
+                __atomic_store_n(&failed, 1, __ATOMIC_RELAXED);
+            }
+        }
+    }
+    if (parts > 1) governorRelease(team);
+
+    double t_end = getCurrentTime();
+    traceSpan("kway-merge", trace_begin, (int)total);
+    ogtFree(splits);
+    if (failed) printf(RED "Lỗi: Không đủ bộ nhớ khi trộn %d đầu vào\n" RESET, k);
+
+    if (stats) {
+        stats->num_threads = team;
+        stats->phase_time[OGT_PHASE_SPLIT] = t_split - t_begin;
+        stats->phase_time[OGT_PHASE_MERGE] = t_end - t_split;
+        stats->phase_bytes[OGT_PHASE_MERGE] = 2.0 * total * sizeof(int);
+        stats->total_time = t_end - t_begin;
+        memScopeEnd(&memory, &stats->memory);
+    }
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,318 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/**
+ * Sắp xếp độ trễ thấp cho nhiều mảng nhỏ liên tiếp
+ *
+ * Với n cỡ 1K-50K, tạo đội OpenMP hoặc pthread mỗi lần gọi tốn ngang thời gian sắp xếp.
+ * Nhóm này giữ workers - 1 pthread thường trực: sau mỗi việc, worker quay chờ (spin) thêm
+ * spin_us micro giây rồi mới ngủ trên condvar, nên các lần gọi dồn dập không phải đánh thức luồng.
+ * Luồng gọi tự làm phần của worker 0. Dưới ngưỡng hòa vốn (đo khi tạo nhóm) chạy tuần tự.
+ * Vùng tạm cho trộn được giữ lại giữa các lần gọi; không có lệnh nào đổi trạng thái toàn cục.
+ */
+
+#define OGT_LATENCY_PROBE_MIN  64
+#define OGT_LATENCY_PROBE_MAX  65536    // phủ hết khoảng 1K-50K phần tử
+#define OGT_LATENCY_PROBE_REPS 7
+#define OGT_LATENCY_CHECK_EVERY 256     // vòng quay giữa hai lần đọc đồng hồ
+
+struct OGTLatencyPool {
+    pthread_mutex_t call_lock;          // một lần sắp xếp song song tại một thời điểm
+    pthread_mutex_t lock;               // bảo vệ sleepers khi worker đi ngủ
+    pthread_cond_t wake;
+    pthread_t* threads;
+    int num_threads;                    // worker nền = workers - 1
+    int workers;
+    int spin_us;
+    int break_even;
+
+    // việc hiện tại, công bố bằng generation
+    int* array;
+    int num_chunks;
+    int ascending;
+    unsigned long generation;
+    int pending;                        // worker nền chưa xong việc
+    int sleepers;
+    int stopping;
+
+    int* bounds;                        // biên khối: khối c là [bounds[c], bounds[c + 1])
+    int* scratch;
+    int capacity;
+};
+
+typedef struct {
+    OGTLatencyPool* pool;
+    int id;
+} LatencyWorker;
+
+static inline void cpuRelax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Sắp xếp các khối của người tham gia id (xoay vòng theo số người tham gia)
+static void sortOwnChunks(OGTLatencyPool* pool, int id) {
+    for (int c = id; c < pool->num_chunks; c += pool->workers) {
+        int start = pool->bounds[c];
+        int size = pool->bounds[c + 1] - start;
+        if (pool->ascending) {
+            insertionSortAsc(pool->array + start, size);
+        } else {
+            insertionSortDesc(pool->array + start, size);
+        }
+    }
+}
+
+// Quay chờ generation khác seen tối đa spin_us, sau đó ngủ
+static unsigned long waitForWork(OGTLatencyPool* pool, unsigned long seen) {
+    double deadline = getCurrentTime() + pool->spin_us * 1e-6;
+    for (int i = 1; ; i++) {
+        unsigned long generation = __atomic_load_n(&pool->generation, __ATOMIC_SEQ_CST);
+        if (generation != seen) return generation;
+        cpuRelax();
+        if (i % OGT_LATENCY_CHECK_EVERY == 0 && getCurrentTime() > deadline) break;
+    }
+
+    // sleepers tăng dưới khóa trước khi kiểm tra lại: người công bố hoặc thấy sleepers > 0
+    // và đánh thức, hoặc worker thấy generation mới
+    pthread_mutex_lock(&pool->lock);
+    __atomic_add_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+    unsigned long generation;
+    while ((generation = __atomic_load_n(&pool->generation, __ATOMIC_SEQ_CST)) == seen) {
+        pthread_cond_wait(&pool->wake, &pool->lock);
+    }
+    __atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&pool->lock);
+    return generation;
+}
+
+static void* latencyWorker(void* arg) {
+    LatencyWorker* worker = (LatencyWorker*)arg;
+    OGTLatencyPool* pool = worker->pool;
+    int id = worker->id;
+    ogtFree(worker);
+
+    unsigned long seen = 0;
+    for (;;) {
+        seen = waitForWork(pool, seen);
+        if (__atomic_load_n(&pool->stopping, __ATOMIC_ACQUIRE)) break;
+        sortOwnChunks(pool, id);
+        __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+// Công bố việc mới cho các worker nền
+static void publish(OGTLatencyPool* pool) {
+    __atomic_store_n(&pool->pending, pool->num_threads, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pool->generation, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->sleepers, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->wake);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// Đường song song, bỏ qua ngưỡng hòa vốn; gọi khi giữ call_lock
+static int sortParallel(OGTLatencyPool* pool, int a[], int n, int ascending) {
+    if (n > pool->capacity) {
+        int* scratch = (int*)ogtMalloc((size_t)n * sizeof(int));
+        if (!scratch) {
+            printf(RED "Lỗi: Không đủ bộ nhớ cho vùng tạm %d phần tử\n" RESET, n);
+            return -1;
+        }
+        ogtFree(pool->scratch);
+        pool->scratch = scratch;
+        pool->capacity = n;
+    }
+
+    int num_chunks = tuningChunkCount(n, pool->workers);
+    int chunk_size = n / num_chunks;
+    int remainder = n % num_chunks;
+    pool->bounds[0] = 0;
+    for (int c = 0; c < num_chunks; c++) {
+        pool->bounds[c + 1] = pool->bounds[c] + chunk_size + (c < remainder ? 1 : 0);
+    }
+    pool->array = a;
+    pool->num_chunks = num_chunks;
+    pool->ascending = ascending;
+
+    publish(pool);
+    sortOwnChunks(pool, 0);
+
+    // Luồng gọi quay chờ; hết spin_us thì nhường CPU (máy ít lõi hơn số worker)
+    double deadline = getCurrentTime() + pool->spin_us * 1e-6;
+    int yielding = 0;
+    for (int i = 1; __atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) > 0; i++) {
+        if (yielding) {
+            sched_yield();
+        } else {
+            cpuRelax();
+            if (i % OGT_LATENCY_CHECK_EVERY == 0 && getCurrentTime() > deadline) yielding = 1;
+        }
+    }
+
+    merge_adjacent_runs(pool->array, pool->scratch, pool->bounds, pool->num_chunks, n, ascending);
+    return pool->workers;
+}
+
+// Thời gian trung vị (giây) của một cách sắp xếp trên bản sao của input
+static double probeMedian(OGTLatencyPool* pool, const int* input, int* work, int n, int parallel) {
+    double samples[OGT_LATENCY_PROBE_REPS];
+    for (int run = -1; run < OGT_LATENCY_PROBE_REPS; run++) {
+        memcpy(work, input, (size_t)n * sizeof(int));
+        double t0 = getCurrentTime();
+        if (parallel) {
+            sortParallel(pool, work, n, 1);
+        } else {
+            insertionSortAsc(work, n);
+        }
+        if (run >= 0) samples[run] = getCurrentTime() - t0;
+    }
+    OGTSampleStats stats;
+    computeSampleStats(samples, OGT_LATENCY_PROBE_REPS, &stats);
+    return stats.median;
+}
+
+/**
+ * n nhỏ nhất mà từ đó đường song song nhanh hơn tuần tự, INT_MAX nếu không có tới PROBE_MAX
+ * Dò tăng dần từ n nhỏ (lần đo rẻ) và dừng khi song song thắng ở hai cỡ liên tiếp, nên máy chỉ
+ * hòa vốn ở vài chục nghìn phần tử vẫn có ngưỡng, còn máy hòa vốn sớm không phải đo mảng lớn.
+ */
+static int measureBreakEven(OGTLatencyPool* pool) {
+    int* input = (int*)ogtMalloc(OGT_LATENCY_PROBE_MAX * sizeof(int));
+    int* work = (int*)ogtMalloc(OGT_LATENCY_PROBE_MAX * sizeof(int));
+    int break_even = INT_MAX;
+    if (input && work) {
+        generateRandomArraySeeded(input, OGT_LATENCY_PROBE_MAX, 1000000, getRandomSeed());
+        for (int n = OGT_LATENCY_PROBE_MIN; n <= OGT_LATENCY_PROBE_MAX; n *= 2) {
+            double parallel = probeMedian(pool, input, work, n, 1);
+            double sequential = probeMedian(pool, input, work, n, 0);
+            if (parallel >= sequential) {
+                break_even = INT_MAX;
+            } else if (break_even == INT_MAX) {
+                break_even = n;
+            } else {
+                break;
+            }
+        }
+    }
+    ogtFree(input);
+    ogtFree(work);
+    return break_even;
+}
+
+OGTLatencyPool* latencyPoolCreate(int workers, int break_even, int spin_us) {
+    if (workers <= 0) workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1) workers = 1;
+    if (workers > ogtTuning()->max_threads) workers = ogtTuning()->max_threads;
+    if (spin_us < 0) spin_us = OGT_LATENCY_DEFAULT_SPIN_US;
+
+    OGTLatencyPool* pool = (OGTLatencyPool*)ogtCalloc(1, sizeof(OGTLatencyPool));
+    if (!pool) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho nhóm worker\n" RESET);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->call_lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pool->workers = workers;
+    pool->spin_us = spin_us;
+
+    pool->bounds = (int*)ogtMalloc(((size_t)workers * OGT_TUNING_MAX_CHUNKS + 1) * sizeof(int));
+    pool->threads = workers > 1 ? (pthread_t*)ogtMalloc((workers - 1) * sizeof(pthread_t)) : NULL;
+    if (!pool->bounds || (workers > 1 && !pool->threads)) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho nhóm worker\n" RESET);
+        latencyPoolDestroy(pool);
+        return NULL;
+    }
+    for (; pool->num_threads < workers - 1; pool->num_threads++) {
+        LatencyWorker* worker = (LatencyWorker*)ogtMalloc(sizeof(LatencyWorker));
+        if (!worker) break;
+        worker->pool = pool;
+        worker->id = pool->num_threads + 1;
+        if (pthread_create(&pool->threads[pool->num_threads], NULL, latencyWorker, worker) != 0) {
+            ogtFree(worker);
+            break;
+        }
+    }
+    if (pool->num_threads < workers - 1) {
+        printf(RED "Lỗi: Chỉ tạo được %d/%d worker\n" RESET, pool->num_threads, workers - 1);
+        latencyPoolDestroy(pool);
+        return NULL;
+    }
+
+    if (workers == 1) {
+        pool->break_even = INT_MAX;
+    } else {
+        pool->break_even = break_even > 0 ? break_even : measureBreakEven(pool);
+    }
+    return pool;
+}
+
+int latencySort(OGTLatencyPool* pool, int a[], int n, int ascending) {
+    if (n <= 1) return 1;
+
+    // Dưới ngưỡng hòa vốn, nhóm đang phục vụ lần gọi khác, hoặc governor không cấp đủ worker
+    // (các lần sắp xếp khác đang giữ lõi): tuần tự, không chờ
+    int granted = 0;
+    if (n >= pool->break_even && pthread_mutex_trylock(&pool->call_lock) == 0) {
+        granted = governorAcquire(pool->workers);
+        if (granted < pool->workers) {
+            governorRelease(granted);
+            pthread_mutex_unlock(&pool->call_lock);
+            granted = 0;
+        }
+    }
+    if (!granted) {
+        if (ascending) {
+            insertionSortAsc(a, n);
+        } else {
+            insertionSortDesc(a, n);
+        }
+        return 1;
+    }
+
+    unsigned long long trace_begin = traceNow();
+    int used = sortParallel(pool, a, n, ascending);
+    governorRelease(granted);
+    pthread_mutex_unlock(&pool->call_lock);
+    traceSpan("latency-sort", trace_begin, n);
+    return used;
+}
+
+int latencyPoolBreakEven(const OGTLatencyPool* pool) {
+    return pool->break_even;
+}
+
+int latencyPoolWorkers(const OGTLatencyPool* pool) {
+    return pool->workers;
+}
+
+void latencyPoolDestroy(OGTLatencyPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    __atomic_store_n(&pool->stopping, 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&pool->generation, 1, __ATOMIC_SEQ_CST);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->call_lock);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    ogtFree(pool->threads);
+    ogtFree(pool->bounds);
+    ogtFree(pool->scratch);
+    ogtFree(pool);
+}
@@ -12,9 +12,15 @@ int main(int argc, char* argv[]) {
     }
 #endif
 
+    // Timeline Chrome trace-event khi đặt OGT_TRACE=file.json
+    const char* trace_path = getenv("OGT_TRACE");
+    int tracing = trace_path != NULL && traceStart(trace_path) == 0;
+
     // Chạy trình UI test chính
     overallTestOGT();
 
+    if (tracing) traceStop();
+
     // Đóng MPI nếu đã khởi tạo
 #ifdef HAVE_MPI
     finalizeMPI();
@@ -0,0 +1,151 @@
+#include "sort_ogt.h"
+#include <string.h>
+
+/**
+ * Kế toán bộ nhớ cho các hàm sắp xếp
+ *
+ * Mọi cấp phát tạm của các backend đi qua ogtMalloc/ogtCalloc/ogtFree. Mỗi khối có
+ * một header lưu kích thước để ogtFree trừ đúng số byte đang sống; các bộ đếm
+ * dùng phép toán nguyên tử vì luồng pthread/OpenMP cũng có thể cấp phát.
+ *
+ * memScopeBegin/memScopeEnd bao một lần sắp xếp: số byte, số lần cấp phát và
+ * đỉnh byte sống vượt mức lúc bắt đầu. Mỗi phạm vi đang mở giữ một ô đỉnh riêng, mọi lần
+ * cấp phát nâng đỉnh của các ô đang mở, nên phạm vi lồng nhau (MPI gọi insertionSortStats)
+ * hay đồng thời (ogt_sort_async, context dùng chung) không đặt lại đỉnh của nhau.
+ *
+ * Các bộ đếm là của cả tiến trình: khi nhiều lần sắp xếp chạy đồng thời, số liệu của một
+ * phạm vi gồm cả cấp phát của các lần kia (cận trên, không bao giờ âm).
+ */
+
+#define OGT_MEM_MAX_SCOPES 64
+
+// Header giữ căn lề 16 byte cho dữ liệu phía sau
+typedef union {
+    size_t size;
+    long double align;
+} AllocHeader;
+
+static long long live_bytes = 0;
+static long long scope_peaks[OGT_MEM_MAX_SCOPES];
+static int scope_used[OGT_MEM_MAX_SCOPES];
+static int scope_slots = 0;         // số ô đã từng dùng (giới hạn vòng quét)
+static long long total_bytes = 0;
+static long long total_allocations = 0;
+static int scope_depth = 0;
+
+static void recordAllocation(size_t size) {
+    long long live = __atomic_add_fetch(&live_bytes, (long long)size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&total_bytes, (long long)size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&total_allocations, 1, __ATOMIC_RELAXED);
+
+    int slots = __atomic_load_n(&scope_slots, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < slots; i++) {
+        if (__atomic_load_n(&scope_used[i], __ATOMIC_ACQUIRE) != 1) continue;
+        long long peak = __atomic_load_n(&scope_peaks[i], __ATOMIC_RELAXED);
+        while (live > peak &&
+               !__atomic_compare_exchange_n(&scope_peaks[i], &peak, live, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+void* ogtMalloc(size_t size) {
+    AllocHeader* header = (AllocHeader*)malloc(sizeof(AllocHeader) + size);
+    if (!header) return NULL;
+    header->size = size;
+    recordAllocation(size);
+    return header + 1;
+}
+
+void* ogtCalloc(size_t count, size_t size) {
+    if (size != 0 && count > ((size_t)-1 - sizeof(AllocHeader)) / size) return NULL;
+    void* data = ogtMalloc(count * size);
+    if (data) memset(data, 0, count * size);
+    return data;
+}
+
+void ogtFree(void* ptr) {
+    if (!ptr) return;
+    AllocHeader* header = (AllocHeader*)ptr - 1;
+    __atomic_sub_fetch(&live_bytes, (long long)header->size, __ATOMIC_RELAXED);
+    free(header);
+}
+
+long long memLiveBytes(void) {
+    return __atomic_load_n(&live_bytes, __ATOMIC_RELAXED);
+}
+
+// Đọc một trường kB trong /proc/self/status, -1 nếu không có (không phải Linux)
+static long readStatusKB(const char* field) {
+    FILE* file = fopen("/proc/self/status", "r");
+    if (!file) return -1;
+
+    char line[256];
+    size_t length = strlen(field);
+    long value = -1;
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, field, length) == 0 && line[length] == ':') {
+            value = strtol(line + length + 1, NULL, 10);
+            break;
+        }
+    }
+    fclose(file);
+    return value;
+}
+
+// Đỉnh RSS (VmHWM) của tiến trình, kB
+long peakRSSKB(void) {
+    return readStatusKB("VmHWM");
+}
+
+long currentRSSKB(void) {
+    return readStatusKB("VmRSS");
+}
+
+// Đặt lại VmHWM về RSS hiện tại (Linux >= 4.0); lặng lẽ bỏ qua nếu không hỗ trợ
+static void resetPeakRSS(void) {
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (!file) return;
+    fputs("5", file);
+    fclose(file);
+}
+
+void memScopeBegin(OGTMemScope* scope) {
+    scope->live = __atomic_load_n(&live_bytes, __ATOMIC_RELAXED);
+    scope->allocated = __atomic_load_n(&total_bytes, __ATOMIC_RELAXED);
+    scope->allocations = __atomic_load_n(&total_allocations, __ATOMIC_RELAXED);
+
+    // Giữ một ô đỉnh trống; hết ô thì đỉnh lấy cận trên là số byte đã cấp phát
+    scope->slot = -1;
+    for (int i = 0; i < OGT_MEM_MAX_SCOPES; i++) {
+        int expected = 0;
+        if (__atomic_load_n(&scope_used[i], __ATOMIC_RELAXED) ||
+            !__atomic_compare_exchange_n(&scope_used[i], &expected, -1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        __atomic_store_n(&scope_peaks[i], scope->live, __ATOMIC_RELAXED);
+        __atomic_store_n(&scope_used[i], 1, __ATOMIC_RELEASE);
+        int slots = __atomic_load_n(&scope_slots, __ATOMIC_RELAXED);
+        while (slots < i + 1 &&
+               !__atomic_compare_exchange_n(&scope_slots, &slots, i + 1, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+        scope->slot = i;
+        break;
+    }
+
+    // Đỉnh RSS chỉ đặt lại khi không có phạm vi nào khác đang mở
+    if (__atomic_fetch_add(&scope_depth, 1, __ATOMIC_RELAXED) == 0) resetPeakRSS();
+}
+
+void memScopeEnd(const OGTMemScope* scope, OGTMemStats* out) {
+    out->bytes_allocated = __atomic_load_n(&total_bytes, __ATOMIC_RELAXED) - scope->allocated;
+    out->allocations = __atomic_load_n(&total_allocations, __ATOMIC_RELAXED) - scope->allocations;
+    if (scope->slot >= 0) {
+        out->peak_bytes = __atomic_load_n(&scope_peaks[scope->slot], __ATOMIC_RELAXED) - scope->live;
+        __atomic_store_n(&scope_used[scope->slot], 0, __ATOMIC_RELEASE);
+    } else {
+        out->peak_bytes = out->bytes_allocated;
+    }
+    out->peak_rss_kb = peakRSSKB();
+    __atomic_sub_fetch(&scope_depth, 1, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,1702 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <getopt.h>
+#include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "sort_ogt.h"
+
+/**
+ * ogt_bench - trình benchmark không tương tác
+ *
+ * Mỗi lần chạy đo được ghi ra một bản ghi JSON (một object mỗi dòng) hoặc CSV,
+ * thay cho việc dò bảng kết quả của menu tương tác bằng grep/awk.
+ * Với backend mpi, số rank lấy từ mpirun -np; chỉ rank 0 ghi kết quả.
+ *
+ * Chế độ so sánh (--compare BASE NEW) đọc lại các bản ghi của hai lần benchmark,
+ * gom theo cấu hình và dùng kiểm định t Welch để đánh dấu tăng tốc/chậm đi.
+ *
+ * Chế độ mở rộng (--scaling strong|weak) đo lần lượt 1, 2, 4, ... worker (luồng,
+ * hoặc rank với mpi) tới -t / -np, mỗi điểm ghi một bản ghi gồm trung vị thời gian,
+ * speedup, hiệu suất và tỉ lệ tuần tự Karp–Flatt.
+ *
+ * Chế độ file (--file IN) sắp xếp file khóa nhị phân int32/int64 qua mmap, tại chỗ
+ * hoặc vào --file-out; mỗi lần chạy ghi thời gian map/copy/sort/sync.
+ * Thêm --external để sắp xếp ngoài trong ngân sách --memory-budget (file lớn hơn RAM),
+ * hoặc --text khi file là văn bản mỗi dòng một số (parse/định dạng song song).
+ * --stream đọc --file (hoặc stdin với "-") theo khối và sắp xếp trong lúc đọc.
+ */
+
+#define BENCH_DEFAULT_SIZE 100000
+#define BENCH_DEFAULT_MAX_VALUE 10000
+#define BENCH_DEFAULT_REPS 5
+#define BENCH_DEFAULT_WARMUP 1
+#define BENCH_DEFAULT_THRESHOLD 2.0
+#define COMPARE_MAX_LINE 4096
+#define COMPARE_MAX_FIELDS 64
+
+typedef enum {
+    BENCH_FORMAT_JSON = 0,
+    BENCH_FORMAT_CSV
+} BenchFormat;
+
+typedef struct {
+    OGTBackend backend;
+    int n;
+    int threads;
+    OGTDistribution dist;
+    int dist_param;         // nearly-sorted:K, OGT_DIST_DEFAULT_PARAM nếu không có
+    int reps;
+    int warmup;
+    unsigned long long seed;
+    int max_val;
+    int ascending;
+    int compression;
+    BenchFormat format;
+    int header;
+    int summary;
+    int counters;           // ghi bộ đếm phần cứng của pha sort/merge
+    int scaling;            // OGTScalingMode, -1 nếu đo thường
+    const char* trace;      // file Chrome trace-event, NULL nếu tắt
+    int bandwidth;          // ghi GB/s và % đỉnh STREAM của các pha bộ nhớ
+    int auto_select;        // chọn backend và số luồng bằng ogt_sort_plan
+    int latency;            // sắp xếp bằng nhóm worker thường trực (latencySort)
+    int segments;           // > 0: chia -n phần tử thành bấy nhiêu đoạn độc lập (segmentedSort)
+    int insert;             // > 0: chèn lô bấy nhiêu khóa vào -n trừ lô khóa đã sắp xếp (sortedInsertBatch)
+    OGTObjective objective;
+    const char* file_input; // chế độ file: file khóa nhị phân cần sắp xếp
+    const char* file_output;// NULL để sắp xếp tại chỗ
+    OGTKeyType key;
+    int mmap_flags;         // OGT_MMAP_POPULATE, OGT_MMAP_HUGE_PAGES
+    int external;           // chế độ file: sắp xếp ngoài thay vì mmap
+    size_t memory_budget;   // byte, ngân sách của sắp xếp ngoài
+    const char* temp_dir;
+    int text;               // chế độ file: file văn bản mỗi dòng một số
+    int stream;             // chế độ file: sắp xếp dạng luồng trong lúc đọc
+    int run_size;           // phần tử mỗi run của --stream
+    const char* output;
+    const char* compare_base;
+    double threshold;       // % thay đổi tối thiểu để tính là tăng tốc/chậm đi
+} BenchOptions;
+
+static void printUsage(const char* prog) {
+    printf("Cách dùng: %s [tùy chọn]\n", prog);
+    printf("  -b, --backend B      seq | openmp | pthreads | mpi (mặc định: openmp)\n");
+    printf("  -n, --size N         số phần tử (mặc định: %d)\n", BENCH_DEFAULT_SIZE);
+    printf("  -t, --threads T      số luồng cho openmp/pthreads (mặc định: số lõi)\n");
+    printf("                       backend mpi dùng số rank của mpirun -np\n");
+    printf("  -d, --dist D[:K]     phân phối dữ liệu (mặc định: uniform); nearly-sorted:K hoán đổi K cặp\n");
+    printf("  -r, --reps R         số lần đo (mặc định: %d)\n", BENCH_DEFAULT_REPS);
+    printf("  -w, --warmup W       số lần chạy khởi động không ghi (mặc định: %d)\n", BENCH_DEFAULT_WARMUP);
+    printf("  -s, --seed S         seed sinh dữ liệu (mặc định: OGT_SEED hoặc seed thư viện)\n");
+    printf("  -m, --max-val V      giá trị tối đa của phần tử (mặc định: %d)\n", BENCH_DEFAULT_MAX_VALUE);
+    printf("      --desc           sắp xếp giảm dần\n");
+    printf("      --compress       bật nén run khi gather (mpi)\n");
+    printf("  -f, --format F       json | csv (mặc định: json)\n");
+    printf("      --no-header      không in dòng tiêu đề CSV\n");
+    printf("  -o, --output FILE    ghi nối tiếp vào FILE thay vì stdout\n");
+    printf("      --summary        in trung vị/p95/độ lệch/CI95 ra stderr sau khi đo\n");
+    printf("      --counters       ghi bộ đếm phần cứng (chu kỳ, lệnh, IPC, miss) của pha sort/merge\n");
+    printf("      --bandwidth      ghi GB/s và %% băng thông đỉnh (STREAM) của copy/merge/copy-back\n");
+    printf("      --auto           chọn backend và số luồng theo mô hình chi phí (bỏ qua -b, -t)\n");
+    printf("      --objective M    mục tiêu của --auto: latency | throughput (mặc định: latency)\n");
+    printf("      --latency        nhóm -t worker thường trực, tuần tự dưới ngưỡng hòa vốn (pthreads)\n");
+    printf("      --segments K     chia -n phần tử thành K đoạn độc lập cỡ ngẫu nhiên, sắp xếp\n");
+    printf("                       mỗi đoạn trong một vùng song song (segmentedSort; openmp, seq)\n");
+    printf("      --insert M       đo chèn lô M khóa ngẫu nhiên vào n - M khóa đã sắp xếp\n");
+    printf("                       (sortedInsertBatch; openmp, seq)\n");
+    printf("      --trace FILE     ghi timeline Chrome trace-event (Perfetto, chrome://tracing)\n");
+    printf("      --scaling M      nghiên cứu mở rộng strong | weak qua 1, 2, 4, ... worker\n");
+    printf("                       (weak: -n là số phần tử mỗi worker)\n");
+    printf("      --file IN        sắp xếp file khóa nhị phân little-endian qua mmap (tại chỗ nếu\n");
+    printf("                       không có --file-out; khi đó chỉ chạy một lần)\n");
+    printf("      --file-out OUT   ghi kết quả vào OUT, mỗi lần chạy sắp xếp lại từ IN\n");
+    printf("      --key K          int32 | int64 (mặc định: int32; int64 không hỗ trợ mpi)\n");
+    printf("      --populate       đọc trước toàn bộ file khi map (MAP_POPULATE)\n");
+    printf("      --huge-pages     gợi ý huge page cho vùng map (MADV_HUGEPAGE)\n");
+    printf("      --external       sắp xếp ngoài (sinh run + trộn k-chiều) cho file lớn hơn RAM\n");
+    printf("      --memory-budget MB\n");
+    printf("                       ngân sách bộ nhớ của --external (mặc định: %d)\n",
+           (int)(OGT_EXTERNAL_DEFAULT_BUDGET / (1024 * 1024)));
+    printf("      --temp-dir DIR   thư mục file run tạm (mặc định: $TMPDIR hoặc /tmp)\n");
+    printf("      --text           file là văn bản, mỗi dòng một số nguyên\n");
+    printf("      --stream         sắp xếp trong lúc đọc --file (- là stdin), -t worker nền\n");
+    printf("      --run-size N     phần tử mỗi run của --stream (mặc định: %d)\n", OGT_STREAM_DEFAULT_RUN);
+    printf("      --compare BASE NEW\n");
+    printf("                       so sánh hai file kết quả, mã thoát 1 nếu có chậm đi\n");
+    printf("      --threshold P    %% thay đổi tối thiểu khi so sánh (mặc định: %.0f)\n", BENCH_DEFAULT_THRESHOLD);
+    printf("  -h, --help           hiển thị hướng dẫn\n");
+    printf("\nPhân phối:");
+    for (int d = 0; d < OGT_DIST_COUNT; d++) {
+        printf(" %s", distributionName((OGTDistribution)d));
+    }
+    printf("\n");
+}
+
+// Đọc số nguyên dương, trả về -1 nếu không hợp lệ
+static long long parsePositive(const char* text, int allow_zero) {
+    char* end;
+    long long value = strtoll(text, &end, 10);
+    if (*text == '\0' || *end != '\0' || value < 0 || (!allow_zero && value == 0)) return -1;
+    return value;
+}
+
+static int parseOptions(int argc, char* argv[], BenchOptions* opts) {
+    enum { OPT_DESC = 256, OPT_COMPRESS, OPT_NO_HEADER, OPT_SUMMARY, OPT_COUNTERS, OPT_BANDWIDTH, OPT_TRACE, OPT_SCALING, OPT_COMPARE, OPT_THRESHOLD,
+           OPT_FILE, OPT_FILE_OUT, OPT_KEY, OPT_POPULATE, OPT_HUGE_PAGES,
+           OPT_EXTERNAL, OPT_MEMORY_BUDGET, OPT_TEMP_DIR, OPT_TEXT,
+           OPT_STREAM, OPT_RUN_SIZE, OPT_AUTO, OPT_OBJECTIVE, OPT_LATENCY,
+           OPT_SEGMENTS, OPT_INSERT };
+    static const struct option long_options[] = {
+        {"backend",   required_argument, NULL, 'b'},
+        {"size",      required_argument, NULL, 'n'},
+        {"threads",   required_argument, NULL, 't'},
+        {"dist",      required_argument, NULL, 'd'},
+        {"reps",      required_argument, NULL, 'r'},
+        {"warmup",    required_argument, NULL, 'w'},
+        {"seed",      required_argument, NULL, 's'},
+        {"max-val",   required_argument, NULL, 'm'},
+        {"desc",      no_argument,       NULL, OPT_DESC},
+        {"compress",  no_argument,       NULL, OPT_COMPRESS},
+        {"format",    required_argument, NULL, 'f'},
+        {"no-header", no_argument,       NULL, OPT_NO_HEADER},
+        {"output",    required_argument, NULL, 'o'},
+        {"summary",   no_argument,       NULL, OPT_SUMMARY},
+        {"counters",  no_argument,       NULL, OPT_COUNTERS},
+        {"bandwidth", no_argument,       NULL, OPT_BANDWIDTH},
+        {"auto",      no_argument,       NULL, OPT_AUTO},
+        {"objective", required_argument, NULL, OPT_OBJECTIVE},
+        {"latency",   no_argument,       NULL, OPT_LATENCY},
+        {"segments",  required_argument, NULL, OPT_SEGMENTS},
+        {"insert",    required_argument, NULL, OPT_INSERT},
+        {"trace",     required_argument, NULL, OPT_TRACE},
+        {"scaling",   required_argument, NULL, OPT_SCALING},
+        {"file",      required_argument, NULL, OPT_FILE},
+        {"file-out",  required_argument, NULL, OPT_FILE_OUT},
+        {"key",       required_argument, NULL, OPT_KEY},
+        {"populate",  no_argument,       NULL, OPT_POPULATE},
+        {"huge-pages", no_argument,      NULL, OPT_HUGE_PAGES},
+        {"external",  no_argument,       NULL, OPT_EXTERNAL},
+        {"memory-budget", required_argument, NULL, OPT_MEMORY_BUDGET},
+        {"temp-dir",  required_argument, NULL, OPT_TEMP_DIR},
+        {"text",      no_argument,       NULL, OPT_TEXT},
+        {"stream",    no_argument,       NULL, OPT_STREAM},
+        {"run-size",  required_argument, NULL, OPT_RUN_SIZE},
+        {"compare",   required_argument, NULL, OPT_COMPARE},
+        {"threshold", required_argument, NULL, OPT_THRESHOLD},
+        {"help",      no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int c;
+    long long value;
+    while ((c = getopt_long(argc, argv, "b:n:t:d:r:w:s:m:f:o:h", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'b':
+                if ((value = parseBackend(optarg)) < 0) {
+                    fprintf(stderr, RED "Backend không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->backend = (OGTBackend)value;
+                break;
+            case 'n':
+                if ((value = parsePositive(optarg, 0)) < 0 || value > 0x7FFFFFFF) {
+                    fprintf(stderr, RED "Kích thước không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->n = (int)value;
+                break;
+            case 't':
+                if ((value = parsePositive(optarg, 0)) < 0 || value > 4096) {
+                    fprintf(stderr, RED "Số luồng không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->threads = (int)value;
+                break;
+            case 'd':
+                if ((value = parseDistributionSpec(optarg, &opts->dist_param)) < 0) {
+                    fprintf(stderr, RED "Phân phối không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->dist = (OGTDistribution)value;
+                break;
+            case 'r':
+                if ((value = parsePositive(optarg, 0)) < 0 || value > 1000000) {
+                    fprintf(stderr, RED "Số lần đo không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->reps = (int)value;
+                break;
+            case 'w':
+                if ((value = parsePositive(optarg, 1)) < 0 || value > 1000000) {
+                    fprintf(stderr, RED "Số lần khởi động không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->warmup = (int)value;
+                break;
+            case 's':
+                opts->seed = strtoull(optarg, NULL, 0);
+                break;
+            case 'm':
+                if ((value = parsePositive(optarg, 0)) < 0 || value > 0x7FFFFFFF) {
+                    fprintf(stderr, RED "Giá trị tối đa không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->max_val = (int)value;
+                break;
+            case OPT_DESC:
+                opts->ascending = 0;
+                break;
+            case OPT_COMPRESS:
+                opts->compression = 1;
+                break;
+            case 'f':
+                if (strcmp(optarg, "json") == 0) {
+                    opts->format = BENCH_FORMAT_JSON;
+                } else if (strcmp(optarg, "csv") == 0) {
+                    opts->format = BENCH_FORMAT_CSV;
+                } else {
+                    fprintf(stderr, RED "Định dạng không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                break;
+            case OPT_NO_HEADER:
+                opts->header = 0;
+                break;
+            case 'o':
+                opts->output = optarg;
+                break;
+            case OPT_SUMMARY:
+                opts->summary = 1;
+                break;
+            case OPT_COUNTERS:
+                opts->counters = 1;
+                break;
+            case OPT_TRACE:
+                opts->trace = optarg;
+                break;
+            case OPT_AUTO:
+                opts->auto_select = 1;
+                break;
+            case OPT_LATENCY:
+                opts->latency = 1;
+                break;
+            case OPT_SEGMENTS:
+                if ((value = parsePositive(optarg, 0)) < 0 || value > 0x7FFFFFFF) {
+                    fprintf(stderr, RED "Số đoạn không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->segments = (int)value;
+                break;
+            case OPT_INSERT:
+                if ((value = parsePositive(optarg, 0)) < 0 || value > 0x7FFFFFFF) {
+                    fprintf(stderr, RED "Cỡ lô không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->insert = (int)value;
+                break;
+            case OPT_OBJECTIVE:
+                if ((value = parseObjective(optarg)) < 0) {
+                    fprintf(stderr, RED "Mục tiêu không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->objective = (OGTObjective)value;
+                break;
+            case OPT_BANDWIDTH:
+                opts->bandwidth = 1;
+                break;
+            case OPT_SCALING:
+                if ((value = parseScalingMode(optarg)) < 0) {
+                    fprintf(stderr, RED "Chế độ mở rộng không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->scaling = (int)value;
+                break;
+            case OPT_FILE:
+                opts->file_input = optarg;
+                break;
+            case OPT_FILE_OUT:
+                opts->file_output = optarg;
+                break;
+            case OPT_KEY:
+                if ((value = parseKeyType(optarg)) < 0) {
+                    fprintf(stderr, RED "Kiểu khóa không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->key = (OGTKeyType)value;
+                break;
+            case OPT_POPULATE:
+                opts->mmap_flags |= OGT_MMAP_POPULATE;
+                break;
+            case OPT_HUGE_PAGES:
+                opts->mmap_flags |= OGT_MMAP_HUGE_PAGES;
+                break;
+            case OPT_EXTERNAL:
+                opts->external = 1;
+                break;
+            case OPT_MEMORY_BUDGET:
+                if ((value = parsePositive(optarg, 0)) < 0 || value > 1024 * 1024) {
+                    fprintf(stderr, RED "Ngân sách bộ nhớ không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->memory_budget = (size_t)value * 1024 * 1024;
+                break;
+            case OPT_TEMP_DIR:
+                opts->temp_dir = optarg;
+                break;
+            case OPT_TEXT:
+                opts->text = 1;
+                break;
+            case OPT_STREAM:
+                opts->stream = 1;
+                break;
+            case OPT_RUN_SIZE:
+                if ((value = parsePositive(optarg, 0)) < 0 || value > 0x7FFFFFFF) {
+                    fprintf(stderr, RED "Kích thước run không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                opts->run_size = (int)value;
+                break;
+            case OPT_COMPARE:
+                opts->compare_base = optarg;
+                break;
+            case OPT_THRESHOLD: {
+                char* end;
+                opts->threshold = strtod(optarg, &end);
+                if (*optarg == '\0' || *end != '\0' || opts->threshold < 0.0) {
+                    fprintf(stderr, RED "Ngưỡng không hợp lệ: %s\n" RESET, optarg);
+                    return -1;
+                }
+                break;
+            }
+            case 'h':
+                printUsage(argv[0]);
+                return 1;
+            default:
+                printUsage(argv[0]);
+                return -1;
+        }
+    }
+
+    // --compare cần đúng một file mới sau file gốc
+    int expected = opts->compare_base ? 1 : 0;
+    if (argc - optind != expected) {
+        if (expected) {
+            fprintf(stderr, RED "--compare cần hai file: BASE NEW\n" RESET);
+        } else {
+            fprintf(stderr, RED "Tham số thừa: %s\n" RESET, argv[optind]);
+        }
+        return -1;
+    }
+    return 0;
+}
+
+static int checkSorted(const int a[], int n, int ascending) {
+    for (int i = 1; i < n; i++) {
+        if (ascending ? a[i] < a[i - 1] : a[i] > a[i - 1]) return 0;
+    }
+    return 1;
+}
+
+// Một lần chạy đo, chỉ hợp lệ tại rank 0 với backend mpi
+typedef struct {
+    int rep;
+    double time;
+    int sorted;
+    OGTSortStats stats;
+    OGTMPIPhaseStats rank_stats;
+} BenchRecord;
+
+// Trạng thái dựng một lần trước các lần đo
+typedef struct {
+    OGTLatencyPool* pool;       // --latency
+    long long* offsets;         // --segments: opts->segments + 1 biên đoạn
+} BenchRuntime;
+
+// Biên của K đoạn: K - 1 điểm cắt ngẫu nhiên trong [0, n], cỡ đoạn xấp xỉ phân phối mũ
+static long long* makeSegmentOffsets(int n, int segments, unsigned long long seed) {
+    long long* offsets = malloc(((size_t)segments + 1) * sizeof(long long));
+    int* cuts = malloc((size_t)segments * sizeof(int));
+    if (!offsets || !cuts) {
+        free(offsets);
+        free(cuts);
+        return NULL;
+    }
+    generateRandomArraySeeded(cuts, segments, n, seed ^ 0x5e6d);
+    insertionSortAsc(cuts, segments - 1);
+    offsets[0] = 0;
+    for (int s = 1; s < segments; s++) offsets[s] = cuts[s - 1] < n ? cuts[s - 1] : n;
+    offsets[segments] = n;
+    free(cuts);
+    return offsets;
+}
+
+static int checkSegmentsSorted(const int a[], const long long offsets[], int segments, int ascending) {
+    for (int s = 0; s < segments; s++) {
+        if (!checkSorted(a + offsets[s], (int)(offsets[s + 1] - offsets[s]), ascending)) return 0;
+    }
+    return 1;
+}
+
+// rt == NULL hoặc không có trạng thái: chạy backend như thường
+static void runOnce(const BenchOptions* opts, int a[], BenchRecord* record, const BenchRuntime* rt) {
+    double start = 0.0;
+
+    if (rt && rt->offsets) {
+        int threads = opts->backend == OGT_BACKEND_SEQ ? 1 : opts->threads;
+        start = getCurrentTime();
+        segmentedSort(a, rt->offsets, opts->segments, threads, opts->ascending, &record->stats);
+        record->time = getCurrentTime() - start;
+        return;
+    }
+
+    if (opts->insert > 0) {
+        // a[0..n - insert) đã sắp xếp, lô ghi sẵn ở đuôi
+        int threads = opts->backend == OGT_BACKEND_SEQ ? 1 : opts->threads;
+        int base = opts->n - opts->insert;
+        start = getCurrentTime();
+        sortedInsertBatch(a, base, a + base, opts->insert, threads, opts->ascending, &record->stats);
+        record->time = getCurrentTime() - start;
+        return;
+    }
+
+    if (opts->auto_select) {
+        // Đo đúng lời gọi ogt_sort: lập kế hoạch, governor và kernel của backend được chọn
+        OGTSortOptions sort_opts;
+        ogt_sort_default_options(&sort_opts);
+        sort_opts.objective = opts->objective;
+        sort_opts.ascending = opts->ascending;
+        sort_opts.stats = &record->stats;
+        start = getCurrentTime();
+        ogt_sort(a, opts->n, &sort_opts);
+        record->time = getCurrentTime() - start;
+        return;
+    }
+
+    if (rt && rt->pool) {
+        OGTLatencyPool* pool = rt->pool;
+        start = getCurrentTime();
+        record->stats.num_threads = latencySort(pool, a, opts->n, opts->ascending);
+        record->time = getCurrentTime() - start;
+        record->stats.total_time = record->time;
+        record->stats.phase_time[OGT_PHASE_SORT] = record->time;
+        return;
+    }
+
+    switch (opts->backend) {
+        case OGT_BACKEND_SEQ:
+            start = getCurrentTime();
+            insertionSortStats(a, opts->n, opts->ascending, &record->stats);
+            break;
+        case OGT_BACKEND_OPENMP:
+            start = getCurrentTime();
+            parallelInsertionSortStats(a, opts->n, opts->threads, opts->ascending, &record->stats);
+            break;
+        case OGT_BACKEND_PTHREADS:
+            start = getCurrentTime();
+            parallelInsertionSortPthreadsStats(a, opts->n, opts->threads, opts->ascending, &record->stats);
+            break;
+        case OGT_BACKEND_MPI:
+        default:
+#ifdef HAVE_MPI
+            MPI_Barrier(getMPICommunicator());
+#endif
+            start = getCurrentTime();
+            parallelInsertionSortMPIRankStats(a, opts->n, opts->ascending,
+                                              &record->stats, &record->rank_stats);
+            break;
+    }
+
+    record->time = getCurrentTime() - start;
+}
+
+// Các pha chịu giới hạn bộ nhớ được ghi băng thông khi bật --bandwidth
+static const OGTPhase bandwidth_phases[] = { OGT_PHASE_COPY, OGT_PHASE_MERGE, OGT_PHASE_COPY_BACK };
+#define BENCH_BANDWIDTH_PHASES (int)(sizeof(bandwidth_phases) / sizeof(bandwidth_phases[0]))
+
+// Các pha có bộ đếm phần cứng được ghi khi bật --counters
+static const OGTPhase counter_phases[] = { OGT_PHASE_SORT, OGT_PHASE_MERGE };
+#define BENCH_COUNTER_PHASES (int)(sizeof(counter_phases) / sizeof(counter_phases[0]))
+
+// Cách gọi được đo: sort (backend thường), auto (ogt_sort), latency, segments:K, insert:M
+static const char* benchMode(const BenchOptions* opts, char* buf, size_t size) {
+    if (opts->auto_select) {
+        snprintf(buf, size, "auto");
+    } else if (opts->latency) {
+        snprintf(buf, size, "latency");
+    } else if (opts->segments > 0) {
+        snprintf(buf, size, "segments:%d", opts->segments);
+    } else if (opts->insert > 0) {
+        snprintf(buf, size, "insert:%d", opts->insert);
+    } else {
+        snprintf(buf, size, "sort");
+    }
+    return buf;
+}
+
+static void printHeader(FILE* out, const BenchOptions* opts) {
+    if (opts->format != BENCH_FORMAT_CSV || !opts->header) return;
+    fprintf(out, "backend,mode,n,threads,ranks,dist,seed,max_val,order,compress,rep,time_s");
+    for (int p = 0; p < OGT_PHASE_COUNT; p++) {
+        fprintf(out, ",%s_s", phaseName((OGTPhase)p));
+    }
+    fprintf(out, ",imbalance,comm_comp,alloc_bytes,allocs,peak_bytes,peak_rss_kb,other_peak_bytes,other_rss_kb");
+    if (opts->counters) {
+        for (int k = 0; k < BENCH_COUNTER_PHASES; k++) {
+            const char* phase = phaseName(counter_phases[k]);
+            for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+                fprintf(out, ",%s_%s", phase, counterName((OGTCounter)c));
+            }
+            fprintf(out, ",%s_ipc", phase);
+        }
+    }
+    if (opts->bandwidth) {
+        for (int k = 0; k < BENCH_BANDWIDTH_PHASES; k++) {
+            const char* phase = phaseName(bandwidth_phases[k]);
+            fprintf(out, ",%s_gbps,%s_peak_pct", phase, phase);
+        }
+    }
+    fprintf(out, ",sorted\n");
+}
+
+// Bộ đếm không đo được để trống (CSV) hoặc null (JSON)
+static void printCountersCSV(FILE* out, const OGTSortStats* stats) {
+    for (int k = 0; k < BENCH_COUNTER_PHASES; k++) {
+        const OGTCounterValues* values = &stats->phase_counters[counter_phases[k]];
+        for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+            if (counterValid(values, (OGTCounter)c)) {
+                fprintf(out, ",%.0f", values->value[c]);
+            } else {
+                fprintf(out, ",");
+            }
+        }
+        if (counterIPC(values) > 0.0) {
+            fprintf(out, ",%.4f", counterIPC(values));
+        } else {
+            fprintf(out, ",");
+        }
+    }
+}
+
+// Giá trị bộ nhớ âm (không đọc được, hoặc không có rank khác) để trống (CSV) hoặc null (JSON)
+static void printMemoryValueCSV(FILE* out, long long value) {
+    if (value >= 0) {
+        fprintf(out, ",%lld", value);
+    } else {
+        fprintf(out, ",");
+    }
+}
+
+static void printMemoryValueJSON(FILE* out, const char* name, long long value) {
+    if (value >= 0) {
+        fprintf(out, ",\"%s\":%lld", name, value);
+    } else {
+        fprintf(out, ",\"%s\":null", name);
+    }
+}
+
+// Rank 0 với mpi; other_* là max trên các rank còn lại
+static void printMemoryCSV(FILE* out, int is_mpi, const BenchRecord* record) {
+    const OGTMemStats* memory = &record->stats.memory;
+    fprintf(out, ",%lld,%lld,%lld", memory->bytes_allocated, memory->allocations, memory->peak_bytes);
+    printMemoryValueCSV(out, memory->peak_rss_kb);
+    if (is_mpi && record->rank_stats.num_ranks > 1) {
+        printMemoryValueCSV(out, record->rank_stats.other_memory.peak_bytes);
+        printMemoryValueCSV(out, record->rank_stats.other_memory.peak_rss_kb);
+    } else {
+        fprintf(out, ",,");
+    }
+}
+
+static void printMemoryJSON(FILE* out, int is_mpi, const BenchRecord* record) {
+    const OGTMemStats* memory = &record->stats.memory;
+    fprintf(out, ",\"memory\":{\"alloc_bytes\":%lld,\"allocs\":%lld,\"peak_bytes\":%lld",
+            memory->bytes_allocated, memory->allocations, memory->peak_bytes);
+    printMemoryValueJSON(out, "peak_rss_kb", memory->peak_rss_kb);
+    if (is_mpi && record->rank_stats.num_ranks > 1) {
+        printMemoryValueJSON(out, "other_peak_bytes", record->rank_stats.other_memory.peak_bytes);
+        printMemoryValueJSON(out, "other_rss_kb", record->rank_stats.other_memory.peak_rss_kb);
+    }
+    fprintf(out, "}");
+}
+
+// Pha không di chuyển dữ liệu trong lần chạy này để trống (CSV) hoặc null (JSON)
+static void printBandwidthCSV(FILE* out, const OGTSortStats* stats) {
+    for (int k = 0; k < BENCH_BANDWIDTH_PHASES; k++) {
+        double gbps = phaseBandwidth(stats, bandwidth_phases[k]);
+        if (gbps > 0.0) {
+            fprintf(out, ",%.4f,%.2f", gbps, phasePeakPercent(stats, bandwidth_phases[k]));
+        } else {
+            fprintf(out, ",,");
+        }
+    }
+}
+
+static void printBandwidthJSON(FILE* out, const OGTSortStats* stats) {
+    fprintf(out, ",\"bandwidth\":{");
+    for (int k = 0; k < BENCH_BANDWIDTH_PHASES; k++) {
+        double gbps = phaseBandwidth(stats, bandwidth_phases[k]);
+        fprintf(out, "%s\"%s\":", k ? "," : "", phaseName(bandwidth_phases[k]));
+        if (gbps > 0.0) {
+            fprintf(out, "{\"gbps\":%.4f,\"peak_pct\":%.2f}", gbps, phasePeakPercent(stats, bandwidth_phases[k]));
+        } else {
+            fprintf(out, "null");
+        }
+    }
+    fprintf(out, "}");
+}
+
+static void printCountersJSON(FILE* out, const OGTSortStats* stats) {
+    fprintf(out, ",\"counters\":{");
+    for (int k = 0; k < BENCH_COUNTER_PHASES; k++) {
+        const OGTCounterValues* values = &stats->phase_counters[counter_phases[k]];
+        fprintf(out, "%s\"%s\":{", k ? "," : "", phaseName(counter_phases[k]));
+        for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+            fprintf(out, "\"%s\":", counterName((OGTCounter)c));
+            if (counterValid(values, (OGTCounter)c)) {
+                fprintf(out, "%.0f,", values->value[c]);
+            } else {
+                fprintf(out, "null,");
+            }
+        }
+        if (counterIPC(values) > 0.0) {
+            fprintf(out, "\"ipc\":%.4f}", counterIPC(values));
+        } else {
+            fprintf(out, "\"ipc\":null}");
+        }
+    }
+    fprintf(out, "}");
+}
+
+static void printRecord(FILE* out, const BenchOptions* opts, int ranks, const BenchRecord* record) {
+    int threads = opts->backend == OGT_BACKEND_SEQ || opts->backend == OGT_BACKEND_MPI ? 1 : opts->threads;
+    const char* order = opts->ascending ? "asc" : "desc";
+    int is_mpi = opts->backend == OGT_BACKEND_MPI;
+    char mode[32];
+    char dist[48];
+    benchMode(opts, mode, sizeof(mode));
+    distributionSpec(opts->dist, opts->dist_param, dist, sizeof(dist));
+
+    if (opts->format == BENCH_FORMAT_CSV) {
+        fprintf(out, "%s,%s,%d,%d,%d,%s,%llu,%d,%s,%d,%d,%.9f",
+                backendName(opts->backend), mode, opts->n, threads, ranks,
+                dist, opts->seed, opts->max_val, order,
+                opts->compression, record->rep, record->time);
+        for (int p = 0; p < OGT_PHASE_COUNT; p++) {
+            fprintf(out, ",%.9f", record->stats.phase_time[p]);
+        }
+        if (is_mpi) {
+            fprintf(out, ",%.6f,%.6f", mpiLoadImbalance(&record->rank_stats),
+                    mpiCommCompRatio(&record->rank_stats));
+        } else {
+            fprintf(out, ",,");
+        }
+        printMemoryCSV(out, is_mpi, record);
+        if (opts->counters) printCountersCSV(out, &record->stats);
+        if (opts->bandwidth) printBandwidthCSV(out, &record->stats);
+        fprintf(out, ",%d\n", record->sorted);
+        return;
+    }
+
+    fprintf(out, "{\"backend\":\"%s\",\"mode\":\"%s\",\"n\":%d,\"threads\":%d,\"ranks\":%d,"
+                 "\"dist\":\"%s\",\"seed\":%llu,\"max_val\":%d,\"order\":\"%s\","
+                 "\"compress\":%s,\"rep\":%d,\"time_s\":%.9f,\"phases\":{",
+            backendName(opts->backend), mode, opts->n, threads, ranks,
+            dist, opts->seed, opts->max_val, order,
+            opts->compression ? "true" : "false", record->rep, record->time);
+    for (int p = 0; p < OGT_PHASE_COUNT; p++) {
+        fprintf(out, "%s\"%s\":%.9f", p ? "," : "", phaseName((OGTPhase)p), record->stats.phase_time[p]);
+    }
+    fprintf(out, "}");
+    if (is_mpi) {
+        fprintf(out, ",\"imbalance\":%.6f,\"comm_comp\":%.6f",
+                mpiLoadImbalance(&record->rank_stats), mpiCommCompRatio(&record->rank_stats));
+    }
+    printMemoryJSON(out, is_mpi, record);
+    if (opts->counters) printCountersJSON(out, &record->stats);
+    if (opts->bandwidth) printBandwidthJSON(out, &record->stats);
+    fprintf(out, ",\"sorted\":%s,\"version\":\"%s\"}\n",
+            record->sorted ? "true" : "false", SORT_OGT_VERSION);
+}
+
+
+// ========== CHẾ ĐỘ SO SÁNH ==========
+
+// Các trường xác định một cấu hình; bản ghi cùng cấu hình được gom thành một tập mẫu
+// Kết quả cũ chưa có mode được coi là mode sort
+static const char* compare_key_fields[] = {
+    "backend", "mode", "n", "threads", "ranks", "dist", "max_val", "order", "compress"
+};
+#define COMPARE_MODE_FIELD 1
+#define COMPARE_KEY_FIELDS (int)(sizeof(compare_key_fields) / sizeof(compare_key_fields[0]))
+
+typedef struct {
+    char key[256];
+    double* samples[2];     // [0]: tập gốc, [1]: tập mới
+    int count[2];
+    int capacity[2];
+} CompareGroup;
+
+typedef struct {
+    CompareGroup* groups;
+    int count;
+    int capacity;
+} CompareTable;
+
+static void addSample(CompareTable* table, const char* key, int side, double value) {
+    CompareGroup* group = NULL;
+    for (int g = 0; g < table->count; g++) {
+        if (strcmp(table->groups[g].key, key) == 0) {
+            group = &table->groups[g];
+            break;
+        }
+    }
+    if (!group) {
+        if (table->count == table->capacity) {
+            table->capacity = table->capacity ? table->capacity * 2 : 16;
+            table->groups = realloc(table->groups, table->capacity * sizeof(CompareGroup));
+        }
+        group = &table->groups[table->count++];
+        memset(group, 0, sizeof(*group));
+        snprintf(group->key, sizeof(group->key), "%s", key);
+    }
+    if (group->count[side] == group->capacity[side]) {
+        group->capacity[side] = group->capacity[side] ? group->capacity[side] * 2 : 16;
+        group->samples[side] = realloc(group->samples[side], group->capacity[side] * sizeof(double));
+    }
+    group->samples[side][group->count[side]++] = value;
+}
+
+// Lấy giá trị của trường name trong một dòng JSON do ogt_bench ghi ra
+static int jsonField(const char* line, const char* name, char* buf, size_t size) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", name);
+    const char* p = strstr(line, pattern);
+    if (!p) return 0;
+    p += strlen(pattern);
+
+    char end = ',';
+    if (*p == '"') {
+        end = '"';
+        p++;
+    }
+    size_t len = 0;
+    while (p[len] && p[len] != end && p[len] != '}' && len + 1 < size) len++;
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+    return 1;
+}
+
+// Tách dòng CSV tại chỗ, trả về số trường
+static int splitCSV(char* line, char* fields[]) {
+    int count = 0;
+    line[strcspn(line, "\r\n")] = '\0';
+    fields[count++] = line;
+    for (char* p = line; *p && count < COMPARE_MAX_FIELDS; p++) {
+        if (*p == ',') {
+            *p = '\0';
+            fields[count++] = p + 1;
+        }
+    }
+    return count;
+}
+
+// Đọc các bản ghi JSON hoặc CSV của ogt_bench vào bảng, trả về số bản ghi hoặc -1 nếu lỗi
+static int loadResults(const char* path, int side, CompareTable* table) {
+    FILE* in = fopen(path, "r");
+    if (!in) {
+        fprintf(stderr, RED "Không mở được file %s\n" RESET, path);
+        return -1;
+    }
+
+    char line[COMPARE_MAX_LINE];
+    char* fields[COMPARE_MAX_FIELDS];
+    int key_cols[COMPARE_KEY_FIELDS];
+    int time_col = -1;
+    int csv_header = 0;
+    int records = 0;
+
+    while (fgets(line, sizeof(line), in)) {
+        char key[256] = "";
+        char value[64];
+        double time_s;
+
+        if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0') continue;
+
+        if (line[0] == '{') {
+            if (!jsonField(line, "time_s", value, sizeof(value))) continue;
+            time_s = strtod(value, NULL);
+            for (int k = 0; k < COMPARE_KEY_FIELDS; k++) {
+                if (!jsonField(line, compare_key_fields[k], value, sizeof(value))) {
+                    snprintf(value, sizeof(value), "%s", k == COMPARE_MODE_FIELD ? "sort" : "");
+                }
+                if (strcmp(value, "true") == 0) strcpy(value, "1");
+                if (strcmp(value, "false") == 0) strcpy(value, "0");
+                size_t used = strlen(key);
+                snprintf(key + used, sizeof(key) - used, "%s%s=%s", k ? " " : "", compare_key_fields[k], value);
+            }
+        } else {
+            int count = splitCSV(line, fields);
+            if (!csv_header) {
+                // Dòng đầu tiên của CSV là tiêu đề
+                for (int k = 0; k < COMPARE_KEY_FIELDS; k++) {
+                    key_cols[k] = -1;
+                    for (int c = 0; c < count; c++) {
+                        if (strcmp(fields[c], compare_key_fields[k]) == 0) key_cols[k] = c;
+                    }
+                }
+                for (int c = 0; c < count; c++) {
+                    if (strcmp(fields[c], "time_s") == 0) time_col = c;
+                }
+                if (time_col < 0) {
+                    fprintf(stderr, RED "File %s thiếu cột time_s\n" RESET, path);
+                    fclose(in);
+                    return -1;
+                }
+                csv_header = 1;
+                continue;
+            }
+            if (time_col >= count) continue;
+            time_s = strtod(fields[time_col], NULL);
+            for (int k = 0; k < COMPARE_KEY_FIELDS; k++) {
+                const char* field = key_cols[k] >= 0 && key_cols[k] < count ? fields[key_cols[k]]
+                                  : k == COMPARE_MODE_FIELD ? "sort" : "";
+                size_t used = strlen(key);
+                snprintf(key + used, sizeof(key) - used, "%s%s=%s", k ? " " : "", compare_key_fields[k], field);
+            }
+        }
+
+        addSample(table, key, side, time_s);
+        records++;
+    }
+
+    fclose(in);
+    return records;
+}
+
+/**
+ * So sánh hai tập kết quả theo từng cấu hình
+ * @return 0 nếu không có cấu hình nào chậm đi có ý nghĩa, 1 nếu có, 2 nếu lỗi
+ */
+static int runCompare(const char* base_path, const char* new_path, double threshold) {
+    CompareTable table = {NULL, 0, 0};
+    if (loadResults(base_path, 0, &table) < 0 || loadResults(new_path, 1, &table) < 0) {
+        return 2;
+    }
+
+    printf(CYAN "=== SO SÁNH KẾT QUẢ BENCHMARK ===" RESET "\n");
+    printf("Gốc: %s\nMới: %s\n", base_path, new_path);
+    printf("Kiểm định t Welch (95%%), ngưỡng thay đổi tối thiểu %.1f%%, loại ngoại lai Tukey 1.5 IQR\n\n", threshold);
+
+    int regressions = 0, speedups = 0, unchanged = 0;
+    for (int g = 0; g < table.count; g++) {
+        CompareGroup* group = &table.groups[g];
+        printf("%s\n", group->key);
+
+        if (group->count[0] == 0 || group->count[1] == 0) {
+            printf("  " YELLOW "chỉ có trong tập %s, bỏ qua" RESET "\n", group->count[0] ? "gốc" : "mới");
+            free(group->samples[0]);
+            free(group->samples[1]);
+            continue;
+        }
+
+        OGTSampleStats base, cur;
+        computeSampleStats(group->samples[0], group->count[0], &base);
+        computeSampleStats(group->samples[1], group->count[1], &cur);
+        int verdict = compareSampleStats(&base, &cur, threshold / 100.0);
+        double change = base.mean > 0.0 ? (cur.mean - base.mean) / base.mean * 100.0 : 0.0;
+
+        printf("  gốc: trung vị %.6f s, TB %.6f ± %.6f (n=%d)\n",
+               base.median, base.mean, (base.ci_high - base.ci_low) / 2.0, base.count);
+        printf("  mới: trung vị %.6f s, TB %.6f ± %.6f (n=%d)\n",
+               cur.median, cur.mean, (cur.ci_high - cur.ci_low) / 2.0, cur.count);
+        if (verdict > 0) {
+            printf("  " GREEN "✅ TĂNG TỐC %+.2f%%" RESET "\n", change);
+            speedups++;
+        } else if (verdict < 0) {
+            printf("  " RED "❌ CHẬM ĐI %+.2f%%" RESET "\n", change);
+            regressions++;
+        } else {
+            printf("  ≈ không có thay đổi có ý nghĩa (%+.2f%%)\n", change);
+            unchanged++;
+        }
+
+        free(group->samples[0]);
+        free(group->samples[1]);
+    }
+    free(table.groups);
+
+    printf("\nTăng tốc: %d, chậm đi: %d, không đổi: %d\n", speedups, regressions, unchanged);
+    return regressions > 0 ? 1 : 0;
+}
+
+static void printSummary(const BenchOptions* opts, const double samples[], int count) {
+    OGTSampleStats stats;
+    computeSampleStats(samples, count, &stats);
+    fprintf(stderr, "%s n=%d: trung vị %.6f s, TB %.6f s, độ lệch %.6f, p95 %.6f, "
+                    "CI95 [%.6f, %.6f], ngoại lai %d/%d\n",
+            backendName(opts->backend), opts->n, stats.median, stats.mean, stats.stddev,
+            stats.p95, stats.ci_low, stats.ci_high, stats.outliers, count);
+}
+
+
+// ========== CHẾ ĐỘ MỞ RỘNG ==========
+
+static void printScalingHeader(FILE* out, const BenchOptions* opts) {
+    if (opts->format != BENCH_FORMAT_CSV || !opts->header) return;
+    fprintf(out, "backend,scaling,workers,n,n_per_worker,dist,seed,max_val,order,compress,reps,"
+                 "median_s,ci_low_s,ci_high_s,speedup,efficiency,karp_flatt,sorted\n");
+}
+
+static void printScalingRecord(FILE* out, const BenchOptions* opts, int n,
+                               const OGTSampleStats* stats, const OGTScalingPoint* point, int sorted) {
+    const char* order = opts->ascending ? "asc" : "desc";
+    const char* mode = scalingModeName((OGTScalingMode)opts->scaling);
+    char dist[48];
+    distributionSpec(opts->dist, opts->dist_param, dist, sizeof(dist));
+
+    if (opts->format == BENCH_FORMAT_CSV) {
+        fprintf(out, "%s,%s,%d,%d,%d,%s,%llu,%d,%s,%d,%d,%.9f,%.9f,%.9f,%.4f,%.4f,",
+                backendName(opts->backend), mode, point->workers, n, n / point->workers,
+                dist, opts->seed, opts->max_val, order, opts->compression,
+                opts->reps, point->time, stats->ci_low, stats->ci_high,
+                point->speedup, point->efficiency);
+        // Karp–Flatt không xác định với 1 worker
+        if (point->workers > 1) fprintf(out, "%.6f", point->karp_flatt);
+        fprintf(out, ",%d\n", sorted);
+        return;
+    }
+
+    fprintf(out, "{\"backend\":\"%s\",\"scaling\":\"%s\",\"workers\":%d,\"n\":%d,\"n_per_worker\":%d,"
+                 "\"dist\":\"%s\",\"seed\":%llu,\"max_val\":%d,\"order\":\"%s\",\"compress\":%s,"
+                 "\"reps\":%d,\"median_s\":%.9f,\"ci_low_s\":%.9f,\"ci_high_s\":%.9f,"
+                 "\"speedup\":%.4f,\"efficiency\":%.4f,",
+            backendName(opts->backend), mode, point->workers, n, n / point->workers,
+            dist, opts->seed, opts->max_val, order,
+            opts->compression ? "true" : "false", opts->reps, point->time,
+            stats->ci_low, stats->ci_high, point->speedup, point->efficiency);
+    if (point->workers > 1) {
+        fprintf(out, "\"karp_flatt\":%.6f", point->karp_flatt);
+    } else {
+        fprintf(out, "\"karp_flatt\":null");
+    }
+    fprintf(out, ",\"sorted\":%s,\"version\":\"%s\"}\n", sorted ? "true" : "false", SORT_OGT_VERSION);
+}
+
+/**
+ * Đo một điểm mở rộng: warmup + reps lần sắp xếp cùng dữ liệu
+ * Với mpi chỉ các rank trong communicator sắp xếp hiện tại gọi hàm này
+ * @return Số lần chạy cho kết quả chưa sắp xếp (hợp lệ tại rank 0)
+ */
+static int runScalingPoint(const BenchOptions* opts, int rank, int input[], int work[],
+                           double samples[]) {
+    int failures = 0;
+    for (int i = 0; i < opts->warmup + opts->reps; i++) {
+        BenchRecord record;
+        memset(&record, 0, sizeof(record));
+        record.rep = i - opts->warmup;
+
+        if (rank == 0) copyArray(input, work, opts->n);
+        runOnce(opts, work, &record, NULL);
+
+        if (rank != 0 || record.rep < 0) continue;
+        samples[record.rep] = record.time;
+        if (!checkSorted(work, opts->n, opts->ascending)) failures++;
+    }
+    return failures;
+}
+
+/**
+ * Nghiên cứu mở rộng strong/weak qua 1, 2, 4, ... worker, thêm max_workers nếu không là lũy thừa 2
+ * openmp/pthreads: worker là luồng, tối đa -t; mpi: worker là rank, tối đa -np
+ * (mỗi điểm dùng communicator gồm các rank 0..p-1, các rank còn lại chờ)
+ * @return Số lần chạy cho kết quả chưa sắp xếp, -1 nếu lỗi
+ */
+static int runScaling(const BenchOptions* base, int rank, int world_size, FILE* out) {
+    OGTScalingMode mode = (OGTScalingMode)base->scaling;
+    int is_mpi = base->backend == OGT_BACKEND_MPI;
+    int max_workers = is_mpi ? world_size : base->threads;
+    int max_n = mode == OGT_SCALING_WEAK ? 0 : base->n;
+
+    if (mode == OGT_SCALING_WEAK) {
+        if ((long long)base->n * max_workers > INT_MAX) {
+            if (rank == 0) fprintf(stderr, RED "n × số worker vượt quá giới hạn int\n" RESET);
+            return -1;
+        }
+        max_n = base->n * max_workers;
+    }
+
+    int* input = NULL;
+    int* work = NULL;
+    double* samples = malloc((size_t)base->reps * sizeof(double));
+    if (rank == 0) {
+        input = malloc((size_t)max_n * sizeof(int));
+        work = malloc((size_t)max_n * sizeof(int));
+        if (!input || !work) {
+            fprintf(stderr, RED "Không đủ bộ nhớ cho %d phần tử\n" RESET, max_n);
+#ifdef HAVE_MPI
+            MPI_Abort(MPI_COMM_WORLD, 1);
+#endif
+            return -1;
+        }
+        printScalingHeader(out, base);
+    }
+
+    int failures = 0;
+    double base_time = 0.0;
+
+    for (int p = 1; ; p = p * 2 < max_workers ? p * 2 : max_workers) {
+        BenchOptions opts = *base;
+        opts.threads = p;
+        opts.n = mode == OGT_SCALING_WEAK ? base->n * p : base->n;
+
+        // Weak scaling cần dữ liệu mới cho mỗi kích thước
+        if (rank == 0) {
+            generateDistributionArrayParam(input, opts.n, opts.max_val, opts.dist, opts.dist_param, opts.seed);
+        }
+
+        int point_failures = 0;
+
+#ifdef HAVE_MPI
+        MPI_Comm comm = MPI_COMM_NULL;
+        if (is_mpi) {
+            MPI_Comm_split(MPI_COMM_WORLD, rank < p ? 0 : MPI_UNDEFINED, rank, &comm);
+            if (comm != MPI_COMM_NULL) {
+                setMPICommunicator(comm);
+                point_failures = runScalingPoint(&opts, rank, input, work, samples);
+                setMPICommunicator(MPI_COMM_NULL);
+                MPI_Comm_free(&comm);
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+        } else
+#endif
+        if (rank == 0) {
+            point_failures = runScalingPoint(&opts, rank, input, work, samples);
+        }
+        failures += point_failures;
+
+        if (rank == 0) {
+            OGTSampleStats stats;
+            OGTScalingPoint point;
+            computeSampleStats(samples, opts.reps, &stats);
+            if (p == 1) base_time = stats.median;
+            computeScalingPoint(mode, p, base_time, stats.median, &point);
+            printScalingRecord(out, &opts, opts.n, &stats, &point, point_failures == 0);
+            fflush(out);
+
+            if (opts.summary) {
+                fprintf(stderr, "%s %s p=%d n=%d: trung vị %.6f s, speedup %.3f, hiệu suất %.1f%%, "
+                                "Karp–Flatt %.4f\n",
+                        backendName(opts.backend), scalingModeName(mode), p, opts.n,
+                        point.time, point.speedup, point.efficiency * 100.0, point.karp_flatt);
+            }
+        }
+        if (p == max_workers) break;
+    }
+
+    free(samples);
+    free(input);
+    free(work);
+    return failures;
+}
+
+// ========== CHẾ ĐỘ FILE ==========
+
+static void printFileHeader(FILE* out, const BenchOptions* opts) {
+    if (opts->format != BENCH_FORMAT_CSV || !opts->header) return;
+    fprintf(out, "backend,key,n,threads,ranks,order,in_place,populate,huge_pages,rep,time_s,"
+                 "map_s,copy_s,sort_s,sync_s,alloc_bytes,peak_rss_kb,sorted\n");
+}
+
+static void printFileRecord(FILE* out, const BenchOptions* opts, int ranks, int rep,
+                            const OGTFileSortStats* stats, int sorted) {
+    int threads = opts->backend == OGT_BACKEND_SEQ || opts->backend == OGT_BACKEND_MPI ? 1 : opts->threads;
+    const char* order = opts->ascending ? "asc" : "desc";
+    int in_place = opts->file_output == NULL;
+    int populate = (opts->mmap_flags & OGT_MMAP_POPULATE) != 0;
+    int huge_pages = (opts->mmap_flags & OGT_MMAP_HUGE_PAGES) != 0;
+    const OGTMemStats* memory = &stats->sort_stats.memory;
+
+    if (opts->format == BENCH_FORMAT_CSV) {
+        fprintf(out, "%s,%s,%lld,%d,%d,%s,%d,%d,%d,%d,%.9f,%.9f,%.9f,%.9f,%.9f,%lld",
+                backendName(opts->backend), keyTypeName(opts->key), stats->n, threads, ranks, order,
+                in_place, populate, huge_pages, rep, stats->total_time,
+                stats->map_time, stats->copy_time, stats->sort_time, stats->sync_time,
+                memory->bytes_allocated);
+        printMemoryValueCSV(out, memory->peak_rss_kb);
+        fprintf(out, ",%d\n", sorted);
+        return;
+    }
+
+    fprintf(out, "{\"backend\":\"%s\",\"key\":\"%s\",\"n\":%lld,\"threads\":%d,\"ranks\":%d,"
+                 "\"order\":\"%s\",\"in_place\":%s,\"populate\":%s,\"huge_pages\":%s,\"rep\":%d,"
+                 "\"time_s\":%.9f,\"map_s\":%.9f,\"copy_s\":%.9f,\"sort_s\":%.9f,\"sync_s\":%.9f,"
+                 "\"alloc_bytes\":%lld",
+            backendName(opts->backend), keyTypeName(opts->key), stats->n, threads, ranks, order,
+            in_place ? "true" : "false", populate ? "true" : "false", huge_pages ? "true" : "false",
+            rep, stats->total_time, stats->map_time, stats->copy_time, stats->sort_time, stats->sync_time,
+            memory->bytes_allocated);
+    printMemoryValueJSON(out, "peak_rss_kb", memory->peak_rss_kb);
+    fprintf(out, ",\"sorted\":%s,\"version\":\"%s\"}\n", sorted ? "true" : "false", SORT_OGT_VERSION);
+}
+
+static void printExternalHeader(FILE* out, const BenchOptions* opts) {
+    if (opts->format != BENCH_FORMAT_CSV || !opts->header) return;
+    fprintf(out, "backend,key,n,threads,ranks,order,budget_mb,runs,fanin,passes,rep,time_s,run_s,merge_s,"
+                 "io_wait_s,read_mb,written_mb,peak_bytes,peak_rss_kb,sorted\n");
+}
+
+static void printExternalRecord(FILE* out, const BenchOptions* opts, int ranks, int rep,
+                                const OGTExternalSortStats* stats, int sorted) {
+    int threads = opts->backend == OGT_BACKEND_SEQ || opts->backend == OGT_BACKEND_MPI ? 1 : opts->threads;
+    const char* order = opts->ascending ? "asc" : "desc";
+    double budget_mb = opts->memory_budget / (1024.0 * 1024.0);
+    double read_mb = stats->bytes_read / (1024.0 * 1024.0);
+    double written_mb = stats->bytes_written / (1024.0 * 1024.0);
+
+    if (opts->format == BENCH_FORMAT_CSV) {
+        fprintf(out, "%s,%s,%lld,%d,%d,%s,%.0f,%d,%d,%d,%d,%.9f,%.9f,%.9f,%.9f,%.2f,%.2f,%lld",
+                backendName(opts->backend), keyTypeName(opts->key), stats->n, threads, ranks, order,
+                budget_mb, stats->runs, stats->fanin, stats->merge_passes, rep, stats->total_time,
+                stats->run_time, stats->merge_time, stats->io_wait_time, read_mb, written_mb,
+                stats->memory.peak_bytes);
+        printMemoryValueCSV(out, stats->memory.peak_rss_kb);
+        fprintf(out, ",%d\n", sorted);
+        return;
+    }
+
+    fprintf(out, "{\"backend\":\"%s\",\"key\":\"%s\",\"n\":%lld,\"threads\":%d,\"ranks\":%d,"
+                 "\"order\":\"%s\",\"budget_mb\":%.0f,\"runs\":%d,\"fanin\":%d,\"passes\":%d,\"rep\":%d,"
+                 "\"time_s\":%.9f,\"run_s\":%.9f,\"merge_s\":%.9f,\"io_wait_s\":%.9f,"
+                 "\"read_mb\":%.2f,\"written_mb\":%.2f,\"peak_bytes\":%lld",
+            backendName(opts->backend), keyTypeName(opts->key), stats->n, threads, ranks, order,
+            budget_mb, stats->runs, stats->fanin, stats->merge_passes, rep, stats->total_time,
+            stats->run_time, stats->merge_time, stats->io_wait_time, read_mb, written_mb,
+            stats->memory.peak_bytes);
+    printMemoryValueJSON(out, "peak_rss_kb", stats->memory.peak_rss_kb);
+    fprintf(out, ",\"sorted\":%s,\"version\":\"%s\"}\n", sorted ? "true" : "false", SORT_OGT_VERSION);
+}
+
+static void printTextHeader(FILE* out, const BenchOptions* opts) {
+    if (opts->format != BENCH_FORMAT_CSV || !opts->header) return;
+    fprintf(out, "backend,key,n,threads,ranks,order,in_place,rep,time_s,parse_s,sort_s,format_s,"
+                 "parse_mbps,format_mbps,alloc_bytes,peak_rss_kb,sorted\n");
+}
+
+static void printTextRecord(FILE* out, const BenchOptions* opts, int ranks, int rep,
+                            const OGTTextSortStats* stats, int sorted) {
+    int threads = opts->backend == OGT_BACKEND_SEQ || opts->backend == OGT_BACKEND_MPI ? 1 : opts->threads;
+    const char* order = opts->ascending ? "asc" : "desc";
+    int in_place = opts->file_output == NULL;
+    double parse_mbps = stats->parse_time > 0 ? stats->bytes_read / stats->parse_time / 1e6 : 0.0;
+    double format_mbps = stats->format_time > 0 ? stats->bytes_written / stats->format_time / 1e6 : 0.0;
+
+    if (opts->format == BENCH_FORMAT_CSV) {
+        fprintf(out, "%s,%s,%lld,%d,%d,%s,%d,%d,%.9f,%.9f,%.9f,%.9f,%.1f,%.1f,%lld",
+                backendName(opts->backend), keyTypeName(opts->key), stats->n, threads, ranks, order,
+                in_place, rep, stats->total_time, stats->parse_time, stats->sort_time,
+                stats->format_time, parse_mbps, format_mbps, stats->memory.bytes_allocated);
+        printMemoryValueCSV(out, stats->memory.peak_rss_kb);
+        fprintf(out, ",%d\n", sorted);
+        return;
+    }
+
+    fprintf(out, "{\"backend\":\"%s\",\"key\":\"%s\",\"n\":%lld,\"threads\":%d,\"ranks\":%d,"
+                 "\"order\":\"%s\",\"in_place\":%s,\"rep\":%d,\"time_s\":%.9f,\"parse_s\":%.9f,"
+                 "\"sort_s\":%.9f,\"format_s\":%.9f,\"parse_mbps\":%.1f,\"format_mbps\":%.1f,"
+                 "\"alloc_bytes\":%lld",
+            backendName(opts->backend), keyTypeName(opts->key), stats->n, threads, ranks, order,
+            in_place ? "true" : "false", rep, stats->total_time, stats->parse_time, stats->sort_time,
+            stats->format_time, parse_mbps, format_mbps, stats->memory.bytes_allocated);
+    printMemoryValueJSON(out, "peak_rss_kb", stats->memory.peak_rss_kb);
+    fprintf(out, ",\"sorted\":%s,\"version\":\"%s\"}\n", sorted ? "true" : "false", SORT_OGT_VERSION);
+}
+
+/**
+ * Sắp xếp file (mmap, ngoài hoặc văn bản): warmup + reps lần với --file-out, một lần nếu tại chỗ
+ * Với mpi mọi rank gọi; các backend khác chỉ rank 0
+ * @return Số lần chạy cho kết quả chưa sắp xếp, -1 nếu lỗi
+ */
+static int runFileSort(const BenchOptions* opts, int rank, int ranks, FILE* out) {
+    int runs = opts->warmup + opts->reps;
+    int warmup = opts->warmup;
+    if (!opts->file_output) {
+        // Lần chạy sau sẽ sắp xếp dữ liệu đã sắp xếp
+        runs = 1;
+        warmup = 0;
+    }
+
+    OGTExternalSortOptions external;
+    defaultExternalSortOptions(&external);
+    external.memory_budget = opts->memory_budget;
+    external.temp_dir = opts->temp_dir;
+    external.backend = opts->backend;
+    external.num_threads = opts->threads;
+    external.ascending = opts->ascending;
+    external.key = opts->key;
+
+    if (rank == 0) {
+        if (opts->external) {
+            printExternalHeader(out, opts);
+        } else if (opts->text) {
+            printTextHeader(out, opts);
+        } else {
+            printFileHeader(out, opts);
+        }
+    }
+
+    int failures = 0;
+    for (int i = 0; i < runs; i++) {
+        OGTFileSortStats stats;
+        OGTExternalSortStats external_stats;
+        OGTTextSortStats text_stats;
+        int status;
+        if (opts->external) {
+            status = externalSortFile(opts->file_input, opts->file_output, &external, &external_stats);
+        } else if (opts->text) {
+            status = sortTextFile(opts->file_input, opts->file_output, opts->key, opts->backend,
+                                  opts->threads, opts->ascending, &text_stats);
+        } else {
+            status = sortFile(opts->file_input, opts->file_output, opts->key, opts->backend,
+                              opts->threads, opts->ascending, opts->mmap_flags, &stats);
+        }
+        if (status != 0) return -1;
+        if (rank != 0 || i < warmup) continue;
+
+        const char* result = opts->file_output ? opts->file_output : opts->file_input;
+        int sorted = (opts->text ? textFileIsSorted(result, opts->key, opts->ascending)
+                                 : fileIsSorted(result, opts->key, opts->ascending)) == 1;
+        if (!sorted) failures++;
+        if (opts->external) {
+            printExternalRecord(out, opts, ranks, i - warmup, &external_stats, sorted);
+        } else if (opts->text) {
+            printTextRecord(out, opts, ranks, i - warmup, &text_stats, sorted);
+        } else {
+            printFileRecord(out, opts, ranks, i - warmup, &stats, sorted);
+        }
+        fflush(out);
+    }
+    return failures;
+}
+
+static void printStreamHeader(FILE* out, const BenchOptions* opts) {
+    if (opts->format != BENCH_FORMAT_CSV || !opts->header) return;
+    fprintf(out, "workers,n,order,text,run_size,rep,time_s,ingest_s,finish_s,worker_s,runs,merges,"
+                 "final_runs,alloc_bytes,peak_rss_kb,sorted\n");
+}
+
+static void printStreamRecord(FILE* out, const BenchOptions* opts, int run_size, int rep,
+                              const OGTStreamSortStats* stats, int sorted) {
+    const char* order = opts->ascending ? "asc" : "desc";
+
+    if (opts->format == BENCH_FORMAT_CSV) {
+        fprintf(out, "%d,%lld,%s,%d,%d,%d,%.9f,%.9f,%.9f,%.9f,%d,%d,%d,%lld",
+                opts->threads, stats->n, order, opts->text, run_size, rep, stats->total_time,
+                stats->ingest_time, stats->finish_time, stats->worker_time, stats->runs,
+                stats->merges, stats->final_runs, stats->memory.bytes_allocated);
+        printMemoryValueCSV(out, stats->memory.peak_rss_kb);
+        fprintf(out, ",%d\n", sorted);
+        return;
+    }
+
+    fprintf(out, "{\"workers\":%d,\"n\":%lld,\"order\":\"%s\",\"text\":%s,\"run_size\":%d,\"rep\":%d,"
+                 "\"time_s\":%.9f,\"ingest_s\":%.9f,\"finish_s\":%.9f,\"worker_s\":%.9f,"
+                 "\"runs\":%d,\"merges\":%d,\"final_runs\":%d,\"alloc_bytes\":%lld",
+            opts->threads, stats->n, order, opts->text ? "true" : "false", run_size, rep,
+            stats->total_time, stats->ingest_time, stats->finish_time, stats->worker_time,
+            stats->runs, stats->merges, stats->final_runs, stats->memory.bytes_allocated);
+    printMemoryValueJSON(out, "peak_rss_kb", stats->memory.peak_rss_kb);
+    fprintf(out, ",\"sorted\":%s,\"version\":\"%s\"}\n", sorted ? "true" : "false", SORT_OGT_VERSION);
+}
+
+// Ghi kết quả --stream ra --file-out (văn bản hoặc int32 little-endian)
+static int writeStreamOutput(const BenchOptions* opts, int* keys, int n) {
+    if (opts->text) return writeTextKeys(opts->file_output, keys, n, OGT_KEY_INT32, opts->threads);
+
+    FILE* file = fopen(opts->file_output, "wb");
+    if (!file) {
+        fprintf(stderr, RED "Không tạo được file %s\n" RESET, opts->file_output);
+        return -1;
+    }
+    swapKeyBytes(keys, (size_t)n, OGT_KEY_INT32);
+    size_t written = fwrite(keys, sizeof(int), (size_t)n, file);
+    swapKeyBytes(keys, (size_t)n, OGT_KEY_INT32);
+    return fclose(file) == 0 && written == (size_t)n ? 0 : -1;
+}
+
+/**
+ * Sắp xếp dạng luồng từ --file hoặc stdin: warmup + reps lần, một lần với stdin
+ * @return Số lần chạy cho kết quả chưa sắp xếp, -1 nếu lỗi
+ */
+static int runStreamSort(const BenchOptions* opts, FILE* out) {
+    int from_stdin = strcmp(opts->file_input, "-") == 0;
+    int runs = from_stdin ? 1 : opts->warmup + opts->reps;
+    int warmup = from_stdin ? 0 : opts->warmup;
+    int run_size = opts->run_size > 0 ? opts->run_size : OGT_STREAM_DEFAULT_RUN;
+
+    printStreamHeader(out, opts);
+    int failures = 0;
+    for (int i = 0; i < runs; i++) {
+        int fd = from_stdin ? STDIN_FILENO : open(opts->file_input, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, RED "Không mở được file %s\n" RESET, opts->file_input);
+            return -1;
+        }
+
+        OGTStreamSort* stream = streamSortCreate(opts->threads, run_size, opts->ascending);
+        int status = stream ? streamSortReadFd(stream, fd, opts->text) : -1;
+        if (!from_stdin) close(fd);
+
+        int* keys = NULL;
+        int n = 0;
+        OGTStreamSortStats stats;
+        if (status == 0) status = streamSortFinish(stream, &keys, &n, &stats);
+        streamSortDestroy(stream);
+        if (status == 0 && opts->file_output && i == runs - 1) status = writeStreamOutput(opts, keys, n);
+        if (status != 0) {
+            ogtFree(keys);
+            return -1;
+        }
+
+        if (i >= warmup) {
+            int sorted = checkSorted(keys, n, opts->ascending);
+            if (!sorted) failures++;
+            printStreamRecord(out, opts, run_size, i - warmup, &stats, sorted);
+            fflush(out);
+        }
+        ogtFree(keys);
+    }
+    return failures;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opts = {
+        .backend = OGT_BACKEND_OPENMP,
+        .n = BENCH_DEFAULT_SIZE,
+        .threads = omp_get_max_threads(),
+        .dist = OGT_DIST_UNIFORM,
+        .dist_param = OGT_DIST_DEFAULT_PARAM,
+        .reps = BENCH_DEFAULT_REPS,
+        .warmup = BENCH_DEFAULT_WARMUP,
+        .seed = getRandomSeed(),
+        .max_val = BENCH_DEFAULT_MAX_VALUE,
+        .ascending = 1,
+        .compression = 0,
+        .format = BENCH_FORMAT_JSON,
+        .header = 1,
+        .summary = 0,
+        .counters = 0,
+        .scaling = -1,
+        .trace = NULL,
+        .bandwidth = 0,
+        .auto_select = 0,
+        .latency = 0,
+        .segments = 0,
+        .insert = 0,
+        .objective = OGT_OBJECTIVE_LATENCY,
+        .file_input = NULL,
+        .file_output = NULL,
+        .key = OGT_KEY_INT32,
+        .mmap_flags = 0,
+        .external = 0,
+        .memory_budget = OGT_EXTERNAL_DEFAULT_BUDGET,
+        .temp_dir = NULL,
+        .text = 0,
+        .stream = 0,
+        .run_size = 0,
+        .output = NULL,
+        .compare_base = NULL,
+        .threshold = BENCH_DEFAULT_THRESHOLD
+    };
+
+    const char* seed_env = getenv("OGT_SEED");
+    if (seed_env && *seed_env) {
+        opts.seed = strtoull(seed_env, NULL, 0);
+    }
+
+    int parsed = parseOptions(argc, argv, &opts);
+    if (parsed != 0) {
+        return parsed > 0 ? 0 : 2;
+    }
+
+    if (opts.compare_base) {
+        return runCompare(opts.compare_base, argv[optind], opts.threshold);
+    }
+
+    int rank = 0, ranks = 1;
+#ifdef HAVE_MPI
+    if (initializeMPI(argc, argv) != 0) {
+        return 1;
+    }
+    getMPIInfo(&rank, &ranks);
+    setMPICompression(opts.compression);
+#else
+    if (opts.backend == OGT_BACKEND_MPI) {
+        fprintf(stderr, RED "Backend mpi không khả dụng - MPI chưa được biên dịch\n" RESET);
+        return 2;
+    }
+#endif
+
+    if (opts.counters) {
+        setHardwareCounters(1);
+        if (rank == 0 && hardwareCountersAvailable() == 0) {
+            fprintf(stderr, YELLOW "Cảnh báo: không mở được bộ đếm phần cứng (perf_event_open), "
+                            "các cột bộ đếm sẽ để trống\n" RESET);
+        }
+    }
+
+    if (opts.scaling >= 0 && opts.backend == OGT_BACKEND_SEQ) {
+        if (rank == 0) fprintf(stderr, RED "--scaling cần backend song song (openmp, pthreads, mpi)\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+
+    if ((opts.external || opts.text || opts.stream) && !opts.file_input) {
+        if (rank == 0) fprintf(stderr, RED "--external, --text và --stream cần --file\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+
+    if (opts.auto_select && (opts.backend == OGT_BACKEND_MPI || opts.scaling >= 0 || opts.file_input)) {
+        if (rank == 0) fprintf(stderr, RED "--auto không dùng chung với -b mpi, --scaling hoặc --file\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+
+    if (opts.latency && (opts.backend == OGT_BACKEND_MPI || opts.backend == OGT_BACKEND_SEQ ||
+                         opts.auto_select || opts.scaling >= 0 || opts.file_input)) {
+        if (rank == 0) fprintf(stderr, RED "--latency không dùng chung với -b seq/mpi, --auto, --scaling hoặc --file\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+    if (opts.segments > 0 && ((opts.backend != OGT_BACKEND_OPENMP && opts.backend != OGT_BACKEND_SEQ) ||
+                              opts.latency || opts.auto_select || opts.scaling >= 0 || opts.file_input ||
+                              opts.segments > opts.n)) {
+        if (rank == 0) fprintf(stderr, RED "--segments cần -b openmp hoặc seq, K <= -n, và không dùng chung với "
+                                           "--latency, --auto, --scaling hoặc --file\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+
+    if (opts.insert > 0 && ((opts.backend != OGT_BACKEND_OPENMP && opts.backend != OGT_BACKEND_SEQ) ||
+                            opts.latency || opts.segments > 0 || opts.auto_select || opts.scaling >= 0 ||
+                            opts.file_input || opts.insert > opts.n)) {
+        if (rank == 0) fprintf(stderr, RED "--insert cần -b openmp hoặc seq, M <= -n, và không dùng chung với "
+                                           "--latency, --segments, --auto, --scaling hoặc --file\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+
+    // Nhóm worker là pthread: ghi kết quả dưới backend pthreads
+    if (opts.latency) opts.backend = OGT_BACKEND_PTHREADS;
+
+    if (opts.stream && (opts.external || opts.key != OGT_KEY_INT32)) {
+        if (rank == 0) fprintf(stderr, RED "--stream chỉ hỗ trợ khóa int32 và không dùng chung với --external\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+
+    if (opts.external && opts.text) {
+        if (rank == 0) fprintf(stderr, RED "--external chỉ hỗ trợ file nhị phân\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+
+    if (opts.file_input && opts.scaling >= 0) {
+        if (rank == 0) fprintf(stderr, RED "--file không dùng chung với --scaling\n" RESET);
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 2;
+    }
+
+    // -t là số luồng cần đo: governor không được cắt xuống số lõi (--auto đo đúng như ogt_sort)
+    if (!opts.auto_select && opts.threads > concurrencyLimit()) setConcurrencyLimit(opts.threads);
+
+    // Các backend không phải MPI chỉ chạy trên rank 0
+    int active = opts.backend == OGT_BACKEND_MPI || rank == 0;
+    if (opts.backend != OGT_BACKEND_MPI) ranks = 1;
+
+    FILE* out = stdout;
+    int failures = 0;
+
+    if (rank == 0 && opts.output) {
+        out = fopen(opts.output, "a");
+        if (!out) {
+            fprintf(stderr, RED "Không mở được file %s\n" RESET, opts.output);
+            failures = -1;
+        } else if (fseek(out, 0, SEEK_END) == 0 && ftell(out) > 0) {
+            // Đã có dữ liệu: không lặp lại dòng tiêu đề CSV
+            opts.header = 0;
+        }
+    }
+#ifdef HAVE_MPI
+    MPI_Bcast(&failures, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+    if (failures < 0) {
+#ifdef HAVE_MPI
+        finalizeMPI();
+#endif
+        return 1;
+    }
+
+    // Đo băng thông đỉnh trước khi benchmark để không xen vào giữa các lần đo
+    if (opts.bandwidth && rank == 0) {
+        peakBandwidth(0);
+        peakBandwidth(1);
+    }
+
+    // Hàm tập thể với MPI: mọi rank bật trace cùng lúc
+    if (opts.trace && traceStart(opts.trace) != 0) {
+        if (rank == 0) fprintf(stderr, RED "Đường dẫn trace không hợp lệ: %s\n" RESET, opts.trace);
+        opts.trace = NULL;
+    }
+
+    if (opts.scaling >= 0) {
+        failures = runScaling(&opts, rank, ranks, out);
+        active = 0;
+    }
+
+    if (opts.file_input) {
+        if (opts.stream) {
+            // Stream sort chạy cục bộ trên rank 0
+            if (rank == 0) failures = runStreamSort(&opts, out);
+        } else if (active) {
+            failures = runFileSort(&opts, rank, ranks, out);
+        }
+        active = 0;
+    }
+
+    if (active) {
+        int* input = malloc((size_t)opts.n * sizeof(int));
+        int* work = malloc((size_t)opts.n * sizeof(int));
+        if (!input || !work) {
+            fprintf(stderr, RED "Không đủ bộ nhớ cho %d phần tử\n" RESET, opts.n);
+#ifdef HAVE_MPI
+            MPI_Abort(MPI_COMM_WORLD, 1);
+#endif
+            return 1;
+        }
+
+        double* samples = malloc((size_t)opts.reps * sizeof(double));
+        BenchRuntime runtime = { NULL, NULL };
+
+        // Mọi lần chạy dùng cùng một dữ liệu đầu vào để kết quả so sánh được
+        if (rank == 0) {
+            generateDistributionArrayParam(input, opts.n, opts.max_val, opts.dist, opts.dist_param, opts.seed);
+            if (opts.auto_select) {
+                // Kế hoạch in ra để tham khảo; mỗi lần đo gọi ogt_sort, tự lập lại kế hoạch
+                OGTSortOptions sort_opts;
+                OGTSortPlan plan;
+                ogt_sort_default_options(&sort_opts);
+                sort_opts.objective = opts.objective;
+                sort_opts.ascending = opts.ascending;
+                ogt_sort_plan(input, opts.n, &sort_opts, &plan);
+                opts.backend = plan.backend;
+                opts.threads = plan.threads;
+                fprintf(stderr, "auto (%s): %s x %d, dự đoán %.6f s (%.6f lõi*s), nghịch thế %.2f\n",
+                        objectiveName(opts.objective), backendName(plan.backend), plan.threads,
+                        plan.predicted_time, plan.predicted_cost, plan.inversion_ratio);
+            }
+            if (opts.latency) {
+                // Ngưỡng hòa vốn đo một lần khi tạo nhóm, ngoài các lần đo
+                runtime.pool = latencyPoolCreate(opts.threads, 0, -1);
+            }
+            if (runtime.pool) {
+                opts.threads = latencyPoolWorkers(runtime.pool);
+                int break_even = latencyPoolBreakEven(runtime.pool);
+                if (break_even == INT_MAX) {
+                    fprintf(stderr, "latency: %d worker, song song không có lợi trên máy này, luôn tuần tự\n",
+                            opts.threads);
+                } else {
+                    fprintf(stderr, "latency: %d worker, song song từ n >= %d\n", opts.threads, break_even);
+                }
+            }
+            printHeader(out, &opts);
+        }
+
+        if (opts.segments > 0 && rank == 0) {
+            runtime.offsets = makeSegmentOffsets(opts.n, opts.segments, opts.seed);
+            if (runtime.offsets) {
+                long long largest = 0;
+                for (int s = 0; s < opts.segments; s++) {
+                    long long size = runtime.offsets[s + 1] - runtime.offsets[s];
+                    if (size > largest) largest = size;
+                }
+                fprintf(stderr, "segments: %d đoạn, trung bình %.1f, lớn nhất %lld phần tử\n",
+                        opts.segments, (double)opts.n / opts.segments, largest);
+            } else {
+                fprintf(stderr, RED "Không đủ bộ nhớ cho %d đoạn\n" RESET, opts.segments);
+                failures = -1;
+            }
+        }
+        if (opts.insert > 0 && rank == 0) {
+            // Phần nền sắp xếp một lần, ngoài các lần đo
+            OGTSortOptions sort_opts;
+            ogt_sort_default_options(&sort_opts);
+            sort_opts.ascending = opts.ascending;
+            if (ogt_sort(input, opts.n - opts.insert, &sort_opts) != 0) failures = -1;
+            fprintf(stderr, "insert: lô %d khóa vào %d khóa đã sắp xếp\n", opts.insert, opts.n - opts.insert);
+        }
+        if (opts.latency && rank == 0 && !runtime.pool) failures = -1;
+
+        for (int i = 0; failures >= 0 && i < opts.warmup + opts.reps; i++) {
+            BenchRecord record;
+            memset(&record, 0, sizeof(record));
+            record.rep = i - opts.warmup;
+
+            if (rank == 0) copyArray(input, work, opts.n);
+            runOnce(&opts, work, &record, &runtime);
+
+            if (rank != 0 || record.rep < 0) continue;
+
+            samples[record.rep] = record.time;
+            record.sorted = runtime.offsets ? checkSegmentsSorted(work, runtime.offsets, opts.segments, opts.ascending)
+                                            : checkSorted(work, opts.n, opts.ascending);
+            if (!record.sorted) failures++;
+            printRecord(out, &opts, ranks, &record);
+            fflush(out);
+        }
+
+        if (rank == 0 && opts.summary && failures >= 0) printSummary(&opts, samples, opts.reps);
+
+        latencyPoolDestroy(runtime.pool);
+        free(runtime.offsets);
+        free(samples);
+        free(input);
+        free(work);
+    }
+
+    if (out != stdout) fclose(out);
+
+    if (opts.trace && traceStop() != 0 && failures == 0) failures = -1;
+
+#ifdef HAVE_MPI
+    finalizeMPI();
+#endif
+
+    if (failures < 0) return 2;
+    if (failures > 0) {
+        fprintf(stderr, RED "%d lần chạy cho kết quả chưa sắp xếp\n" RESET, failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <omp.h>
+#include "sort_ogt.h"
+
+/**
+ * ogt_tune - tinh chỉnh ngoại tuyến các ngưỡng của thư viện trên máy hiện tại
+ *
+ * Tìm kiếm theo tọa độ (mỗi lần đổi một tham số, giữ các tham số còn lại) ở kích thước n:
+ * số luồng, hệ số chia khối, cỡ khối tối đa và cách trộn; sau đó tìm điểm giao giữa sắp xếp
+ * tuần tự và OpenMP cho ngưỡng tuần tự, và số lần đo cần cho benchmark từ độ nhiễu của máy.
+ * Mỗi cấu hình được đo bằng trung vị của cả backend OpenMP và Pthreads (dùng chung hồ sơ).
+ * Kết quả ghi vào hồ sơ của máy (tuningProfilePath) hoặc file chỉ định bằng -o.
+ *
+ * Cách dùng: ogt_tune [-n N] [-t max_luồng] [-r lần_đo] [-o file] [--dry-run]
+ */
+
+#define TUNE_DEFAULT_N      50000
+#define TUNE_DEFAULT_REPS   5
+#define TUNE_MAX_REPS       31
+#define TUNE_MAX_VALUE      1000000
+#define TUNE_NOISE_REPS     15
+#define TUNE_CI_TARGET      0.02    // nửa khoảng tin cậy mong muốn, tỉ lệ với trung bình
+#define TUNE_MIN_GAIN       0.03    // cải thiện tối thiểu để đổi tham số
+
+static const int chunk_factors[] = { 1, 2, 4, 8, 16 };
+static const int block_sizes[] = { 0, 256, 1024, 4096, 16384 };
+static const int cutoff_sizes[] = { 128, 256, 512, 1024, 2048, 4096, 8192, 16384 };
+
+#define COUNT_OF(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+typedef struct {
+    int* input;
+    int* work;
+    int n;
+    int reps;
+} TuneData;
+
+static int checkSorted(const int a[], int n) {
+    for (int i = 1; i < n; i++) {
+        if (a[i - 1] > a[i]) return 0;
+    }
+    return 1;
+}
+
+// Trung vị thời gian (giây) của sort trên n phần tử đầu với cấu hình tuning, có một lần khởi động
+static double measureSort(TuneData* d, int n, const OGTTuning* tuning, OGTBackend backend, int threads) {
+    double samples[TUNE_MAX_REPS];
+    setTuning(tuning);
+    for (int run = -1; run < d->reps; run++) {
+        copyArray(d->input, d->work, n);
+        double t0 = getCurrentTime();
+        switch (backend) {
+            case OGT_BACKEND_SEQ:
+                insertionSortAsc(d->work, n);
+                break;
+            case OGT_BACKEND_OPENMP:
+                parallelInsertionSortStats(d->work, n, threads, 1, NULL);
+                break;
+            default:
+                parallelInsertionSortPthreadsStats(d->work, n, threads, 1, NULL);
+                break;
+        }
+        double elapsed = getCurrentTime() - t0;
+        if (run >= 0) samples[run] = elapsed;
+        if (!checkSorted(d->work, n)) {
+            fprintf(stderr, RED "Lỗi: %s trả về mảng chưa sắp xếp\n" RESET, backendName(backend));
+            exit(1);
+        }
+    }
+    OGTSampleStats stats;
+    computeSampleStats(samples, d->reps, &stats);
+    return stats.median;
+}
+
+// Điểm của một cấu hình: tổng trung vị của hai backend dùng hồ sơ
+static double scoreTuning(TuneData* d, const OGTTuning* tuning, int threads) {
+    return measureSort(d, d->n, tuning, OGT_BACKEND_OPENMP, threads) +
+           measureSort(d, d->n, tuning, OGT_BACKEND_PTHREADS, threads);
+}
+
+// In kết quả đo một giá trị tham số; tham số kiểu merge in theo tên
+static void printTrial(const char* name, int value, double score) {
+    if (strcmp(name, "merge") == 0) {
+        printf("  %-18s = %-6s: %.6f s\n", name, mergeStrategyName((OGTMergeStrategy)value), score);
+    } else {
+        printf("  %-18s = %-6d: %.6f s\n", name, value, score);
+    }
+}
+
+// Thử từng giá trị của một tham số, giữ giá trị tốt nhất; trả về 1 nếu tham số thay đổi
+static int tuneParameter(TuneData* d, OGTTuning* tuning, int threads, const char* name,
+                         int* field, const int values[], int count, double* best) {
+    int original = *field;
+    int chosen = original;
+    for (int i = 0; i < count; i++) {
+        if (values[i] == original) continue;
+        *field = values[i];
+        double score = scoreTuning(d, tuning, threads);
+        printTrial(name, values[i], score);
+        if (score < *best * (1.0 - TUNE_MIN_GAIN)) {
+            *best = score;
+            chosen = values[i];
+        }
+    }
+    *field = chosen;
+    return chosen != original;
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr, "Cách dùng: %s [-n N] [-t max_luồng] [-r lần_đo] [-o file] [--dry-run]\n", program);
+}
+
+int main(int argc, char* argv[]) {
+    int n = TUNE_DEFAULT_N;
+    int reps = TUNE_DEFAULT_REPS;
+    int thread_limit = 0;
+    int dry_run = 0;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--dry-run") == 0) {
+            dry_run = 1;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (value && strcmp(argv[i], "-n") == 0) {
+            n = atoi(value);
+            i++;
+        } else if (value && strcmp(argv[i], "-t") == 0) {
+            thread_limit = atoi(value);
+            i++;
+        } else if (value && strcmp(argv[i], "-r") == 0) {
+            reps = atoi(value);
+            i++;
+        } else if (value && strcmp(argv[i], "-o") == 0) {
+            output = value;
+            i++;
+        } else {
+            fprintf(stderr, RED "Tùy chọn không hợp lệ: %s\n" RESET, argv[i]);
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (n < cutoff_sizes[COUNT_OF(cutoff_sizes) - 1] || reps < 1 || reps > TUNE_MAX_REPS ||
+        thread_limit < 0) {
+        fprintf(stderr, RED "Lỗi: cần n >= %d, 1 <= lần_đo <= %d, max_luồng >= 0\n" RESET,
+                cutoff_sizes[COUNT_OF(cutoff_sizes) - 1], TUNE_MAX_REPS);
+        return 2;
+    }
+
+    char path[OGT_TUNING_PATH_MAX];
+    if (output) {
+        snprintf(path, sizeof(path), "%s", output);
+    } else if (!dry_run && tuningProfilePath(path, sizeof(path)) != 0) {
+        fprintf(stderr, RED "Lỗi: không xác định được đường dẫn hồ sơ (OGT_TUNING=off?), dùng -o\n" RESET);
+        return 2;
+    }
+
+    TuneData d;
+    d.n = n;
+    d.reps = reps;
+    d.input = malloc((size_t)n * sizeof(int));
+    d.work = malloc((size_t)n * sizeof(int));
+    if (!d.input || !d.work) {
+        fprintf(stderr, RED "Không đủ bộ nhớ cho %d phần tử\n" RESET, n);
+        return 1;
+    }
+    generateDistributionArray(d.input, n, TUNE_MAX_VALUE, OGT_DIST_UNIFORM, getRandomSeed());
+
+    int cores = omp_get_num_procs();
+    if (thread_limit == 0) thread_limit = 4 * cores < 64 ? 4 * cores : 64;
+
+    // Bắt đầu từ mặc định, bỏ qua hồ sơ cũ; mọi luồng được phép trong lúc đo
+    OGTTuning tuning;
+    defaultTuning(&tuning);
+    tuning.max_threads = thread_limit;
+    if (thread_limit > concurrencyLimit()) setConcurrencyLimit(thread_limit);
+
+    printf(CYAN "=== TINH CHỈNH THEO MÁY ===" RESET "\n");
+    printf("n = %d, %d lần đo mỗi cấu hình, %d lõi, thử tới %d luồng\n\n", n, reps, cores, thread_limit);
+
+    // 1. Số luồng: lũy thừa của 2 cùng số lõi
+    printf(YELLOW "Số luồng" RESET "\n");
+    int threads = 1;
+    double best = 1e300;
+    for (int t = 1; t <= thread_limit; t = t < cores && t * 2 > cores ? cores : t * 2) {
+        double score = scoreTuning(&d, &tuning, t);
+        printTrial("threads", t, score);
+        if (score < best * (1.0 - TUNE_MIN_GAIN)) {
+            best = score;
+            threads = t;
+        }
+    }
+
+    // 2. Chia khối và cách trộn, lặp tới khi không tham số nào đổi
+    printf(YELLOW "Chia khối và trộn (%d luồng)" RESET "\n", threads);
+    int merges[OGT_MERGE_COUNT];
+    for (int m = 0; m < OGT_MERGE_COUNT; m++) merges[m] = m;
+    for (int round = 0; round < 3; round++) {
+        int changed = 0;
+        changed |= tuneParameter(&d, &tuning, threads, "chunks_per_thread", &tuning.chunks_per_thread,
+                                 chunk_factors, COUNT_OF(chunk_factors), &best);
+        changed |= tuneParameter(&d, &tuning, threads, "block_size", &tuning.block_size,
+                                 block_sizes, COUNT_OF(block_sizes), &best);
+        int merge = tuning.merge;
+        changed |= tuneParameter(&d, &tuning, threads, "merge", &merge, merges, OGT_MERGE_COUNT, &best);
+        tuning.merge = (OGTMergeStrategy)merge;
+        if (!changed) break;
+    }
+
+    // 3. Ngưỡng tuần tự: kích thước nhỏ nhất từ đó OpenMP luôn nhanh hơn tuần tự
+    printf(YELLOW "Ngưỡng tuần tự" RESET "\n");
+    OGTTuning probe = tuning;
+    probe.seq_cutoff = 2;
+    tuning.seq_cutoff = 2 * cutoff_sizes[COUNT_OF(cutoff_sizes) - 1];
+    for (int i = COUNT_OF(cutoff_sizes) - 1; i >= 0; i--) {
+        double seq = measureSort(&d, cutoff_sizes[i], &probe, OGT_BACKEND_SEQ, 1);
+        double par = measureSort(&d, cutoff_sizes[i], &probe, OGT_BACKEND_OPENMP, threads);
+        printf("  n = %-6d: tuần tự %.6f s, OpenMP %.6f s\n", cutoff_sizes[i], seq, par);
+        if (par >= seq) break;
+        tuning.seq_cutoff = cutoff_sizes[i];
+    }
+
+    // 4. Số lần đo: đủ để nửa khoảng tin cậy 95% còn khoảng TUNE_CI_TARGET của trung bình
+    double noise[TUNE_NOISE_REPS];
+    setTuning(&tuning);
+    for (int run = -1; run < TUNE_NOISE_REPS; run++) {
+        copyArray(d.input, d.work, n);
+        double t0 = getCurrentTime();
+        parallelInsertionSortStats(d.work, n, threads, 1, NULL);
+        if (run >= 0) noise[run] = getCurrentTime() - t0;
+    }
+    OGTSampleStats noise_stats;
+    computeSampleStats(noise, TUNE_NOISE_REPS, &noise_stats);
+    double cv = noise_stats.mean > 0.0 ? noise_stats.stddev / noise_stats.mean : 0.0;
+    int runs = (int)ceil(pow(2.0 * cv / TUNE_CI_TARGET, 2.0));
+    if (runs < 3) runs = 3;
+    if (runs > OGT_TUNING_MAX_RUNS) runs = OGT_TUNING_MAX_RUNS;
+    tuning.bench_runs = runs;
+
+    // Giới hạn luồng: số luồng tốt nhất, nhưng không dưới số lõi
+    tuning.max_threads = threads > cores ? threads : cores;
+
+    printf("\n" GREEN "=== KẾT QUẢ ===" RESET "\n");
+    printf("seq_cutoff        = %d\n", tuning.seq_cutoff);
+    printf("chunks_per_thread = %d\n", tuning.chunks_per_thread);
+    printf("block_size        = %d\n", tuning.block_size);
+    printf("merge             = %s\n", mergeStrategyName(tuning.merge));
+    printf("max_threads       = %d\n", tuning.max_threads);
+    printf("bench_runs        = %d (hệ số biến thiên %.1f%%)\n", tuning.bench_runs, cv * 100.0);
+    printf("Thời gian tốt nhất ở n = %d: %.6f s (OpenMP + Pthreads, %d luồng)\n", n, best, threads);
+
+    int status = 0;
+    if (!dry_run) {
+        char comment[128];
+        time_t now = time(NULL);
+        char date[32];
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M", localtime(&now));
+        snprintf(comment, sizeof(comment), "ogt_tune -n %d, %d lõi, %s", n, cores, date);
+        status = saveTuningProfile(path, &tuning, comment);
+        if (status == 0) printf("Đã ghi hồ sơ: %s\n", path);
+    }
+
+    free(d.input);
+    free(d.work);
+    return status == 0 ? 0 : 1;
+}
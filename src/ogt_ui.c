@@ -8,10 +8,50 @@
 
 #define MAX_ARRAY_SIZE 100000
 #define MAX_VALUE 10000
-#define NUM_RUNS 5
+#define NUM_RUNS (ogtTuning()->bench_runs)    // theo hồ sơ tinh chỉnh, mặc định 7
+#define WARMUP_RUNS 1
+
+// Phân phối dữ liệu dùng cho mọi benchmark (menu 7 hoặc biến môi trường OGT_DIST)
+static OGTDistribution benchmark_distribution = OGT_DIST_UNIFORM;
+static int benchmark_dist_param = OGT_DIST_DEFAULT_PARAM;   // OGT_DIST=nearly-sorted:K
 
 // ========== CÁC HÀM TIỆN ÍCH ==========
 
+// Sinh dữ liệu benchmark theo phân phối đang chọn
+static void generateBenchmarkArray(int arr[], int n) {
+    if (benchmark_distribution == OGT_DIST_UNIFORM) {
+        generateRandomArray(arr, n, MAX_VALUE);
+        return;
+    }
+    generateDistributionArrayParam(arr, n, MAX_VALUE, benchmark_distribution, benchmark_dist_param,
+                                   getRandomSeed() + reserveRandomStream(n));
+}
+
+// Tên phân phối đang chọn, kèm ":K" nếu có
+static const char* benchmarkDistributionName(void) {
+    static char name[48];
+    return distributionSpec(benchmark_distribution, benchmark_dist_param, name, sizeof(name));
+}
+
+#ifdef HAVE_MPI
+// Phiên bản tập thể: phân phối đều được sinh song song trên mọi rank,
+// các phân phối khác sinh tại rank 0
+static void generateBenchmarkArrayMPI(int arr[], int n) {
+    int rank, size;
+    getMPIInfo(&rank, &size);
+    
+    int dist = benchmark_distribution;
+    MPI_Bcast(&dist, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    
+    if (dist == OGT_DIST_UNIFORM) {
+        generateRandomArrayMPI(arr, n, MAX_VALUE);
+    } else if (rank == 0) {
+        benchmark_distribution = (OGTDistribution)dist;
+        generateBenchmarkArray(arr, n);
+    }
+}
+#endif
+
 // Hàm in mảng
 static void printArray(int arr[], int size) {
     for (int i = 0; i < size; i++)
@@ -81,12 +121,221 @@ static int getArraySizeInput(void) {
     return array_size;
 }
 
+// Chọn phân phối dữ liệu cho các benchmark
+static void selectDistribution(void) {
+    printf("\n" CYAN "=== PHÂN PHỐI DỮ LIỆU ===" RESET "\n");
+    for (int d = 0; d < OGT_DIST_COUNT; d++) {
+        printf("%d. %s%s\n", d + 1, distributionName((OGTDistribution)d),
+               (OGTDistribution)d == benchmark_distribution ? " (đang dùng)" : "");
+    }
+    printf("Chọn (1-%d): ", OGT_DIST_COUNT);
+    fflush(stdout);
+    
+    int choice = 0;
+    scanf("%d", &choice);
+    
+    if (choice >= 1 && choice <= OGT_DIST_COUNT) {
+        benchmark_distribution = (OGTDistribution)(choice - 1);
+        benchmark_dist_param = OGT_DIST_DEFAULT_PARAM;
+        printf(GREEN "✅ Sử dụng phân phối %s" RESET "\n", benchmarkDistributionName());
+    } else {
+        printf(RED "❌ Lựa chọn không hợp lệ!" RESET "\n");
+    }
+}
+
 // In kết quả benchmark theo bảng định dạng
 void printBenchmarkResults(const char* sort_type, int array_size, int threads, double avg_time, double speedup) {
     printf("%-15s | %-10d | %-8d | %-12.6f | %-10.4f\n", 
            sort_type, array_size, threads, avg_time, speedup);
 }
 
+// In tiêu đề bảng thời gian theo pha
+static void printSortStatsHeader(void) {
+    printf("%-10s | %-9s | %-9s | %-9s | %-9s | %-9s | %-9s | %-19s\n",
+           "Cấu Hình", "split", "copy", "sort", "merge", "copy-back", "comm", "sort/luồng min-max");
+    printf("---------------------------------------------------------------------------------------------------\n");
+}
+
+// In một dòng thời gian theo pha (giây), kèm chênh lệch pha sort giữa các luồng
+void printSortStats(const char* label, const OGTSortStats* stats) {
+    double min_sort = 0.0, max_sort = 0.0;
+    int recorded = stats->num_threads < OGT_STATS_MAX_THREADS ? stats->num_threads : OGT_STATS_MAX_THREADS;
+    for (int t = 0; t < recorded; t++) {
+        double v = stats->thread_time[t][OGT_PHASE_SORT];
+        if (t == 0 || v < min_sort) min_sort = v;
+        if (t == 0 || v > max_sort) max_sort = v;
+    }
+
+    printf("%-10s | %-9.6f | %-9.6f | %-9.6f | %-9.6f | %-9.6f | %-9.6f | %.6f-%.6f\n",
+           label,
+           stats->phase_time[OGT_PHASE_SPLIT],
+           stats->phase_time[OGT_PHASE_COPY],
+           stats->phase_time[OGT_PHASE_SORT],
+           stats->phase_time[OGT_PHASE_MERGE],
+           stats->phase_time[OGT_PHASE_COPY_BACK],
+           stats->phase_time[OGT_PHASE_COMM],
+           min_sort, max_sort);
+}
+
+// In bảng phân bố thời gian của các lần đo (sau khi loại ngoại lai)
+static void printSampleStatsHeader(void) {
+    printf("%-12s | %-10s | %-10s | %-10s | %-10s | %-23s | %s\n",
+           "Cấu Hình", "Trung vị", "TB", "Độ lệch", "p95", "CI95 của TB", "Ngoại lai");
+    printf("------------------------------------------------------------------------------------------------\n");
+}
+
+static void printSampleStats(const char* label, const OGTSampleStats* stats) {
+    printf("%-12s | %-10.6f | %-10.6f | %-10.6f | %-10.6f | [%.6f, %.6f] | %d/%d\n",
+           label, stats->median, stats->mean, stats->stddev, stats->p95,
+           stats->ci_low, stats->ci_high, stats->outliers, stats->count + stats->outliers);
+}
+
+// In bảng bộ đếm phần cứng (TB mỗi lần chạy) của pha sort và merge, chỉ khi OGT_PERF=1
+static void printCounterStatsHeader(void) {
+    if (!getHardwareCounters()) return;
+    printf("\n" CYAN "=== BỘ ĐẾM PHẦN CỨNG (TB mỗi lần chạy) ===" RESET "\n");
+    if (hardwareCountersAvailable() == 0) {
+        printf(YELLOW "⚠️  Bộ đếm phần cứng không khả dụng (perf_event_open bị chặn hoặc không có PMU)" RESET "\n");
+    }
+    printf("%-12s | %-6s | %-12s | %-12s | %-5s | %-10s | %-10s | %-10s | %-10s\n",
+           "Cấu Hình", "Pha", "Chu kỳ", "Lệnh", "IPC", "L1D miss", "LLC miss", "Nhánh sai", "dTLB miss");
+    printf("--------------------------------------------------------------------------------------------------------------\n");
+}
+
+static void printCounterCell(const OGTCounterValues* values, OGTCounter counter, int width) {
+    if (counterValid(values, counter)) {
+        printf(" | %-*.0f", width, values->value[counter]);
+    } else {
+        printf(" | %-*s", width, "n/a");
+    }
+}
+
+static void printCounterStats(const char* label, const OGTSortStats* stats) {
+    static const OGTPhase phases[] = { OGT_PHASE_SORT, OGT_PHASE_MERGE };
+    if (!getHardwareCounters()) return;
+    for (int k = 0; k < 2; k++) {
+        const OGTCounterValues* values = &stats->phase_counters[phases[k]];
+        printf("%-12s | %-6s", k == 0 ? label : "", phaseName(phases[k]));
+        printCounterCell(values, OGT_COUNTER_CYCLES, 12);
+        printCounterCell(values, OGT_COUNTER_INSTRUCTIONS, 12);
+        if (counterIPC(values) > 0.0) {
+            printf(" | %-5.2f", counterIPC(values));
+        } else {
+            printf(" | %-5s", "n/a");
+        }
+        printCounterCell(values, OGT_COUNTER_L1D_MISSES, 10);
+        printCounterCell(values, OGT_COUNTER_LLC_MISSES, 10);
+        printCounterCell(values, OGT_COUNTER_BRANCH_MISSES, 10);
+        printCounterCell(values, OGT_COUNTER_DTLB_MISSES, 10);
+        printf("\n");
+    }
+}
+
+// In băng thông đạt được của các pha chịu giới hạn bộ nhớ, kèm % so với copy đỉnh (STREAM)
+static const OGTPhase bandwidth_phases[] = { OGT_PHASE_COPY, OGT_PHASE_MERGE, OGT_PHASE_COPY_BACK };
+#define NUM_BANDWIDTH_PHASES (int)(sizeof(bandwidth_phases) / sizeof(bandwidth_phases[0]))
+
+static void printBandwidthStatsHeader(void) {
+    printf("\n" CYAN "=== BĂNG THÔNG THEO PHA (GB/s, %% đỉnh STREAM copy) ===" RESET "\n");
+    printf("(trên 100%%: dữ liệu của pha vừa trong cache)\n");
+    printf("%-12s", "Cấu Hình");
+    for (int k = 0; k < NUM_BANDWIDTH_PHASES; k++) {
+        printf(" | %-18s", phaseName(bandwidth_phases[k]));
+    }
+    printf("\n");
+    printf("-----------------------------------------------------------------------\n");
+}
+
+static void printBandwidthStats(const char* label, const OGTSortStats* stats) {
+    printf("%-12s", label);
+    for (int k = 0; k < NUM_BANDWIDTH_PHASES; k++) {
+        double gbps = phaseBandwidth(stats, bandwidth_phases[k]);
+        if (gbps > 0.0) {
+            char cell[32];
+            snprintf(cell, sizeof(cell), "%.2f (%.0f%%)", gbps, phasePeakPercent(stats, bandwidth_phases[k]));
+            printf(" | %-18s", cell);
+        } else {
+            printf(" | %-18s", "-");
+        }
+    }
+    printf("\n");
+}
+
+// In bảng cấp phát (qua ogtMalloc) và đỉnh RSS, TB mỗi lần chạy
+static void printMemoryStatsHeader(void) {
+    printf("\n" CYAN "=== BỘ NHỚ (TB mỗi lần chạy) ===" RESET "\n");
+    printf("%-12s | %-12s | %-8s | %-12s | %-12s\n",
+           "Cấu Hình", "Cấp phát MB", "Số lần", "Đỉnh thêm MB", "Peak RSS MB");
+    printf("---------------------------------------------------------------------\n");
+}
+
+static void printRSSCell(long long rss_kb) {
+    if (rss_kb >= 0) {
+        printf(" | %-12.2f", rss_kb / 1024.0);
+    } else {
+        printf(" | %-12s", "n/a");
+    }
+}
+
+static void printMemoryStats(const char* label, const OGTMemStats* memory) {
+    printf("%-12s | %-12.2f | %-8lld | %-12.2f", label,
+           memory->bytes_allocated / (1024.0 * 1024.0), memory->allocations,
+           memory->peak_bytes / (1024.0 * 1024.0));
+    printRSSCell(memory->peak_rss_kb);
+    printf("\n");
+}
+
+#ifdef HAVE_MPI
+// Cộng dồn thống kê theo rank của một lần chạy (rank chậm nhất lấy theo lần chạy cuối)
+static void accumulateMPIPhaseStats(OGTMPIPhaseStats* sum, const OGTMPIPhaseStats* stats) {
+    sum->num_ranks = stats->num_ranks;
+    for (int p = 0; p < OGT_MPI_PHASE_COUNT; p++) {
+        sum->min_time[p] += stats->min_time[p];
+        sum->avg_time[p] += stats->avg_time[p];
+        sum->max_time[p] += stats->max_time[p];
+        sum->max_rank[p] = stats->max_rank[p];
+        sum->bytes[p] += stats->bytes[p];
+    }
+    const OGTMemStats* from[2] = { &stats->root_memory, &stats->other_memory };
+    OGTMemStats* to[2] = { &sum->root_memory, &sum->other_memory };
+    for (int k = 0; k < 2; k++) {
+        to[k]->bytes_allocated += from[k]->bytes_allocated;
+        to[k]->allocations += from[k]->allocations;
+        to[k]->peak_bytes += from[k]->peak_bytes;
+        to[k]->peak_rss_kb += from[k]->peak_rss_kb;
+    }
+}
+
+static void scaleMPIPhaseStats(OGTMPIPhaseStats* stats, double factor) {
+    for (int p = 0; p < OGT_MPI_PHASE_COUNT; p++) {
+        stats->min_time[p] *= factor;
+        stats->avg_time[p] *= factor;
+        stats->max_time[p] *= factor;
+        stats->bytes[p] = (long long)(stats->bytes[p] * factor);
+    }
+    OGTMemStats* memory[2] = { &stats->root_memory, &stats->other_memory };
+    for (int k = 0; k < 2; k++) {
+        memory[k]->bytes_allocated = (long long)(memory[k]->bytes_allocated * factor);
+        memory[k]->allocations = (long long)(memory[k]->allocations * factor);
+        memory[k]->peak_bytes = (long long)(memory[k]->peak_bytes * factor);
+        memory[k]->peak_rss_kb = (long long)(memory[k]->peak_rss_kb * factor);
+    }
+}
+
+// In bảng min/avg/max theo pha trên các rank, rank chậm nhất và dung lượng dữ liệu
+static void printMPIPhaseStats(const OGTMPIPhaseStats* stats) {
+    printf("%-11s | %-10s | %-10s | %-10s | %-9s | %-10s\n",
+           "Pha", "Min (s)", "TB (s)", "Max (s)", "Rank max", "MB");
+    printf("-------------------------------------------------------------------------\n");
+    for (int p = 0; p < OGT_MPI_PHASE_COUNT; p++) {
+        printf("%-11s | %-10.6f | %-10.6f | %-10.6f | %-9d | %-10.2f\n",
+               mpiPhaseName((OGTMPIPhase)p),
+               stats->min_time[p], stats->avg_time[p], stats->max_time[p],
+               stats->max_rank[p], stats->bytes[p] / (1024.0 * 1024.0));
+    }
+}
+#endif
+
 // In thông tin thư viện
 void printLibraryInfo(void) {
     printf("\n" MAGENTA "╔══════════════════════════════════════════════════════╗\n");
@@ -109,8 +358,15 @@ void printSystemInformation(void) {
     printf("- Kích thước mảng: 10K, 25K, 50K, 75K, 100K phần tử\n");
     printf("- Số luồng: 1, 3, 5, 7, 9, 11\n");
     printf("- Số lần chạy mỗi cấu hình: %d\n", NUM_RUNS);
+    const OGTTuning* tuning = ogtTuning();
+    printf("Hồ sơ tinh chỉnh: %s\n", tuningSource());
+    printf("- Ngưỡng tuần tự: %d, khối mỗi luồng: %d, cỡ khối tối đa: %d, trộn: %s, luồng tối đa: %d\n",
+           tuning->seq_cutoff, tuning->chunks_per_thread, tuning->block_size,
+           mergeStrategyName(tuning->merge), tuning->max_threads);
     printf("- Giá trị ngẫu nhiên tối đa: %d\n", MAX_VALUE);
     printf("\n");
+    printBandwidthInfo();
+    printf("\n");
 }
 
 // ========== 1. CÁC HÀM SẮP XẾP TUẦN TỰ ==========
@@ -152,31 +408,41 @@ void runSequentialDemo(void) {
 
 void runSequentialBenchmark(void) {
     printf("\n" GREEN "=== BENCHMARK TUẦN TỰ (SEQUENTIAL) ===" RESET "\n");
+    printf("Phân phối dữ liệu: %s\n", benchmarkDistributionName());
     
     int test_sizes[] = {1000, 5000, 10000, 25000, 50000};
     int num_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
     
-    printf("%-12s | %-12s\n", "Kích Thước", "Thời Gian TB (s)");
-    printf("------------------------\n");
+    printf("%-12s | %-12s | %-10s | %-10s | %-23s | %s\n",
+           "Kích Thước", "Trung Vị (s)", "Độ lệch", "p95", "CI95 của TB", "Ngoại lai");
+    printf("------------------------------------------------------------------------------------\n");
+    
+    double samples[OGT_TUNING_MAX_RUNS];
     
     for (int i = 0; i < num_sizes; i++) {
         int size = test_sizes[i];
-        double total_time = 0.0;
+        int *original = malloc(size * sizeof(int));
+        int *arr = malloc(size * sizeof(int));
+        generateBenchmarkArray(original, size);
         
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = malloc(size * sizeof(int));
-            generateRandomArray(arr, size, MAX_VALUE);
+        // Các lần chạy run < 0 là khởi động, không ghi lại
+        for (int run = -WARMUP_RUNS; run < NUM_RUNS; run++) {
+            copyArray(original, arr, size);
             
             double start_time = getCurrentTime();
             insertionSortAsc(arr, size);
             double end_time = getCurrentTime();
             
-            total_time += (end_time - start_time);
-            free(arr);
+            if (run >= 0) samples[run] = end_time - start_time;
         }
+        free(original);
+        free(arr);
         
-        double avg_time = total_time / NUM_RUNS;
-        printf("%-12d | %-12.6f\n", size, avg_time);
+        OGTSampleStats time_stats;
+        computeSampleStats(samples, NUM_RUNS, &time_stats);
+        printf("%-12d | %-12.6f | %-10.6f | %-10.6f | [%.6f, %.6f] | %d/%d\n",
+               size, time_stats.median, time_stats.stddev, time_stats.p95,
+               time_stats.ci_low, time_stats.ci_high, time_stats.outliers, NUM_RUNS);
     }
 }
 
@@ -220,53 +486,107 @@ void runOpenMPBenchmark(void) {
     
     printf("\n" MAGENTA "🔥 BENCHMARK VỚI THREADS CỐ ĐỊNH (p=1,3,5,7,9,11)" RESET "\n");
     printf("Kích thước mảng: %d phần tử\n", array_size);
-    printf("Số lần chạy mỗi cấu hình: %d\n\n", NUM_RUNS);
+    printf("Phân phối dữ liệu: %s\n", benchmarkDistributionName());
+    printf("Số lần chạy mỗi cấu hình: %d (+%d lần khởi động)\n\n", NUM_RUNS, WARMUP_RUNS);
     
-    printf("%-8s | %-12s | %-10s | %-12s\n", "Luồng", "Thời Gian TB (s)", "Tăng Tốc", "Hiệu Suất");
+    printf("%-8s | %-12s | %-10s | %-12s\n", "Luồng", "Trung Vị (s)", "Tăng Tốc", "Hiệu Suất");
     printf("----------------------------------------------------\n");
     
     double sequential_time = 0.0;
+    OGTSortStats phase_stats[num_thread_configs];
+    OGTSampleStats time_stats[num_thread_configs];
+    double samples[OGT_TUNING_MAX_RUNS];
+    
+    // Sinh dữ liệu một lần; mỗi lần đo copy lại để sinh dữ liệu và cấp phát không nằm giữa các lần đo
+    int *original = malloc(array_size * sizeof(int));
+    int *arr = malloc(array_size * sizeof(int));
+    if (!original || !arr) {
+        printf(RED "❌ Cấp phát bộ nhớ thất bại cho %d phần tử\n" RESET, array_size);
+        free(original);
+        free(arr);
+        return;
+    }
+    generateBenchmarkArray(original, array_size);
     
     for (int t = 0; t < num_thread_configs; t++) {
         int threads = thread_counts[t];
-        double total_time = 0.0;
+        OGTSortStats run_stats;
+        resetSortStats(&phase_stats[t]);
         
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = malloc(array_size * sizeof(int));
-            if (!arr) {
-                printf(RED "❌ Cấp phát bộ nhớ thất bại cho %d phần tử\n" RESET, array_size);
-                return;
-            }
-            
-            generateRandomArray(arr, array_size, MAX_VALUE);
+        // Các lần chạy run < 0 là khởi động, không ghi lại
+        for (int run = -WARMUP_RUNS; run < NUM_RUNS; run++) {
+            copyArray(original, arr, array_size);
             
             double start_time = getCurrentTime();
             
             if (threads == 1) {
-                insertionSortAsc(arr, array_size);
+                insertionSortStats(arr, array_size, 1, &run_stats);
             } else {
-                parallelInsertionSortAsc(arr, array_size, threads);
+                parallelInsertionSortStats(arr, array_size, threads, 1, &run_stats);
             }
             
             double end_time = getCurrentTime();
-            total_time += (end_time - start_time);
-            free(arr);
+            if (run < 0) continue;
+            samples[run] = end_time - start_time;
+            accumulateSortStats(&phase_stats[t], &run_stats);
         }
         
-        double avg_time = total_time / NUM_RUNS;
+        scaleSortStats(&phase_stats[t], 1.0 / NUM_RUNS);
+        computeSampleStats(samples, NUM_RUNS, &time_stats[t]);
+        double median_time = time_stats[t].median;
         
         if (threads == 1) {
-            sequential_time = avg_time;
+            sequential_time = median_time;
             printf("%-8d | %-12.6f | %-10.2f | %-12.2f%%\n", 
-                   threads, avg_time, 1.0, 100.0);
+                   threads, median_time, 1.0, 100.0);
         } else {
-            double speedup = sequential_time / avg_time;
+            double speedup = sequential_time / median_time;
             double efficiency = (speedup / threads) * 100.0;
             printf("%-8d | %-12.6f | %-10.2f | %-12.2f%%\n", 
-                   threads, avg_time, speedup, efficiency);
+                   threads, median_time, speedup, efficiency);
         }
     }
     
+    free(original);
+    free(arr);
+    
+    printf("\n" CYAN "=== PHÂN BỐ THỜI GIAN (giây) ===" RESET "\n");
+    printSampleStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printSampleStats(label, &time_stats[t]);
+    }
+    
+    printf("\n" CYAN "=== THỜI GIAN THEO PHA (TB, giây) ===" RESET "\n");
+    printSortStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printSortStats(label, &phase_stats[t]);
+    }
+    
+    printBandwidthStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printBandwidthStats(label, &phase_stats[t]);
+    }
+    
+    printMemoryStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printMemoryStats(label, &phase_stats[t].memory);
+    }
+    
+    printCounterStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printCounterStats(label, &phase_stats[t]);
+    }
+    
     printf("\n" CYAN "=== PHÂN TÍCH KẾT QUẢ ===" RESET "\n");
     printf("✅ Sắp xếp tuần tự: %.6f s\n", sequential_time);
     printf("🎯 Các số luồng test: 1(tuần tự), 3, 5, 7, 9, 11\n");
@@ -324,53 +644,107 @@ void runPthreadsBenchmark(void) {
     
     printf("\n" MAGENTA "🔥 BENCHMARK VỚI THREADS CỐ ĐỊNH (p=1,3,5,7,9,11)" RESET "\n");
     printf("Kích thước mảng: %d phần tử\n", array_size);
-    printf("Số lần chạy mỗi cấu hình: %d\n\n", NUM_RUNS);
+    printf("Phân phối dữ liệu: %s\n", benchmarkDistributionName());
+    printf("Số lần chạy mỗi cấu hình: %d (+%d lần khởi động)\n\n", NUM_RUNS, WARMUP_RUNS);
     
-    printf("%-8s | %-12s | %-10s | %-12s\n", "Luồng", "Thời Gian TB (s)", "Tăng Tốc", "Hiệu Suất");
+    printf("%-8s | %-12s | %-10s | %-12s\n", "Luồng", "Trung Vị (s)", "Tăng Tốc", "Hiệu Suất");
     printf("----------------------------------------------------\n");
     
     double sequential_time = 0.0;
+    OGTSortStats phase_stats[num_thread_configs];
+    OGTSampleStats time_stats[num_thread_configs];
+    double samples[OGT_TUNING_MAX_RUNS];
+    
+    // Sinh dữ liệu một lần; mỗi lần đo copy lại để sinh dữ liệu và cấp phát không nằm giữa các lần đo
+    int *original = malloc(array_size * sizeof(int));
+    int *arr = malloc(array_size * sizeof(int));
+    if (!original || !arr) {
+        printf(RED "❌ Cấp phát bộ nhớ thất bại cho %d phần tử\n" RESET, array_size);
+        free(original);
+        free(arr);
+        return;
+    }
+    generateBenchmarkArray(original, array_size);
     
     for (int t = 0; t < num_thread_configs; t++) {
         int threads = thread_counts[t];
-        double total_time = 0.0;
+        OGTSortStats run_stats;
+        resetSortStats(&phase_stats[t]);
         
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = malloc(array_size * sizeof(int));
-            if (!arr) {
-                printf(RED "❌ Cấp phát bộ nhớ thất bại cho %d phần tử\n" RESET, array_size);
-                return;
-            }
-            
-            generateRandomArray(arr, array_size, MAX_VALUE);
+        // Các lần chạy run < 0 là khởi động, không ghi lại
+        for (int run = -WARMUP_RUNS; run < NUM_RUNS; run++) {
+            copyArray(original, arr, array_size);
             
             double start_time = getCurrentTime();
             
             if (threads == 1) {
-                insertionSortAsc(arr, array_size);
+                insertionSortStats(arr, array_size, 1, &run_stats);
             } else {
-                parallelInsertionSortPthreadsAsc(arr, array_size, threads);
+                parallelInsertionSortPthreadsStats(arr, array_size, threads, 1, &run_stats);
             }
             
             double end_time = getCurrentTime();
-            total_time += (end_time - start_time);
-            free(arr);
+            if (run < 0) continue;
+            samples[run] = end_time - start_time;
+            accumulateSortStats(&phase_stats[t], &run_stats);
         }
         
-        double avg_time = total_time / NUM_RUNS;
+        scaleSortStats(&phase_stats[t], 1.0 / NUM_RUNS);
+        computeSampleStats(samples, NUM_RUNS, &time_stats[t]);
+        double median_time = time_stats[t].median;
         
         if (threads == 1) {
-            sequential_time = avg_time;
+            sequential_time = median_time;
             printf("%-8d | %-12.6f | %-10.2f | %-12.2f%%\n", 
-                   threads, avg_time, 1.0, 100.0);
+                   threads, median_time, 1.0, 100.0);
         } else {
-            double speedup = sequential_time / avg_time;
+            double speedup = sequential_time / median_time;
             double efficiency = (speedup / threads) * 100.0;
             printf("%-8d | %-12.6f | %-10.2f | %-12.2f%%\n", 
-                   threads, avg_time, speedup, efficiency);
+                   threads, median_time, speedup, efficiency);
         }
     }
     
+    free(original);
+    free(arr);
+    
+    printf("\n" CYAN "=== PHÂN BỐ THỜI GIAN (giây) ===" RESET "\n");
+    printSampleStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printSampleStats(label, &time_stats[t]);
+    }
+    
+    printf("\n" CYAN "=== THỜI GIAN THEO PHA (TB, giây) ===" RESET "\n");
+    printSortStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printSortStats(label, &phase_stats[t]);
+    }
+    
+    printBandwidthStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printBandwidthStats(label, &phase_stats[t]);
+    }
+    
+    printMemoryStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printMemoryStats(label, &phase_stats[t].memory);
+    }
+    
+    printCounterStatsHeader();
+    for (int t = 0; t < num_thread_configs; t++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d luồng", thread_counts[t]);
+        printCounterStats(label, &phase_stats[t]);
+    }
+    
     printf("\n" CYAN "=== PHÂN TÍCH KẾT QUẢ ===" RESET "\n");
     printf("✅ Chuẩn tuần tự: %.6f giây\n", sequential_time);
     printf("🎯 Số luồng đã test: 1(tuần tự), 3, 5, 7, 9, 11\n");
@@ -440,71 +814,122 @@ void runMPIBenchmark(void) {
     }
     
     int array_size;
+    int num_runs = NUM_RUNS;
     if (rank == 0) {
         printf("Số tiến trình MPI hiện tại: %d\n", size);
         array_size = getArraySizeInput();
         
         printf("\n" MAGENTA "🔥 BENCHMARK VỚI TIẾN TRÌNH CỐ ĐỊNH (p=%d)" RESET "\n", size);
         printf("Kích thước mảng: %d phần tử\n", array_size);
-        printf("Số lần chạy mỗi cấu hình: %d\n\n", NUM_RUNS);
+        printf("Phân phối dữ liệu: %s\n", benchmarkDistributionName());
+        printf("Số lần chạy mỗi cấu hình: %d (+%d lần khởi động)\n\n", num_runs, WARMUP_RUNS);
         
         
-        printf("%-10s | %-12s | %-10s | %-12s\n", "Tiến Trình", "Thời Gian TB (s)", "Tăng Tốc", "Hiệu Suất");
-        printf("-------------------------------------------------------\n");
+        printf("%-10s | %-12s | %-10s | %-12s | %-10s | %-10s\n", "Tiến Trình", "Trung Vị (s)", "Tăng Tốc", "Hiệu Suất",
+               "Mất CB", "Comm/Comp");
+        printf("------------------------------------------------------------------------------\n");
     }
     
     // Broadcast array size to all processes
     MPI_Bcast(&array_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    // các rank có thể nạp hồ sơ của các máy khác nhau: dùng số lần chạy của rank 0
+    MPI_Bcast(&num_runs, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    
+    // Sinh dữ liệu một lần; rank 0 copy lại trước mỗi lần đo
+    int *original = NULL;
+    int *arr = NULL;
+    if (rank == 0) {
+        original = malloc(array_size * sizeof(int));
+        arr = malloc(array_size * sizeof(int));
+    }
+    generateBenchmarkArrayMPI(original, array_size);
+    
+    double seq_samples[OGT_TUNING_MAX_RUNS];
+    double mpi_samples[OGT_TUNING_MAX_RUNS];
+    double compressed_samples[OGT_TUNING_MAX_RUNS];
     
     // Get sequential baseline (only on rank 0)
     double sequential_time = 0.0;
     if (rank == 0) {
-        double total_seq_time = 0.0;
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = malloc(array_size * sizeof(int));
-            generateRandomArray(arr, array_size, MAX_VALUE);
+        for (int run = -WARMUP_RUNS; run < num_runs; run++) {
+            copyArray(original, arr, array_size);
             
             double start_time = getCurrentTime();
             insertionSortAsc(arr, array_size);
             double end_time = getCurrentTime();
             
-            total_seq_time += (end_time - start_time);
-            free(arr);
+            if (run >= 0) seq_samples[run] = end_time - start_time;
         }
-        sequential_time = total_seq_time / NUM_RUNS;
+        OGTSampleStats seq_stats;
+        computeSampleStats(seq_samples, num_runs, &seq_stats);
+        sequential_time = seq_stats.median;
     }
     
     // Broadcast sequential time to all processes
     MPI_Bcast(&sequential_time, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
     
-    // MPI benchmark
-    double total_mpi_time = 0.0;
-    for (int run = 0; run < NUM_RUNS; run++) {
-        int *arr = NULL;
+    // MPI benchmark (run < 0 là khởi động, không ghi lại)
+    OGTMPIPhaseStats rank_stats, run_rank_stats;
+    memset(&rank_stats, 0, sizeof(rank_stats));
+    for (int run = -WARMUP_RUNS; run < num_runs; run++) {
+        if (rank == 0) copyArray(original, arr, array_size);
         
-        if (rank == 0) {
-            arr = malloc(array_size * sizeof(int));
-            generateRandomArray(arr, array_size, MAX_VALUE);
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start_time = getCurrentTime();
+        parallelInsertionSortMPIRankStats(arr, array_size, 1, NULL, &run_rank_stats);
+        double end_time = getCurrentTime();
+        
+        if (rank == 0 && run >= 0) {
+            mpi_samples[run] = end_time - start_time;
+            accumulateMPIPhaseStats(&rank_stats, &run_rank_stats);
         }
+    }
+    
+    // MPI với nén run khi gather (delta + bit-packing)
+    setMPICompression(1);
+    for (int run = -WARMUP_RUNS; run < num_runs; run++) {
+        if (rank == 0) copyArray(original, arr, array_size);
         
         MPI_Barrier(MPI_COMM_WORLD);
         double start_time = getCurrentTime();
         parallelInsertionSortMPIAsc(arr, array_size);
         double end_time = getCurrentTime();
         
-        if (rank == 0) {
-            total_mpi_time += (end_time - start_time);
-            free(arr);
+        if (rank == 0 && run >= 0) {
+            compressed_samples[run] = end_time - start_time;
         }
     }
+    setMPICompression(0);
+    
+    free(original);
+    free(arr);
     
     if (rank == 0) {
-        double avg_mpi_time = total_mpi_time / NUM_RUNS;
+        OGTSampleStats mpi_stats, compressed_stats;
+        computeSampleStats(mpi_samples, num_runs, &mpi_stats);
+        computeSampleStats(compressed_samples, num_runs, &compressed_stats);
+        
+        double avg_mpi_time = mpi_stats.median;
         double speedup = sequential_time / avg_mpi_time;
         double efficiency = (speedup / size) * 100.0;
         
-        printf("%-10d | %-12.6f | %-10.2f | %-12.2f%%\n", 
-               size, avg_mpi_time, speedup, efficiency);
+        scaleMPIPhaseStats(&rank_stats, 1.0 / num_runs);
+        printf("%-10d | %-12.6f | %-10.2f | %-12.2f%% | %-10.2f | %-10.2f\n", 
+               size, avg_mpi_time, speedup, efficiency,
+               mpiLoadImbalance(&rank_stats), mpiCommCompRatio(&rank_stats));
+        
+        double avg_compressed_time = compressed_stats.median;
+        double compressed_speedup = sequential_time / avg_compressed_time;
+        printf("%-10s | %-12.6f | %-10.2f | %-12.2f%%\n", 
+               "+nén", avg_compressed_time, compressed_speedup, (compressed_speedup / size) * 100.0);
+        
+        printf("\n" CYAN "=== PHÂN BỐ THỜI GIAN (giây) ===" RESET "\n");
+        printSampleStatsHeader();
+        OGTSampleStats seq_stats;
+        computeSampleStats(seq_samples, num_runs, &seq_stats);
+        printSampleStats("Tuần tự", &seq_stats);
+        printSampleStats("MPI", &mpi_stats);
+        printSampleStats("MPI+nén", &compressed_stats);
         
         printf("\n" CYAN "=== PHÂN TÍCH KẾT QUẢ ===" RESET "\n");
         printf("✅ Chuẩn tuần tự: %.6f giây\n", sequential_time);
@@ -514,6 +939,15 @@ void runMPIBenchmark(void) {
         printf("📊 Kích thước mảng: %d phần tử\n", array_size);
         printf("📈 Hiệu suất = (Tăng tốc / Số tiến trình) × 100%%\n");
         
+        printf("\n" CYAN "=== THỜI GIAN THEO PHA TRÊN CÁC RANK (TB, giây) ===" RESET "\n");
+        printMPIPhaseStats(&rank_stats);
+        printf("⚖️  Mất cân bằng tải (sort chậm nhất / TB): %.2f\n", mpiLoadImbalance(&rank_stats));
+        printf("📡 Tỉ lệ giao tiếp / tính toán: %.2f\n", mpiCommCompRatio(&rank_stats));
+        
+        printMemoryStatsHeader();
+        printMemoryStats("Rank 0", &rank_stats.root_memory);
+        if (size > 1) printMemoryStats("Rank khác max", &rank_stats.other_memory);
+        
         if (efficiency > 100.0) {
             printf("🚀 Phát hiện tăng tốc siêu tuyến tính! (hiệu ứng cache hoặc lợi ích thuật toán)\n");
         } else if (efficiency > 70.0) {
@@ -557,8 +991,9 @@ void runAllComparison(void) {
         printf("\n" CYAN "🔄 Bắt đầu so sánh với các thông số:" RESET "\n");
         printf("Kích thước mảng: %d phần tử\n", array_size);
         printf("Số luồng (cho phương pháp song song): %d\n", threads);
+        printf("Phân phối dữ liệu: %s\n", benchmarkDistributionName());
         printf("Số lần chạy mỗi phương pháp: %d\n\n", NUM_RUNS);
-        printf("%-15s | %-12s | %-10s\n", "Phương Pháp", "Thời Gian TB (s)", "Tăng Tốc");
+        printf("%-15s | %-12s | %-10s\n", "Phương Pháp", "Trung Vị (s)", "Tăng Tốc");
         printf("------------------------------------------\n");
     }
     
@@ -572,127 +1007,86 @@ void runAllComparison(void) {
     
     double times[4] = {0, 0, 0, 0};
     const char* methods[] = {"Tuần Tự", "OpenMP", "Pthreads", "MPI"};
+    OGTSortStats method_stats[4];
+    OGTSampleStats time_stats[4];
+    OGTSortStats run_stats;
+    double samples[OGT_TUNING_MAX_RUNS];
+    for (int i = 0; i < 4; i++) {
+        resetSortStats(&method_stats[i]);
+    }
     
-    // Only rank 0 runs sequential, OpenMP, and Pthreads tests
+    // Sinh dữ liệu một lần cho mọi phương pháp, rank 0 copy lại trước mỗi lần đo
+    int *original = NULL;
+    int *arr = NULL;
     if (rank == 0) {
-        // Generate test data
-        int *original = malloc(array_size * sizeof(int));
-        generateRandomArray(original, array_size, MAX_VALUE);
-        
-        // 1. Sequential
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = malloc(array_size * sizeof(int));
-            copyArray(original, arr, array_size);
-            
-            double start_time = getCurrentTime();
-            insertionSortAsc(arr, array_size);
-            double end_time = getCurrentTime();
-            
-            times[0] += (end_time - start_time);
-            free(arr);
-        }
-        times[0] /= NUM_RUNS;
-        
-        // 2. OpenMP
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = malloc(array_size * sizeof(int));
-            copyArray(original, arr, array_size);
-            
-            double start_time = getCurrentTime();
-            parallelInsertionSortAsc(arr, array_size, threads);
-            double end_time = getCurrentTime();
-            
-            times[1] += (end_time - start_time);
-            free(arr);
-        }
-        times[1] /= NUM_RUNS;
-        
-        // 3. Pthreads
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = malloc(array_size * sizeof(int));
-            copyArray(original, arr, array_size);
-            
-            double start_time = getCurrentTime();
-            parallelInsertionSortPthreadsAsc(arr, array_size, threads);
-            double end_time = getCurrentTime();
-            
-            times[2] += (end_time - start_time);
-            free(arr);
-        }
-        times[2] /= NUM_RUNS;
-        
-        free(original);
+        original = malloc(array_size * sizeof(int));
+        arr = malloc(array_size * sizeof(int));
     }
-    
-    // 4. MPI - All processes participate
 #ifdef HAVE_MPI
     if (isMPIInitialized()) {
-        // Broadcast first 3 results to all processes for consistency
-        MPI_Bcast(times, 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = NULL;
-            if (rank == 0) {
-                arr = malloc(array_size * sizeof(int));
-                generateRandomArray(arr, array_size, MAX_VALUE);
-            }
-            
-            MPI_Barrier(MPI_COMM_WORLD);
-            double start_time = getCurrentTime();
-            parallelInsertionSortMPIAsc(arr, array_size);
-            double end_time = getCurrentTime();
-            
-            if (rank == 0) {
-                times[3] += (end_time - start_time);
-                free(arr);
-            }
-        }
-        
-        if (rank == 0) {
-            times[3] /= NUM_RUNS;
-        }
+        generateBenchmarkArrayMPI(original, array_size);
     } else {
-        // Fallback timing for MPI stub (only rank 0)
-        if (rank == 0) {
-            int *original = malloc(array_size * sizeof(int));
-            generateRandomArray(original, array_size, MAX_VALUE);
-            
-            for (int run = 0; run < NUM_RUNS; run++) {
-                int *arr = malloc(array_size * sizeof(int));
+        generateBenchmarkArray(original, array_size);
+    }
+#else
+    generateBenchmarkArray(original, array_size);
+#endif
+    
+    // Only rank 0 runs sequential, OpenMP, and Pthreads tests
+    if (rank == 0) {
+        for (int m = 0; m < 3; m++) {
+            // Các lần chạy run < 0 là khởi động, không ghi lại
+            for (int run = -WARMUP_RUNS; run < NUM_RUNS; run++) {
                 copyArray(original, arr, array_size);
                 
                 double start_time = getCurrentTime();
-                parallelInsertionSortMPIAsc(arr, array_size);  // Will fallback
+                if (m == 0) {
+                    insertionSortStats(arr, array_size, 1, &run_stats);
+                } else if (m == 1) {
+                    parallelInsertionSortStats(arr, array_size, threads, 1, &run_stats);
+                } else {
+                    parallelInsertionSortPthreadsStats(arr, array_size, threads, 1, &run_stats);
+                }
                 double end_time = getCurrentTime();
                 
-                times[3] += (end_time - start_time);
-                free(arr);
+                if (run < 0) continue;
+                samples[run] = end_time - start_time;
+                accumulateSortStats(&method_stats[m], &run_stats);
             }
-            times[3] /= NUM_RUNS;
-            free(original);
+            computeSampleStats(samples, NUM_RUNS, &time_stats[m]);
+            times[m] = time_stats[m].median;
         }
     }
-#else
-    // Fallback timing for MPI stub (only rank 0)
-    if (rank == 0) {
-        int *original = malloc(array_size * sizeof(int));
-        generateRandomArray(original, array_size, MAX_VALUE);
-        
-        for (int run = 0; run < NUM_RUNS; run++) {
-            int *arr = malloc(array_size * sizeof(int));
-            copyArray(original, arr, array_size);
+    
+    // 4. MPI - mọi tiến trình tham gia khi MPI đã khởi tạo, ngược lại chỉ rank 0 (stub)
+    int mpi_collective = 0;
+#ifdef HAVE_MPI
+    mpi_collective = isMPIInitialized();
+#endif
+    if (mpi_collective || rank == 0) {
+        for (int run = -WARMUP_RUNS; run < NUM_RUNS; run++) {
+            if (rank == 0) copyArray(original, arr, array_size);
             
+#ifdef HAVE_MPI
+            if (mpi_collective) MPI_Barrier(MPI_COMM_WORLD);
+#endif
             double start_time = getCurrentTime();
-            parallelInsertionSortMPIAsc(arr, array_size);  // Will fallback
+            parallelInsertionSortMPIStats(arr, array_size, 1, &run_stats);
             double end_time = getCurrentTime();
             
-            times[3] += (end_time - start_time);
-            free(arr);
+            if (rank == 0 && run >= 0) {
+                samples[run] = end_time - start_time;
+                accumulateSortStats(&method_stats[3], &run_stats);
+            }
+        }
+        if (rank == 0) {
+            computeSampleStats(samples, NUM_RUNS, &time_stats[3]);
+            times[3] = time_stats[3].median;
         }
-        times[3] /= NUM_RUNS;
-        free(original);
     }
-#endif
+    
+    free(original);
+    free(arr);
     
     // Only rank 0 prints results
     if (rank == 0) {
@@ -702,6 +1096,12 @@ void runAllComparison(void) {
             printf("%-15s | %-12.6f | %-10.2f\n", methods[i], times[i], speedup);
         }
         
+        printf("\n" CYAN "=== PHÂN BỐ THỜI GIAN (giây) ===" RESET "\n");
+        printSampleStatsHeader();
+        for (int i = 0; i < 4; i++) {
+            printSampleStats(methods[i], &time_stats[i]);
+        }
+        
         printf("\n" CYAN "=== PHÂN TÍCH ===" RESET "\n");
         printf("Hiệu suất tốt nhất: ");
         int best = 0;
@@ -712,6 +1112,28 @@ void runAllComparison(void) {
         
         printf("Tăng tốc tốt nhất: %.2fx (%s)\n", times[0] / times[best], methods[best]);
         
+        printf("\n" CYAN "=== THỜI GIAN THEO PHA (TB, giây) ===" RESET "\n");
+        printSortStatsHeader();
+        for (int i = 0; i < 4; i++) {
+            scaleSortStats(&method_stats[i], 1.0 / NUM_RUNS);
+            printSortStats(methods[i], &method_stats[i]);
+        }
+        
+        printBandwidthStatsHeader();
+        for (int i = 0; i < 4; i++) {
+            printBandwidthStats(methods[i], &method_stats[i]);
+        }
+        
+        printMemoryStatsHeader();
+        for (int i = 0; i < 4; i++) {
+            printMemoryStats(methods[i], &method_stats[i].memory);
+        }
+        
+        printCounterStatsHeader();
+        for (int i = 0; i < 4; i++) {
+            printCounterStats(methods[i], &method_stats[i]);
+        }
+        
 #ifdef HAVE_MPI
         if (isMPIInitialized()) {
             printf("💡 MPI đang chạy với %d tiến trình\n", size);
@@ -725,6 +1147,28 @@ void runAllComparison(void) {
 void overallTestOGT(void) {
     int choice;
     
+    // Seed cố định để các lần chạy benchmark tái lập được
+    const char* seed_env = getenv("OGT_SEED");
+    if (seed_env != NULL) {
+        setRandomSeed(strtoull(seed_env, NULL, 0));
+    }
+    
+    const char* dist_env = getenv("OGT_DIST");
+    if (dist_env != NULL) {
+        int dist = parseDistributionSpec(dist_env, &benchmark_dist_param);
+        if (dist >= 0) {
+            benchmark_distribution = (OGTDistribution)dist;
+        } else {
+            printf(YELLOW "⚠️  Phân phối '%s' không hợp lệ, dùng uniform" RESET "\n", dist_env);
+        }
+    }
+    
+    // Bộ đếm phần cứng theo pha (mọi rank đọc cùng biến môi trường)
+    const char* perf_env = getenv("OGT_PERF");
+    if (perf_env != NULL && strcmp(perf_env, "1") == 0) {
+        setHardwareCounters(1);
+    }
+    
     // Show library info at startup
     
     
@@ -785,6 +1229,7 @@ void overallTestOGT(void) {
             printf("4. 🌐 MPI\n");
             printf("5. 📊 So Sánh Tất Cả (Compare All)\n");
             printf("6. ℹ️  Thông Tin Hệ Thống (System Info)\n");
+            printf("7. 🎲 Phân Phối Dữ Liệu (%s)\n", benchmarkDistributionName());
             printf("0. 🚪 Thoát (Exit)\n");
             printf("Lựa chọn: ");
             
@@ -1024,13 +1469,17 @@ void overallTestOGT(void) {
                 printSystemInformation();
                 break;
                 
+            case 7:
+                selectDistribution();
+                break;
+                
             case 0:
                 printf(GREEN "\n👋 Tạm biệt từ Thư viện Sort OGT!\n");
                 printf("Cảm ơn bạn đã test!" RESET "\n");
                 break;
                 
             default:
-                printf(RED "❌ Lựa chọn không hợp lệ! Vui lòng chọn 0-6." RESET "\n");
+                printf(RED "❌ Lựa chọn không hợp lệ! Vui lòng chọn 0-7." RESET "\n");
                 break;
         }
         
@@ -1124,7 +1573,7 @@ void benchmarkMPISort(int array_size) {
     if (rank == 0) {
         for (int run = 0; run < NUM_RUNS; run++) {
             int *arr = malloc(array_size * sizeof(int));
-            generateRandomArray(arr, array_size, MAX_VALUE);
+            generateBenchmarkArray(arr, array_size);
             
             double start_time = getCurrentTime();
             insertionSortAsc(arr, array_size);
@@ -1140,11 +1589,11 @@ void benchmarkMPISort(int array_size) {
     for (int run = 0; run < NUM_RUNS; run++) {
         int *arr = NULL;
         
-        // Only rank 0 generates and allocates the array
+        // Only rank 0 allocates the array, every rank generates its shard
         if (rank == 0) {
             arr = malloc(array_size * sizeof(int));
-            generateRandomArray(arr, array_size, MAX_VALUE);
         }
+        generateBenchmarkArrayMPI(arr, array_size);
         
         double start_time = getCurrentTime();
         parallelInsertionSortMPIAsc(arr, array_size);
@@ -0,0 +1,205 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <errno.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/**
+ * Bộ đếm phần cứng qua perf_event_open (chỉ Linux)
+ *
+ * Mỗi luồng mở bộ đếm của chính nó (pid = 0, cpu = -1), chỉ đếm ở user space
+ * để chạy được với perf_event_paranoid <= 2. Bộ đếm nào không mở được
+ * (không có PMU, máy ảo, quyền hạn) được đánh dấu không khả dụng và bỏ qua;
+ * giá trị được hiệu chỉnh theo time_enabled/time_running khi bị multiplex.
+ */
+
+// Bật/tắt thu thập bộ đếm cho các hàm *Stats (phải giống nhau trên mọi rank MPI)
+static int counters_enabled = 0;
+
+void setHardwareCounters(int enabled) {
+    counters_enabled = enabled ? 1 : 0;
+}
+
+int getHardwareCounters(void) {
+    return counters_enabled;
+}
+
+const char* counterName(OGTCounter counter) {
+    static const char* names[OGT_COUNTER_COUNT] = {
+        "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses", "dtlb-misses"
+    };
+    if (counter < 0 || counter >= OGT_COUNTER_COUNT) return "?";
+    return names[counter];
+}
+
+#ifdef __linux__
+
+static void counterAttr(OGTCounter counter, struct perf_event_attr* attr) {
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->disabled = 1;
+    attr->exclude_kernel = 1;
+    attr->exclude_hv = 1;
+    attr->read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (counter) {
+        case OGT_COUNTER_CYCLES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case OGT_COUNTER_INSTRUCTIONS:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case OGT_COUNTER_L1D_MISSES:
+            attr->type = PERF_TYPE_HW_CACHE;
+            attr->config = PERF_COUNT_HW_CACHE_L1D |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case OGT_COUNTER_LLC_MISSES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case OGT_COUNTER_BRANCH_MISSES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case OGT_COUNTER_DTLB_MISSES:
+        default:
+            attr->type = PERF_TYPE_HW_CACHE;
+            attr->config = PERF_COUNT_HW_CACHE_DTLB |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+    }
+}
+
+/**
+ * Mở các bộ đếm cho luồng gọi hàm
+ * @return Số bộ đếm mở được (0 nếu không có bộ đếm nào khả dụng)
+ */
+int counterGroupOpen(OGTCounterGroup* group) {
+    int opened = 0;
+    for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+        struct perf_event_attr attr;
+        counterAttr((OGTCounter)c, &attr);
+        group->fd[c] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (group->fd[c] >= 0) opened++;
+    }
+    return opened;
+}
+
+void counterGroupStart(OGTCounterGroup* group) {
+    for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+        if (group->fd[c] < 0) continue;
+        ioctl(group->fd[c], PERF_EVENT_IOC_RESET, 0);
+        ioctl(group->fd[c], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+// Dừng đếm và cộng giá trị vào out
+void counterGroupStop(OGTCounterGroup* group, OGTCounterValues* out) {
+    for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+        if (group->fd[c] < 0) continue;
+        ioctl(group->fd[c], PERF_EVENT_IOC_DISABLE, 0);
+
+        // value, time_enabled, time_running
+        unsigned long long data[3];
+        if (read(group->fd[c], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+
+        double value = (double)data[0];
+        if (data[2] > 0 && data[2] < data[1]) {
+            value *= (double)data[1] / (double)data[2];
+        }
+        out->value[c] += value;
+        out->valid |= 1u << c;
+    }
+}
+
+void counterGroupClose(OGTCounterGroup* group) {
+    for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+        if (group->fd[c] >= 0) close(group->fd[c]);
+        group->fd[c] = -1;
+    }
+}
+
+#else // không phải Linux: không có bộ đếm
+
+int counterGroupOpen(OGTCounterGroup* group) {
+    for (int c = 0; c < OGT_COUNTER_COUNT; c++) group->fd[c] = -1;
+    return 0;
+}
+
+void counterGroupStart(OGTCounterGroup* group) {
+    (void)group;
+}
+
+void counterGroupStop(OGTCounterGroup* group, OGTCounterValues* out) {
+    (void)group;
+    (void)out;
+}
+
+void counterGroupClose(OGTCounterGroup* group) {
+    (void)group;
+}
+
+#endif // __linux__
+
+/**
+ * Kiểm tra một lần xem có bộ đếm nào mở được không
+ * @return Bitmask các bộ đếm khả dụng
+ */
+unsigned int hardwareCountersAvailable(void) {
+    static int probed = 0;
+    static unsigned int available = 0;
+    if (probed) return available;
+
+    OGTCounterGroup group;
+    counterGroupOpen(&group);
+    for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+        if (group.fd[c] >= 0) available |= 1u << c;
+    }
+    counterGroupClose(&group);
+    probed = 1;
+    return available;
+}
+
+// Mở và bắt đầu đếm nếu đang bật thu thập; trả về 0 nếu không đếm
+int counterBegin(OGTCounterGroup* group) {
+    if (!counters_enabled) return 0;
+    if (counterGroupOpen(group) == 0) {
+        counterGroupClose(group);
+        return 0;
+    }
+    counterGroupStart(group);
+    return 1;
+}
+
+// Dừng, cộng vào out rồi đóng bộ đếm đã mở bằng counterBegin
+void counterEnd(OGTCounterGroup* group, OGTCounterValues* out) {
+    counterGroupStop(group, out);
+    counterGroupClose(group);
+}
+
+void addCounterValues(OGTCounterValues* sum, const OGTCounterValues* values) {
+    for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+        sum->value[c] += values->value[c];
+    }
+    sum->valid |= values->valid;
+}
+
+int counterValid(const OGTCounterValues* values, OGTCounter counter) {
+    return (values->valid >> counter) & 1u;
+}
+
+double counterIPC(const OGTCounterValues* values) {
+    if (!counterValid(values, OGT_COUNTER_CYCLES) || !counterValid(values, OGT_COUNTER_INSTRUCTIONS)) return 0.0;
+    if (values->value[OGT_COUNTER_CYCLES] <= 0.0) return 0.0;
+    return values->value[OGT_COUNTER_INSTRUCTIONS] / values->value[OGT_COUNTER_CYCLES];
+}
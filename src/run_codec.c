@@ -0,0 +1,139 @@
+#include "sort_ogt.h"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Codec nén run đã sắp xếp: delta + bit-packing theo khối (frame-of-reference)
+ *
+ * Định dạng:
+ *   [4 byte] phần tử đầu tiên (int32 little-endian)
+ *   Với mỗi khối tối đa OGT_CODEC_BLOCK delta:
+ *     [1 byte] số bit b của delta lớn nhất trong khối
+ *     [ceil(cnt * b / 8) byte] các delta được đóng gói, bit thấp trước
+ *
+ * Delta luôn không âm: v[i] - v[i-1] khi tăng dần, v[i-1] - v[i] khi giảm dần.
+ * Số phần tử n không được lưu, bên nhận đã biết từ send_counts.
+ */
+
+// Số bit cần để biểu diễn x
+static int bitWidth(uint32_t x) {
+    int b = 0;
+    while (x) {
+        b++;
+        x >>= 1;
+    }
+    return b;
+}
+
+static uint32_t runDelta(int prev, int cur, int ascending) {
+    // Tính bằng số học không dấu để tránh tràn khi khoảng giá trị rộng
+    return ascending ? (uint32_t)cur - (uint32_t)prev : (uint32_t)prev - (uint32_t)cur;
+}
+
+size_t deltaCodecMaxBytes(int n) {
+    if (n <= 0) return 0;
+    size_t blocks = ((size_t)(n - 1) + OGT_CODEC_BLOCK - 1) / OGT_CODEC_BLOCK;
+    return sizeof(int32_t) + blocks * (1 + OGT_CODEC_BLOCK * sizeof(uint32_t));
+}
+
+size_t deltaCodecEncode(const int src[], int n, int ascending, unsigned char* out) {
+    if (n <= 0) return 0;
+
+    unsigned char* p = out;
+    int32_t first = src[0];
+    memcpy(p, &first, sizeof(first));
+    p += sizeof(first);
+
+    uint32_t deltas[OGT_CODEC_BLOCK];
+
+    for (int start = 1; start < n; start += OGT_CODEC_BLOCK) {
+        int count = n - start < OGT_CODEC_BLOCK ? n - start : OGT_CODEC_BLOCK;
+
+        // Tìm delta lớn nhất để chọn số bit cho cả khối
+        uint32_t max_delta = 0;
+        for (int i = 0; i < count; i++) {
+            deltas[i] = runDelta(src[start + i - 1], src[start + i], ascending);
+            max_delta |= deltas[i];
+        }
+        int bits = bitWidth(max_delta);
+        *p++ = (unsigned char)bits;
+
+        // Đóng gói delta vào bộ tích lũy 64 bit
+        uint64_t acc = 0;
+        int acc_bits = 0;
+        for (int i = 0; i < count; i++) {
+            acc |= (uint64_t)deltas[i] << acc_bits;
+            acc_bits += bits;
+            while (acc_bits >= 8) {
+                *p++ = (unsigned char)acc;
+                acc >>= 8;
+                acc_bits -= 8;
+            }
+        }
+        if (acc_bits > 0) {
+            *p++ = (unsigned char)acc;
+        }
+    }
+
+    return (size_t)(p - out);
+}
+
+void deltaDecoderInit(DeltaDecoder* d, const unsigned char* buf, int n, int ascending) {
+    d->src = buf;
+    d->remaining = n;
+    d->ascending = ascending;
+    d->block_len = 0;
+    d->block_pos = 0;
+    d->first = 1;
+    d->last = 0;
+}
+
+// Giải nén khối delta kế tiếp vào d->block
+static void deltaDecoderFill(DeltaDecoder* d) {
+    int count = d->remaining < OGT_CODEC_BLOCK ? d->remaining : OGT_CODEC_BLOCK;
+    int bits = *d->src++;
+    uint64_t mask = bits == 32 ? 0xFFFFFFFFu : ((uint64_t)1 << bits) - 1;
+
+    uint64_t acc = 0;
+    int acc_bits = 0;
+    int value = d->last;
+    for (int i = 0; i < count; i++) {
+        while (acc_bits < bits) {
+            acc |= (uint64_t)(*d->src++) << acc_bits;
+            acc_bits += 8;
+        }
+        uint32_t delta = (uint32_t)(acc & mask);
+        acc >>= bits;
+        acc_bits -= bits;
+
+        value = d->ascending ? (int)((uint32_t)value + delta) : (int)((uint32_t)value - delta);
+        d->block[i] = value;
+    }
+
+    d->block_len = count;
+    d->block_pos = 0;
+}
+
+int deltaDecoderNext(DeltaDecoder* d, int* out) {
+    if (d->remaining <= 0) return 0;
+
+    if (d->first) {
+        int32_t first;
+        memcpy(&first, d->src, sizeof(first));
+        d->src += sizeof(first);
+        d->first = 0;
+        d->last = first;
+        d->remaining--;
+        *out = first;
+        return 1;
+    }
+
+    if (d->block_pos == d->block_len) {
+        deltaDecoderFill(d);
+    }
+
+    d->last = d->block[d->block_pos++];
+    d->remaining--;
+    *out = d->last;
+    return 1;
+}
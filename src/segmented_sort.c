@@ -0,0 +1,161 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <limits.h>
+#include <omp.h>
+
+/**
+ * Sắp xếp phân đoạn: nhiều mảng độc lập trong một buffer, một vùng song song cho cả lô
+ *
+ * Đoạn nhỏ (dưới ngưỡng tuần tự của hồ sơ) được sắp xếp nguyên bởi một luồng, chia động
+ * theo nhóm OGT_SEGMENT_GRAIN đoạn để mỗi luồng nhận nhiều đoạn mà chi phí lập lịch vẫn nhỏ.
+ * Đoạn lớn được chia khối như các backend (tuningChunkCount), các khối được lập lịch trước
+ * (khối lớn nhất trước) rồi luồng rảnh chuyển sang đoạn nhỏ; sau rào chắn, mỗi đoạn lớn được
+ * một luồng trộn cây qua vùng tạm.
+ */
+
+#define OGT_SEGMENT_GRAIN 16    // đoạn nhỏ mỗi lần chia động
+
+typedef struct {
+    long long start;            // vị trí trong data
+    int size;
+} SegmentChunk;
+
+typedef struct {
+    long long start;
+    int size;
+    int first_bound;            // vị trí trong bảng bounds
+    int num_chunks;
+    long long scratch_offset;
+} LargeSegment;
+
+static void sortRange(int* a, int n, int ascending) {
+    if (ascending) {
+        insertionSortAsc(a, n);
+    } else {
+        insertionSortDesc(a, n);
+    }
+}
+
+int segmentedSort(int data[], const long long offsets[], int num_segments, int num_threads,
+                  int ascending, OGTSortStats* stats) {
+    if (stats) resetSortStats(stats);
+    if (num_segments < 0 || (num_segments > 0 && offsets[0] < 0)) {
+        printf(RED "Lỗi: Bảng offset phân đoạn không hợp lệ\n" RESET);
+        return -1;
+    }
+    for (int s = 0; s < num_segments; s++) {
+        long long size = offsets[s + 1] - offsets[s];
+        if (size < 0 || size > INT_MAX) {
+            printf(RED "Lỗi: Đoạn %d có kích thước không hợp lệ (%lld)\n" RESET, s, size);
+            return -1;
+        }
+    }
+    if (num_threads < 1) num_threads = omp_get_max_threads();
+
+    OGTMemScope memory;
+    if (stats) memScopeBegin(&memory);
+    unsigned long long trace_begin = traceNow();
+    double t_begin = getCurrentTime();
+
+    // Đoạn lớn: đếm khối và vùng tạm cần cho trộn
+    int cutoff = ogtTuning()->seq_cutoff;
+    int num_large = 0;
+    long long total_chunks = 0, scratch_size = 0;
+    for (int s = 0; s < num_segments; s++) {
+        int size = (int)(offsets[s + 1] - offsets[s]);
+        if (size < cutoff || num_threads == 1) continue;
+        num_large++;
+        total_chunks += tuningChunkCount(size, num_threads);
+        scratch_size += size;
+    }
+
+    LargeSegment* large = num_large ? (LargeSegment*)ogtMalloc(num_large * sizeof(LargeSegment)) : NULL;
+    SegmentChunk* chunks = total_chunks ? (SegmentChunk*)ogtMalloc(total_chunks * sizeof(SegmentChunk)) : NULL;
+    int* bounds = num_large ? (int*)ogtMalloc((total_chunks + num_large) * sizeof(int)) : NULL;
+    int* scratch = scratch_size ? (int*)ogtMalloc((size_t)scratch_size * sizeof(int)) : NULL;
+    if (num_large && (!large || !chunks || !bounds || !scratch)) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho %d đoạn lớn\n" RESET, num_large);
+        ogtFree(large);
+        ogtFree(chunks);
+        ogtFree(bounds);
+        ogtFree(scratch);
+        if (stats) memScopeEnd(&memory, &stats->memory);
+        return -1;
+    }
+
+    int l = 0, next_chunk = 0, next_bound = 0;
+    long long scratch_offset = 0;
+    for (int s = 0; s < num_segments && num_large; s++) {
+        int size = (int)(offsets[s + 1] - offsets[s]);
+        if (size < cutoff || num_threads == 1) continue;
+        int k = tuningChunkCount(size, num_threads);
+        LargeSegment* seg = &large[l++];
+        seg->start = offsets[s];
+        seg->size = size;
+        seg->first_bound = next_bound;
+        seg->num_chunks = k;
+        seg->scratch_offset = scratch_offset;
+        scratch_offset += size;
+
+        int chunk_size = size / k, remainder = size % k;
+        bounds[next_bound] = 0;
+        for (int c = 0; c < k; c++) {
+            int len = chunk_size + (c < remainder ? 1 : 0);
+            chunks[next_chunk].start = seg->start + bounds[next_bound + c];
+            chunks[next_chunk].size = len;
+            bounds[next_bound + c + 1] = bounds[next_bound + c] + len;
+            next_chunk++;
+        }
+        next_bound += k + 1;
+    }
+
+    double t_split = getCurrentTime();
+    double t_sorted = t_split;
+
+    // Số khối theo num_threads, đội luồng do governor cấp
+    int team = governorAcquire(num_threads);
+    #pragma omp parallel num_threads(team)
+    {
+        // Khối của đoạn lớn trước: việc dài nhất vào hàng đợi đầu tiên
+        #pragma omp for schedule(dynamic, 1) nowait
+        for (long long c = 0; c < total_chunks; c++) {
+            sortRange(data + chunks[c].start, chunks[c].size, ascending);
+        }
+
+        #pragma omp for schedule(dynamic, OGT_SEGMENT_GRAIN)
+        for (int s = 0; s < num_segments; s++) {
+            int size = (int)(offsets[s + 1] - offsets[s]);
+            if (size >= cutoff && num_threads > 1) continue;
+            sortRange(data + offsets[s], size, ascending);
+        }
+
+        #pragma omp single
+        t_sorted = getCurrentTime();
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < num_large; i++) {
+            LargeSegment* seg = &large[i];
+            merge_adjacent_runs(data + seg->start, scratch + seg->scratch_offset,
+                                bounds + seg->first_bound, seg->num_chunks, seg->size, ascending);
+        }
+    }
+    governorRelease(team);
+
+    double t_end = getCurrentTime();
+    traceSpan("segmented-sort", trace_begin, num_segments);
+
+    ogtFree(large);
+    ogtFree(chunks);
+    ogtFree(bounds);
+    ogtFree(scratch);
+
+    if (stats) {
+        stats->num_threads = team;
+        stats->phase_time[OGT_PHASE_SPLIT] = t_split - t_begin;
+        stats->phase_time[OGT_PHASE_SORT] = t_sorted - t_split;
+        stats->phase_time[OGT_PHASE_MERGE] = t_end - t_sorted;
+        stats->total_time = getCurrentTime() - t_begin;
+        memScopeEnd(&memory, &stats->memory);
+    }
+    return 0;
+}
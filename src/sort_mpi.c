@@ -1,21 +1,7 @@
 #include "sort_ogt.h"
 #include <string.h>
 
-#ifdef HAVE_MPI
-#include <mpi.h>
-#include <sys/time.h>
-
-// Định nghĩa cấu trúc để quản lý thông tin phân đoạn (chunk) trong MPI
-// start: vị trí bắt đầu của chunk
-// end: vị trí kết thúc của chunk
-// size: kích thước của chunk
-// rank: chỉ số của tiến trình
-typedef struct {
-    int start;
-    int end;
-    int size;
-    int rank;
-} MPIChunkInfo;
+// Các hàm trộn không gọi MPI nên luôn được biên dịch (dùng lại trong bench_kernels)
 
 /**
  * Hàm trộn hai mảng con đã được sắp xếp thành một mảng đã sắp xếp
@@ -31,8 +17,8 @@ void merge_two_arrays_mpi(int arr[], int left, int mid, int right, int ascending
     int n2 = right - mid;
     
     // Tạo mảng tạm thời
-    int* left_arr = (int*)malloc(n1 * sizeof(int));
-    int* right_arr = (int*)malloc(n2 * sizeof(int));
+    int* left_arr = (int*)ogtMalloc(n1 * sizeof(int));
+    int* right_arr = (int*)ogtMalloc(n2 * sizeof(int));
     
     // Sao chép dữ liệu vào mảng tạm thời
     for (i = 0; i < n1; i++)
@@ -78,8 +64,8 @@ void merge_two_arrays_mpi(int arr[], int left, int mid, int right, int ascending
         j++; k++;
     }
     
-    free(left_arr);
-    free(right_arr);
+    ogtFree(left_arr);
+    ogtFree(right_arr);
 }
 
 /**
@@ -94,7 +80,7 @@ void merge_mpi_chunks(int arr[], int* chunk_sizes, int num_procs, int total_size
     if (num_procs <= 1) return;
     
     // Tính toán vị trí các chunk
-    int* chunk_starts = (int*)malloc(num_procs * sizeof(int));
+    int* chunk_starts = (int*)ogtMalloc(num_procs * sizeof(int));
     chunk_starts[0] = 0;
     for (int i = 1; i < num_procs; i++) {
         chunk_starts[i] = chunk_starts[i-1] + chunk_sizes[i-1];
@@ -152,7 +138,216 @@ void merge_mpi_chunks(int arr[], int* chunk_sizes, int num_procs, int total_size
         active_chunks = new_active;
     }
     
-    free(chunk_starts);
+    ogtFree(chunk_starts);
+}
+
+#ifdef HAVE_MPI
+#include <mpi.h>
+#include <sys/time.h>
+
+// Định nghĩa cấu trúc để quản lý thông tin phân đoạn (chunk) trong MPI
+// start: vị trí bắt đầu của chunk
+// end: vị trí kết thúc của chunk
+// size: kích thước của chunk
+// rank: chỉ số của tiến trình
+typedef struct {
+    int start;
+    int end;
+    int size;
+    int rank;
+} MPIChunkInfo;
+
+// Nén các run đã sắp xếp trước khi gather (mặc định tắt)
+static int mpi_compression = 0;
+
+void setMPICompression(int enabled) {
+    mpi_compression = enabled ? 1 : 0;
+}
+
+int getMPICompression(void) {
+    return mpi_compression;
+}
+
+// Communicator dùng cho sắp xếp MPI (MPI_COMM_NULL = MPI_COMM_WORLD)
+static MPI_Comm sort_comm = MPI_COMM_NULL;
+
+void setMPICommunicator(MPI_Comm comm) {
+    sort_comm = comm;
+}
+
+MPI_Comm getMPICommunicator(void) {
+    return sort_comm == MPI_COMM_NULL ? MPI_COMM_WORLD : sort_comm;
+}
+
+/**
+ * Giải nén các run về đúng vị trí của chúng trong arr rồi trộn cặp đôi như đường không nén
+ * @param arr: Mảng kết quả (total_size phần tử)
+ * @param buf: Bộ đệm chứa dữ liệu nén của tất cả tiến trình
+ * @param byte_displs: Vị trí bắt đầu dữ liệu nén của từng tiến trình trong buf
+ * @param chunk_sizes: Số phần tử của từng run (bị ghi đè bởi merge_mpi_chunks)
+ * @param num_procs: Số lượng tiến trình
+ * @param total_size: Tổng kích thước mảng
+ * @param ascending: 1 nếu sắp xếp tăng dần, 0 nếu sắp xếp giảm dần
+ */
+static void merge_mpi_compressed_chunks(int arr[], const unsigned char* buf, const int* byte_displs,
+                                        int* chunk_sizes, int num_procs, int total_size, int ascending) {
+    int offset = 0;
+    for (int i = 0; i < num_procs; i++) {
+        DeltaDecoder decoder;
+        deltaDecoderInit(&decoder, buf + byte_displs[i], chunk_sizes[i], ascending);
+        for (int j = 0; j < chunk_sizes[i]; j++) deltaDecoderNext(&decoder, &arr[offset + j]);
+        offset += chunk_sizes[i];
+    }
+
+    merge_mpi_chunks(arr, chunk_sizes, num_procs, total_size, ascending);
+}
+
+/**
+ * Gather các run đã sắp xếp ở dạng nén delta + bit-packing rồi trộn tại rank 0
+ * Chỉ gửi số byte nén thay vì 4 byte mỗi phần tử
+ * @param phase_time: Thời gian gather (gồm cả nén) và trộn của tiến trình hiện tại
+ * @param phase_bytes: Số byte gửi đi trong pha gather
+ */
+static void gatherAndMergeCompressed(int a[], const int local_array[], int local_chunk_size,
+                                     int* send_counts, int n, int ascending,
+                                     int rank, int size,
+                                     double phase_time[], long long phase_bytes[],
+                                     OGTCounterValues* merge_counters) {
+    double t_begin = MPI_Wtime();
+    unsigned long long trace_encode = traceNow();
+    unsigned char* encoded = (unsigned char*)ogtMalloc(deltaCodecMaxBytes(local_chunk_size) + 1);
+    int encoded_bytes = (int)deltaCodecEncode(local_array, local_chunk_size, ascending, encoded);
+    traceSpan("encode", trace_encode, local_chunk_size);
+
+    int* byte_counts = NULL;
+    int* byte_displs = NULL;
+    unsigned char* recv_buf = NULL;
+
+    if (rank == 0) {
+        byte_counts = (int*)ogtMalloc(size * sizeof(int));
+        byte_displs = (int*)ogtMalloc(size * sizeof(int));
+    }
+
+    // Rank 0 cần biết kích thước nén của từng rank trước khi nhận
+    unsigned long long trace_gather = traceNow();
+    MPI_Gather(&encoded_bytes, 1, MPI_INT, byte_counts, 1, MPI_INT, 0, getMPICommunicator());
+
+    if (rank == 0) {
+        int total_bytes = 0;
+        for (int i = 0; i < size; i++) {
+            byte_displs[i] = total_bytes;
+            total_bytes += byte_counts[i];
+        }
+        recv_buf = (unsigned char*)ogtMalloc(total_bytes > 0 ? total_bytes : 1);
+    }
+
+    MPI_Gatherv(encoded, encoded_bytes, MPI_BYTE,
+                recv_buf, byte_counts, byte_displs, MPI_BYTE, 0, getMPICommunicator());
+
+    double t_comm = MPI_Wtime();
+    traceSpan("MPI_Gatherv", trace_gather, encoded_bytes);
+    
+    if (rank == 0) {
+        OGTCounterGroup counters;
+        int counting = merge_counters && counterBegin(&counters);
+        if (counting) t_comm = MPI_Wtime();
+        unsigned long long trace_merge = traceNow();
+        merge_mpi_compressed_chunks(a, recv_buf, byte_displs, send_counts, size, n, ascending);
+        phase_time[OGT_MPI_PHASE_MERGE] = MPI_Wtime() - t_comm;
+        traceSpan("merge", trace_merge, n);
+        if (counting) counterEnd(&counters, merge_counters);
+        ogtFree(byte_counts);
+        ogtFree(byte_displs);
+        ogtFree(recv_buf);
+    }
+
+    ogtFree(encoded);
+    
+    // Thời gian nén được tính vào pha gather
+    phase_time[OGT_MPI_PHASE_GATHER] = t_comm - t_begin;
+    phase_bytes[OGT_MPI_PHASE_GATHER] = encoded_bytes + (long long)sizeof(int);
+}
+
+/**
+ * Thu bộ đếm phần cứng pha sort của mọi rank về rank 0
+ * Hàm tập thể: mọi rank gọi khi getHardwareCounters() bật
+ */
+static void gatherMPICounters(const OGTCounterValues* local, int rank, int size, OGTSortStats* stats) {
+    // OGT_COUNTER_COUNT giá trị, phần tử cuối là mặt nạ bộ đếm hợp lệ
+    double send[OGT_COUNTER_COUNT + 1];
+    double* recv = NULL;
+    for (int c = 0; c < OGT_COUNTER_COUNT; c++) send[c] = local->value[c];
+    send[OGT_COUNTER_COUNT] = (double)local->valid;
+
+    if (rank == 0) recv = (double*)malloc((size_t)size * (OGT_COUNTER_COUNT + 1) * sizeof(double));
+    MPI_Gather(send, OGT_COUNTER_COUNT + 1, MPI_DOUBLE, recv, OGT_COUNTER_COUNT + 1, MPI_DOUBLE, 0, getMPICommunicator());
+
+    if (rank == 0) {
+        if (stats) {
+            memset(&stats->phase_counters[OGT_PHASE_SORT], 0, sizeof(OGTCounterValues));
+            for (int r = 0; r < size; r++) {
+                OGTCounterValues values;
+                const double* row = recv + (size_t)r * (OGT_COUNTER_COUNT + 1);
+                for (int c = 0; c < OGT_COUNTER_COUNT; c++) values.value[c] = row[c];
+                values.valid = (unsigned int)row[OGT_COUNTER_COUNT];
+                if (r < OGT_STATS_MAX_THREADS) stats->thread_counters[r] = values;
+                addCounterValues(&stats->phase_counters[OGT_PHASE_SORT], &values);
+            }
+        }
+        free(recv);
+    }
+}
+
+/**
+ * Gộp thời gian và số byte theo pha của mọi rank về rank 0 (min/avg/max, rank chậm nhất),
+ * cùng bộ nhớ của rank 0 và max bộ nhớ trên các rank còn lại
+ * Hàm tập thể: mọi rank phải gọi
+ */
+static void reduceMPIPhaseStats(const double phase_time[], const long long phase_bytes[],
+                                const OGTMemStats* memory, int rank, int size,
+                                OGTMPIPhaseStats* rank_stats) {
+    struct {
+        double value;
+        int rank;
+    } local_loc[OGT_MPI_PHASE_COUNT], max_loc[OGT_MPI_PHASE_COUNT];
+    double sum_time[OGT_MPI_PHASE_COUNT];
+
+    for (int p = 0; p < OGT_MPI_PHASE_COUNT; p++) {
+        local_loc[p].value = phase_time[p];
+        local_loc[p].rank = rank;
+    }
+
+    unsigned long long trace_reduce = traceNow();
+    MPI_Reduce(phase_time, rank_stats->min_time, OGT_MPI_PHASE_COUNT, MPI_DOUBLE, MPI_MIN, 0, getMPICommunicator());
+    MPI_Reduce(phase_time, sum_time, OGT_MPI_PHASE_COUNT, MPI_DOUBLE, MPI_SUM, 0, getMPICommunicator());
+    MPI_Reduce(local_loc, max_loc, OGT_MPI_PHASE_COUNT, MPI_DOUBLE_INT, MPI_MAXLOC, 0, getMPICommunicator());
+    MPI_Reduce(phase_bytes, rank_stats->bytes, OGT_MPI_PHASE_COUNT, MPI_LONG_LONG, MPI_SUM, 0, getMPICommunicator());
+
+    // Rank 0 gửi -1 để max chỉ lấy trên các rank còn lại
+    long long local_memory[4] = { -1, -1, -1, -1 };
+    long long other_memory[4];
+    if (rank != 0) {
+        local_memory[0] = memory->bytes_allocated;
+        local_memory[1] = memory->allocations;
+        local_memory[2] = memory->peak_bytes;
+        local_memory[3] = memory->peak_rss_kb;
+    }
+    MPI_Reduce(local_memory, other_memory, 4, MPI_LONG_LONG, MPI_MAX, 0, getMPICommunicator());
+    traceSpan("MPI_Reduce", trace_reduce, -1);
+
+    if (rank == 0) {
+        rank_stats->num_ranks = size;
+        rank_stats->root_memory = *memory;
+        rank_stats->other_memory.bytes_allocated = other_memory[0];
+        rank_stats->other_memory.allocations = other_memory[1];
+        rank_stats->other_memory.peak_bytes = other_memory[2];
+        rank_stats->other_memory.peak_rss_kb = other_memory[3];
+        for (int p = 0; p < OGT_MPI_PHASE_COUNT; p++) {
+            rank_stats->avg_time[p] = sum_time[p] / size;
+            rank_stats->max_time[p] = max_loc[p].value;
+            rank_stats->max_rank[p] = max_loc[p].rank;
+        }
+    }
 }
 
 /**
@@ -165,24 +360,50 @@ void merge_mpi_chunks(int arr[], int* chunk_sizes, int num_procs, int total_size
  * @param a: Mảng cần sắp xếp
  * @param n: Kích thước mảng
  * @param ascending: 1 nếu sắp xếp tăng dần, 0 nếu sắp xếp giảm dần
+ * @param stats: Thời gian theo pha của tiến trình hiện tại (có thể NULL)
+ * @param rank_stats: Thời gian từng pha gộp trên mọi rank, hợp lệ tại rank 0
+ *                    (NULL hoặc khác NULL đồng thời trên mọi rank)
  */
-void parallelInsertionSortMPI(int a[], int n, int ascending) {
+void parallelInsertionSortMPIRankStats(int a[], int n, int ascending,
+                                       OGTSortStats* stats, OGTMPIPhaseStats* rank_stats) {
     int rank, size;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_rank(getMPICommunicator(), &rank);
+    MPI_Comm_size(getMPICommunicator(), &size);
     
+    // Thời gian (MPI_Wtime) và số byte của từng pha trên rank hiện tại
+    double phase_time[OGT_MPI_PHASE_COUNT] = {0};
+    long long phase_bytes[OGT_MPI_PHASE_COUNT] = {0};
+    
+    if (stats) {
+        resetSortStats(stats);
+        stats->num_threads = size;
+    }
+    if (rank_stats) memset(rank_stats, 0, sizeof(*rank_stats));
     if (n <= 1) return;
     
-    // Sử dụng sắp xếp tuần tự cho mảng nhỏ hoặc khi chỉ có một tiến trình
-    // để tránh chi phí phụ trội của việc thiết lập MPI
-    if (n < 1000 || size <= 1) {
+    // Bộ nhớ của rank hiện tại, cần cả khi chỉ gộp rank_stats
+    OGTMemScope memory_scope;
+    OGTMemStats memory = { 0, 0, 0, -1 };
+    int tracking_memory = stats || rank_stats;
+    if (tracking_memory) memScopeBegin(&memory_scope);
+    
+    unsigned long long trace_begin = traceNow();
+    double t_begin = MPI_Wtime();
+    
+    // Sử dụng sắp xếp tuần tự cho mảng nhỏ (dưới ngưỡng của hồ sơ tinh chỉnh) hoặc khi chỉ có
+    // một tiến trình để tránh chi phí phụ trội của việc thiết lập MPI. Hồ sơ đọc theo tên máy,
+    // nên ngưỡng lấy của rank 0 để mọi rank cùng rẽ một nhánh.
+    int seq_cutoff = ogtTuning()->seq_cutoff;
+    if (size > 1) MPI_Bcast(&seq_cutoff, 1, MPI_INT, 0, getMPICommunicator());
+    if (n < seq_cutoff || size <= 1) {
         if (rank == 0) {
-            if (ascending) {
-                insertionSortAsc(a, n);
-            } else {
-                insertionSortDesc(a, n);
-            }
+            insertionSortStats(a, n, ascending, stats);
+            phase_time[OGT_MPI_PHASE_LOCAL_SORT] = MPI_Wtime() - t_begin;
+            phase_bytes[OGT_MPI_PHASE_LOCAL_SORT] = (long long)n * sizeof(int);
         }
+        if (tracking_memory) memScopeEnd(&memory_scope, &memory);
+        if (stats) stats->memory = memory;
+        if (rank_stats) reduceMPIPhaseStats(phase_time, phase_bytes, &memory, rank, size, rank_stats);
         return;
     }
     
@@ -200,8 +421,8 @@ void parallelInsertionSortMPI(int a[], int n, int ascending) {
     
     // Chỉ tiến trình gốc (rank 0) cần cấp phát và tính toán thông tin phân phối
     if (rank == 0) {
-        send_counts = (int*)malloc(size * sizeof(int));
-        displacements = (int*)malloc(size * sizeof(int));
+        send_counts = (int*)ogtMalloc(size * sizeof(int));
+        displacements = (int*)ogtMalloc(size * sizeof(int));
         
         int current_pos = 0;
         for (int i = 0; i < size; i++) {
@@ -212,16 +433,30 @@ void parallelInsertionSortMPI(int a[], int n, int ascending) {
     }
     
     // Cấp phát bộ nhớ cho mảng cục bộ của mỗi tiến trình
-    int* local_array = (int*)malloc(local_chunk_size * sizeof(int));
+    int* local_array = (int*)ogtMalloc(local_chunk_size * sizeof(int));
     if (local_array == NULL) {
         printf(RED "Lỗi: Thất bại cấp phát bộ nhớ cho mảng cục bộ tại rank %d\n" RESET, rank);
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
     
+    double t_split = MPI_Wtime();
+    unsigned long long trace_scatter = traceNow();
+    
     // Phân phối dữ liệu từ tiến trình gốc đến tất cả các tiến trình
     // Sử dụng MPI_Scatterv để hỗ trợ phân phối không đều
     MPI_Scatterv(a, send_counts, displacements, MPI_INT, 
-                 local_array, local_chunk_size, MPI_INT, 0, MPI_COMM_WORLD);
+                 local_array, local_chunk_size, MPI_INT, 0, getMPICommunicator());
+    
+    double t_scatter = MPI_Wtime();
+    traceSpan("MPI_Scatterv", trace_scatter, local_chunk_size);
+    
+    // Bộ đếm phần cứng mở ngoài vùng đo thời gian sort
+    OGTCounterGroup counters;
+    OGTCounterValues sort_counters;
+    memset(&sort_counters, 0, sizeof(sort_counters));
+    int counting = counterBegin(&counters);
+    double t_sort_begin = counting ? MPI_Wtime() : t_scatter;
+    unsigned long long trace_sort = traceNow();
     
     // Mỗi tiến trình độc lập sắp xếp phần dữ liệu của mình
     // Không cần đồng bộ hóa trong giai đoạn này
@@ -231,21 +466,87 @@ void parallelInsertionSortMPI(int a[], int n, int ascending) {
         insertionSortDesc(local_array, local_chunk_size);
     }
     
-    // Thu thập tất cả các phân đoạn đã sắp xếp về tiến trình gốc
-    MPI_Gatherv(local_array, local_chunk_size, MPI_INT,
-                a, send_counts, displacements, MPI_INT, 0, MPI_COMM_WORLD);
+    double t_sort = MPI_Wtime();
+    traceSpan("local-sort", trace_sort, local_chunk_size);
+    if (counting) counterEnd(&counters, &sort_counters);
+    phase_time[OGT_MPI_PHASE_SCATTER] = t_scatter - t_split;
+    phase_time[OGT_MPI_PHASE_LOCAL_SORT] = t_sort - t_sort_begin;
+    phase_bytes[OGT_MPI_PHASE_SCATTER] = (long long)local_chunk_size * sizeof(int);
+    phase_bytes[OGT_MPI_PHASE_LOCAL_SORT] = (long long)local_chunk_size * sizeof(int);
+    
+    if (mpi_compression) {
+        // Gửi dạng nén, rank 0 giải nén rồi trộn
+        gatherAndMergeCompressed(a, local_array, local_chunk_size, send_counts, n, ascending,
+                                 rank, size, phase_time, phase_bytes,
+                                 stats ? &stats->phase_counters[OGT_PHASE_MERGE] : NULL);
+    } else {
+        // Thu thập tất cả các phân đoạn đã sắp xếp về tiến trình gốc
+        unsigned long long trace_gather = traceNow();
+        MPI_Gatherv(local_array, local_chunk_size, MPI_INT,
+                    a, send_counts, displacements, MPI_INT, 0, getMPICommunicator());
+        
+        double t_gather = MPI_Wtime();
+        traceSpan("MPI_Gatherv", trace_gather, local_chunk_size);
+        phase_time[OGT_MPI_PHASE_GATHER] = t_gather - t_sort;
+        
+        // Tiến trình gốc trộn tất cả các phân đoạn đã sắp xếp
+        if (rank == 0) {
+            OGTCounterGroup merge_counters;
+            int merge_counting = stats && counterBegin(&merge_counters);
+            if (merge_counting) t_gather = MPI_Wtime();
+            unsigned long long trace_merge = traceNow();
+            merge_mpi_chunks(a, send_counts, size, n, ascending);
+            phase_time[OGT_MPI_PHASE_MERGE] = MPI_Wtime() - t_gather;
+            traceSpan("merge", trace_merge, n);
+            if (merge_counting) counterEnd(&merge_counters, &stats->phase_counters[OGT_PHASE_MERGE]);
+        }
+        phase_bytes[OGT_MPI_PHASE_GATHER] = (long long)local_chunk_size * sizeof(int);
+    }
+    if (rank == 0) {
+        phase_bytes[OGT_MPI_PHASE_MERGE] = (long long)n * sizeof(int);
+    }
+    
+    if (stats) {
+        stats->phase_time[OGT_PHASE_SPLIT] = t_split - t_begin;
+        stats->phase_time[OGT_PHASE_COMM] = phase_time[OGT_MPI_PHASE_SCATTER] + phase_time[OGT_MPI_PHASE_GATHER];
+        stats->phase_time[OGT_PHASE_SORT] = phase_time[OGT_MPI_PHASE_LOCAL_SORT];
+        stats->phase_time[OGT_PHASE_MERGE] = phase_time[OGT_MPI_PHASE_MERGE];
+        stats->thread_time[0][OGT_PHASE_SORT] = phase_time[OGT_MPI_PHASE_LOCAL_SORT];
+        stats->phase_counters[OGT_PHASE_SORT] = sort_counters;
+        stats->thread_counters[0] = sort_counters;
+        if (rank == 0) {
+            // Trộn cặp đôi: mỗi vòng đọc + ghi hai lần; dữ liệu nén thêm một lượt giải nén ghi n
+            int passes = 0;
+            for (int k = 1; k < size; k *= 2) passes++;
+            stats->phase_bytes[OGT_PHASE_MERGE] = 4.0 * passes * n * sizeof(int) +
+                                                  (mpi_compression ? 1.0 * n * sizeof(int) : 0.0);
+        }
+    }
+    
+    // Cờ getHardwareCounters() giống nhau trên mọi rank nên lời gọi tập thể an toàn
+    if (getHardwareCounters()) gatherMPICounters(&sort_counters, rank, size, stats);
     
-    // Tiến trình gốc trộn tất cả các phân đoạn đã sắp xếp
     if (rank == 0) {
-        merge_mpi_chunks(a, send_counts, size, n, ascending);
-        free(send_counts);
-        free(displacements);
+        ogtFree(send_counts);
+        ogtFree(displacements);
     }
     
     // Đồng bộ hóa tất cả các tiến trình trước khi kết thúc
-    MPI_Barrier(MPI_COMM_WORLD);
+    unsigned long long trace_barrier = traceNow();
+    MPI_Barrier(getMPICommunicator());
+    traceSpan("MPI_Barrier", trace_barrier, -1);
+    
+    ogtFree(local_array);
     
-    free(local_array);
+    traceSpan("mpi-sort", trace_begin, n);
+    if (stats) stats->total_time = MPI_Wtime() - t_begin;
+    if (tracking_memory) memScopeEnd(&memory_scope, &memory);
+    if (stats) stats->memory = memory;
+    if (rank_stats) reduceMPIPhaseStats(phase_time, phase_bytes, &memory, rank, size, rank_stats);
+}
+
+void parallelInsertionSortMPIStats(int a[], int n, int ascending, OGTSortStats* stats) {
+    parallelInsertionSortMPIRankStats(a, n, ascending, stats, NULL);
 }
 
 /**
@@ -253,11 +554,62 @@ void parallelInsertionSortMPI(int a[], int n, int ascending) {
  * Cung cấp hai phiên bản: sắp xếp tăng dần và giảm dần
  */
 void parallelInsertionSortMPIAsc(int a[], int n) {
-    parallelInsertionSortMPI(a, n, 1);
+    parallelInsertionSortMPIStats(a, n, 1, NULL);
 }
 
 void parallelInsertionSortMPIDesc(int a[], int n) {
-    parallelInsertionSortMPI(a, n, 0);
+    parallelInsertionSortMPIStats(a, n, 0, NULL);
+}
+
+/**
+ * Sinh mảng ngẫu nhiên song song trên mọi rank của getMPICommunicator() (hàm tập thể)
+ * Mỗi rank sinh phân đoạn của mình theo cùng cách chia với sắp xếp MPI,
+ * rank 0 nhận kết quả giống hệt generateRandomArray với cùng seed (seed của rank 0).
+ * @param a: Mảng kết quả (chỉ cần hợp lệ tại rank 0)
+ * @param n: Kích thước mảng
+ * @param max_val: Giá trị tối đa (không bao gồm)
+ */
+void generateRandomArrayMPI(int a[], int n, int max_val) {
+    MPI_Comm comm = getMPICommunicator();
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Rank 0 đặt chỗ đoạn tiếp theo của dòng ngẫu nhiên rồi báo cho các rank khác
+    long long stream_start = 0;
+    unsigned long long seed = getRandomSeed();
+    if (rank == 0) {
+        stream_start = reserveRandomStream(n);
+    }
+    MPI_Bcast(&stream_start, 1, MPI_LONG_LONG, 0, comm);
+    MPI_Bcast(&seed, 1, MPI_UNSIGNED_LONG_LONG, 0, comm);
+
+    int base_chunk_size = n / size;
+    int remainder = n % size;
+    int local_count = base_chunk_size + (rank < remainder ? 1 : 0);
+    long long local_start = (long long)rank * base_chunk_size + (rank < remainder ? rank : remainder);
+
+    int* local = (int*)malloc((local_count > 0 ? local_count : 1) * sizeof(int));
+    generateRandomRange(local, stream_start + local_start, local_count, max_val, seed);
+
+    int* recv_counts = NULL;
+    int* displacements = NULL;
+    if (rank == 0) {
+        recv_counts = (int*)malloc(size * sizeof(int));
+        displacements = (int*)malloc(size * sizeof(int));
+        int current_pos = 0;
+        for (int i = 0; i < size; i++) {
+            recv_counts[i] = base_chunk_size + (i < remainder ? 1 : 0);
+            displacements[i] = current_pos;
+            current_pos += recv_counts[i];
+        }
+    }
+
+    MPI_Gatherv(local, local_count, MPI_INT, a, recv_counts, displacements, MPI_INT, 0, comm);
+
+    free(local);
+    free(recv_counts);
+    free(displacements);
 }
 
 /**
@@ -319,8 +671,41 @@ void parallelInsertionSortMPIDesc(int a[], int n) {
     insertionSortDesc(a, n);
 }
 
+void parallelInsertionSortMPIStats(int a[], int n, int ascending, OGTSortStats* stats) {
+    printf(RED "MPI không khả dụng - chuyển sang sắp xếp tuần tự\n" RESET);
+    insertionSortStats(a, n, ascending, stats);
+}
+
+void parallelInsertionSortMPIRankStats(int a[], int n, int ascending,
+                                       OGTSortStats* stats, OGTMPIPhaseStats* rank_stats) {
+    double start_time = getCurrentTime();
+    parallelInsertionSortMPIStats(a, n, ascending, stats);
+    if (rank_stats) {
+        memset(rank_stats, 0, sizeof(*rank_stats));
+        rank_stats->num_ranks = 1;
+        rank_stats->min_time[OGT_MPI_PHASE_LOCAL_SORT] = getCurrentTime() - start_time;
+        rank_stats->avg_time[OGT_MPI_PHASE_LOCAL_SORT] = rank_stats->min_time[OGT_MPI_PHASE_LOCAL_SORT];
+        rank_stats->max_time[OGT_MPI_PHASE_LOCAL_SORT] = rank_stats->min_time[OGT_MPI_PHASE_LOCAL_SORT];
+        rank_stats->bytes[OGT_MPI_PHASE_LOCAL_SORT] = (long long)n * sizeof(int);
+        rank_stats->root_memory.peak_rss_kb = stats ? stats->memory.peak_rss_kb : peakRSSKB();
+        rank_stats->other_memory.peak_rss_kb = -1;
+    }
+}
+
 // Demonstration and benchmark stub functions moved to ogt_ui.c
 
+void generateRandomArrayMPI(int a[], int n, int max_val) {
+    generateRandomArray(a, n, max_val);
+}
+
+void setMPICompression(int enabled) {
+    (void)enabled;
+}
+
+int getMPICompression(void) {
+    return 0;
+}
+
 int initializeMPI(int argc, char* argv[]) {
     printf(RED "Khởi tạo MPI không khả dụng - MPI chưa được biên dịch\n" RESET);
     return -1;
@@ -340,4 +725,28 @@ int isMPIInitialized(void) {
     return 0;
 }
 
-#endif // HAVE_MPI 
\ No newline at end of file
+#endif // HAVE_MPI
+
+// ========== PHÂN TÍCH THỐNG KÊ THEO RANK ==========
+
+const char* mpiPhaseName(OGTMPIPhase phase) {
+    static const char* names[OGT_MPI_PHASE_COUNT] = {
+        "scatter", "local-sort", "gather", "root-merge"
+    };
+    if (phase < 0 || phase >= OGT_MPI_PHASE_COUNT) return "?";
+    return names[phase];
+}
+
+// Tỉ lệ mất cân bằng tải: thời gian sort cục bộ của rank chậm nhất / trung bình
+double mpiLoadImbalance(const OGTMPIPhaseStats* rank_stats) {
+    double avg = rank_stats->avg_time[OGT_MPI_PHASE_LOCAL_SORT];
+    return avg > 0.0 ? rank_stats->max_time[OGT_MPI_PHASE_LOCAL_SORT] / avg : 1.0;
+}
+
+// Tỉ lệ giao tiếp / tính toán, dùng thời gian trung bình giữa các rank
+// (pha trộn chỉ chạy ở rank 0 nên lấy giá trị lớn nhất)
+double mpiCommCompRatio(const OGTMPIPhaseStats* rank_stats) {
+    double comm = rank_stats->avg_time[OGT_MPI_PHASE_SCATTER] + rank_stats->avg_time[OGT_MPI_PHASE_GATHER];
+    double comp = rank_stats->avg_time[OGT_MPI_PHASE_LOCAL_SORT] + rank_stats->max_time[OGT_MPI_PHASE_MERGE];
+    return comp > 0.0 ? comm / comp : 0.0;
+}
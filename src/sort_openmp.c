@@ -4,146 +4,312 @@
 #include <string.h>
 #include <limits.h>
 
-// Sắp xếp chèn song song - thứ tự tăng dần (phương pháp chia khối thủ công)
-void parallelInsertionSortAsc(int a[], int n, int num_threads) {
-    omp_set_num_threads(num_threads); // set số thread
-    
-    if (n <= 1) return; // nếu n <= 1 thì return
-    
-    // dùng tuần tự cho kích thước bé
-    if (n < 1000) {
-        insertionSortAsc(a, n);
-        return;
+/**
+ * Trộn k-chiều các khối đã sắp xếp vào result
+ * @param chunks: Các khối đã sắp xếp
+ * @param chunk_sizes: Kích thước từng khối
+ * @param num_chunks: Số khối
+ * @param result: Mảng kết quả (n phần tử)
+ * @param n: Tổng số phần tử
+ * @param ascending: 1 nếu tăng dần, 0 nếu giảm dần
+ */
+void merge_openmp_chunks(int* chunks[], const int chunk_sizes[], int num_chunks, int result[], int n, int ascending) {
+    int *indices = ogtCalloc(num_chunks, sizeof(int));
+
+    for (int i = 0; i < n; i++) {
+        int best_val = ascending ? INT_MAX : INT_MIN;
+        int best_thread = -1;
+
+        // tìm phần tử nhỏ nhất (lớn nhất khi giảm dần) trong tất cả chunks
+        for (int t = 0; t < num_chunks; t++) {
+            if (indices[t] >= chunk_sizes[t]) continue;
+            int v = chunks[t][indices[t]];
+            if (best_thread < 0 || (ascending ? v < best_val : v > best_val)) {
+                best_val = v;
+                best_thread = t;
+            }
+        }
+
+        result[i] = best_val;
+        indices[best_thread]++;
     }
-    
-    // Cấp phát bộ nhớ trước để tránh overhead trong vùng song song
-    int chunk_size = n / num_threads;
-    int **temp_arrays = malloc(num_threads * sizeof(int*));
-    int *chunk_sizes = malloc(num_threads * sizeof(int));
-    
-    // Cấp phát trước tất cả temp arrays trước vùng song song
-    for (int t = 0; t < num_threads; t++) {
-        int start = t * chunk_size;
-        int end = (t == num_threads - 1) ? n : start + chunk_size;
-        chunk_sizes[t] = end - start;
-        temp_arrays[t] = malloc(chunk_sizes[t] * sizeof(int));
+
+    ogtFree(indices);
+}
+
+// Trộn hai dãy đã sắp xếp vào out
+static void mergeRunPair(const int* left, int left_n, const int* right, int right_n, int out[], int ascending) {
+    int i = 0, j = 0, k = 0;
+    while (i < left_n && j < right_n) {
+        if (ascending ? left[i] <= right[j] : left[i] >= right[j]) {
+            out[k++] = left[i++];
+        } else {
+            out[k++] = right[j++];
+        }
     }
-    
-    // Vùng song song đơn - hiệu quả hơn parallel for
-    #pragma omp parallel
-    {
-        int tid = omp_get_thread_num(); // lấy id của thread hiện tại
-        int start = tid * chunk_size;
-        int local_size = chunk_sizes[tid]; // size mỗi thread
-        
-        // copy phần tử của mỗi thread vào temp_arrays
-        memcpy(temp_arrays[tid], &a[start], local_size * sizeof(int));
-        
-        // sort mỗi thread
-        insertionSortAsc(temp_arrays[tid], local_size);
+    while (i < left_n) out[k++] = left[i++];
+    while (j < right_n) out[k++] = right[j++];
+}
+
+/**
+ * Trộn các khối đã sắp xếp theo cây cặp đôi: ceil(log2 k) lượt, mỗi lượt đọc/ghi n phần tử
+ * Các lượt luân phiên giữa result và một vùng tạm, sắp sao cho lượt cuối ghi vào result.
+ */
+void merge_tree_chunks(int* chunks[], const int chunk_sizes[], int num_chunks, int result[], int n, int ascending) {
+    if (num_chunks == 1) {
+        memcpy(result, chunks[0], (size_t)n * sizeof(int));
+        return;
     }
-    
-    // trộn k-chiều của các khối đã sắp xếp
-    int *result = malloc(n * sizeof(int));
-    int *indices = calloc(num_threads, sizeof(int));
-    
-    for (int i = 0; i < n; i++) {
-        int min_val = INT_MAX;
-        int min_thread = -1;
-        
-        // tìm phần tử nhỏ nhất trong tất cả chunks
-        for (int t = 0; t < num_threads; t++) {
-            if (indices[t] < chunk_sizes[t] && temp_arrays[t][indices[t]] < min_val) {
-                min_val = temp_arrays[t][indices[t]];
-                min_thread = t;
+
+    int passes = 0;
+    for (int k = 1; k < num_chunks; k *= 2) passes++;
+    int* scratch = ogtMalloc((size_t)n * sizeof(int));
+    int** runs = ogtMalloc(num_chunks * sizeof(int*));
+    int* sizes = ogtMalloc(num_chunks * sizeof(int));
+    memcpy(runs, chunks, num_chunks * sizeof(int*));
+    memcpy(sizes, chunk_sizes, num_chunks * sizeof(int));
+
+    // Số lượt lẻ: lượt đầu ghi vào result; chẵn: vào scratch
+    int* target = passes % 2 ? result : scratch;
+    int count = num_chunks;
+    while (count > 1) {
+        int next = 0;
+        int offset = 0;
+        for (int i = 0; i < count; i += 2) {
+            int merged = sizes[i] + (i + 1 < count ? sizes[i + 1] : 0);
+            if (i + 1 < count) {
+                mergeRunPair(runs[i], sizes[i], runs[i + 1], sizes[i + 1], target + offset, ascending);
+            } else {
+                memcpy(target + offset, runs[i], (size_t)sizes[i] * sizeof(int));
             }
+            runs[next] = target + offset;
+            sizes[next] = merged;
+            next++;
+            offset += merged;
         }
-        
-        result[i] = min_val;
-        indices[min_thread]++;
+        count = next;
+        target = target == result ? scratch : result;
     }
-    
-    // copy result vào a
-    memcpy(a, result, n * sizeof(int));
-    
-    // giải phóng bộ nhớ
-    for (int t = 0; t < num_threads; t++) {
-        free(temp_arrays[t]);
+
+    ogtFree(scratch);
+    ogtFree(runs);
+    ogtFree(sizes);
+}
+
+/**
+ * Trộn cây các run liền kề của arr: run r là arr[bounds[r], bounds[r + 1]), bounds[num_runs] = n
+ * Các lượt luân phiên giữa arr và scratch (cùng vị trí), không cấp phát; bounds bị ghi đè
+ */
+void merge_adjacent_runs(int arr[], int scratch[], int bounds[], int num_runs, int n, int ascending) {
+    int* src = arr;
+    int* dst = scratch;
+    int count = num_runs;
+
+    while (count > 1) {
+        int next = 0;
+        for (int r = 0; r < count; r += 2) {
+            if (r + 1 < count) {
+                int left = bounds[r], mid = bounds[r + 1], right = bounds[r + 2];
+                mergeRunPair(src + left, mid - left, src + mid, right - mid, dst + left, ascending);
+            } else {
+                memcpy(dst + bounds[r], src + bounds[r], (size_t)(bounds[r + 1] - bounds[r]) * sizeof(int));
+            }
+            bounds[next++] = bounds[r];
+        }
+        bounds[next] = n;
+        count = next;
+        int* swap = src;
+        src = dst;
+        dst = swap;
     }
-    free(temp_arrays);
-    free(chunk_sizes);
-    free(result);
-    free(indices);
+    if (src != arr) memcpy(arr, src, (size_t)n * sizeof(int));
 }
 
-// Sắp xếp chèn song song - thứ tự giảm dần
-void parallelInsertionSortDesc(int a[], int n, int num_threads) {
-    omp_set_num_threads(num_threads);
-    
-    if (n <= 1) return;
-    
-    // dùng tuần tự cho kích thước bé
-    if (n < 1000) {
-        insertionSortDesc(a, n);
+/**
+ * Sắp xếp chèn song song bằng OpenMP (phương pháp chia khối thủ công)
+ * Ghi thời gian từng pha vào stats nếu stats != NULL.
+ * Pha chạy song song (copy, sort) được tính theo luồng chậm nhất.
+ * Số khối theo num_threads, số luồng thực chạy do governor cấp (tối đa num_threads).
+ * @param scratch: NULL hoặc vùng tạm 2 * n phần tử của người gọi (không cấp phát khối tạm)
+ */
+void parallelInsertionSortScratch(int a[], int n, int num_threads, int ascending, int scratch[],
+                                  OGTSortStats* stats) {
+    if (stats) {
+        resetSortStats(stats);
+        stats->num_threads = num_threads;
+    }
+    if (n <= 1) return; // nếu n <= 1 thì return
+
+    OGTMemScope memory;
+    if (stats) memScopeBegin(&memory);
+    unsigned long long trace_begin = traceNow();
+    double t_begin = getCurrentTime();
+
+    // dùng tuần tự cho kích thước bé (ngưỡng theo hồ sơ tinh chỉnh)
+    const OGTTuning* tuning = ogtTuning();
+    if (n < tuning->seq_cutoff) {
+        if (ascending) {
+            insertionSortAsc(a, n);
+        } else {
+            insertionSortDesc(a, n);
+        }
+        if (stats) {
+            stats->num_threads = 1;
+            stats->phase_time[OGT_PHASE_SORT] = getCurrentTime() - t_begin;
+            stats->total_time = stats->phase_time[OGT_PHASE_SORT];
+            memScopeEnd(&memory, &stats->memory);
+        }
         return;
     }
-    
-    // Phương pháp chia khối thủ công (hiệu quả hơn parallel for)
-    int chunk_size = n / num_threads;
-    int **temp_arrays = malloc(num_threads * sizeof(int*));
-    int *chunk_sizes = malloc(num_threads * sizeof(int));
-    
-    // Cấp phát bộ nhớ trước
-    for (int t = 0; t < num_threads; t++) {
-        int start = t * chunk_size;
-        int end = (t == num_threads - 1) ? n : start + chunk_size;
-        chunk_sizes[t] = end - start;
-        temp_arrays[t] = malloc(chunk_sizes[t] * sizeof(int));
+
+    // Cấp phát bộ nhớ trước để tránh overhead trong vùng song song
+    // Mặc định một khối mỗi luồng; hồ sơ có thể chia nhỏ hơn (chunks_per_thread, block_size)
+    int num_chunks = tuningChunkCount(n, num_threads);
+    int chunk_size = n / num_chunks;
+    int **temp_arrays = ogtMalloc(num_chunks * sizeof(int*));
+    int *chunk_sizes = ogtMalloc(num_chunks * sizeof(int));
+
+    // Cấp phát trước tất cả temp arrays trước vùng song song (hoặc chia vùng tạm của người gọi)
+    for (int c = 0; c < num_chunks; c++) {
+        int start = c * chunk_size;
+        int end = (c == num_chunks - 1) ? n : start + chunk_size;
+        chunk_sizes[c] = end - start;
+        temp_arrays[c] = scratch ? scratch + start : ogtMalloc(chunk_sizes[c] * sizeof(int));
     }
-    
-    // Vùng song song đơn
-    #pragma omp parallel
+
+    double t_split = getCurrentTime();
+
+    // Vùng song song đơn - hiệu quả hơn parallel for
+    // num_threads chỉ áp dụng cho vùng này, không đổi số luồng mặc định của cả chương trình
+    int team = governorAcquire(num_threads);
+    #pragma omp parallel num_threads(team)
     {
-        int tid = omp_get_thread_num();
-        int start = tid * chunk_size;
-        int local_size = chunk_sizes[tid];
-        
-        // copy phần tử của chunk này vào temp_arrays
-        memcpy(temp_arrays[tid], &a[start], local_size * sizeof(int));
-        
-        // sort chunk này
-        insertionSortDesc(temp_arrays[tid], local_size);
-    }
-    
-    // trộn k-chiều của các khối đã sắp xếp (giảm dần)
-    int *result = malloc(n * sizeof(int));
-    int *indices = calloc(num_threads, sizeof(int));
-    
-    for (int i = 0; i < n; i++) {
-        int max_val = INT_MIN;
-        int max_thread = -1;
-        
-        // tìm phần tử lớn nhất trong tất cả chunks
-        for (int t = 0; t < num_threads; t++) {
-            if (indices[t] < chunk_sizes[t] && temp_arrays[t][indices[t]] > max_val) {
-                max_val = temp_arrays[t][indices[t]];
-                max_thread = t;
+        int tid = omp_get_thread_num(); // lấy id của thread hiện tại
+        double copy_time = 0.0, sort_time = 0.0;
+
+        // bộ đếm phần cứng của luồng này cho pha sort (mở ngoài vùng đo thời gian)
+        OGTCounterGroup counters;
+        int counting = stats && tid < OGT_STATS_MAX_THREADS && counterBegin(&counters);
+
+        // khối c thuộc luồng c % số luồng, như một khối mỗi luồng khi không chia nhỏ
+        #pragma omp for schedule(static, 1)
+        for (int c = 0; c < num_chunks; c++) {
+            int start = c * chunk_size;
+            int local_size = chunk_sizes[c];
+
+            unsigned long long trace_copy = traceNow();
+            double t0 = getCurrentTime();
+
+            // copy phần tử của khối vào temp_arrays
+            memcpy(temp_arrays[c], &a[start], local_size * sizeof(int));
+
+            double t_copied = getCurrentTime();
+            traceSpan("copy", trace_copy, local_size);
+
+            unsigned long long trace_sort = traceNow();
+            double t1 = getCurrentTime();
+
+            if (ascending) {
+                insertionSortAsc(temp_arrays[c], local_size);
+            } else {
+                insertionSortDesc(temp_arrays[c], local_size);
             }
+
+            double t2 = getCurrentTime();
+            traceSpan("chunk-sort", trace_sort, local_size);
+            copy_time += t_copied - t0;
+            sort_time += t2 - t1;
+        }
+
+        if (counting) counterEnd(&counters, &stats->thread_counters[tid]);
+
+        if (stats && tid < OGT_STATS_MAX_THREADS) {
+            stats->thread_time[tid][OGT_PHASE_COPY] = copy_time;
+            stats->thread_time[tid][OGT_PHASE_SORT] = sort_time;
         }
-        
-        result[i] = max_val;
-        indices[max_thread]++;
     }
-    
+
+    governorRelease(team);
+    double t_sort = getCurrentTime();
+
+    OGTCounterGroup merge_counters;
+    int counting = stats && counterBegin(&merge_counters);
+    double t_merge_begin = counting ? getCurrentTime() : t_sort;
+
+    // trộn k-chiều của các khối đã sắp xếp
+    unsigned long long trace_merge = traceNow();
+    int *result = scratch ? scratch + n : ogtMalloc(n * sizeof(int));
+    if (tuning->merge == OGT_MERGE_TREE) {
+        merge_tree_chunks(temp_arrays, chunk_sizes, num_chunks, result, n, ascending);
+    } else {
+        merge_openmp_chunks(temp_arrays, chunk_sizes, num_chunks, result, n, ascending);
+    }
+
+    double t_merge = getCurrentTime();
+    traceSpan("merge", trace_merge, n);
+    if (counting) counterEnd(&merge_counters, &stats->phase_counters[OGT_PHASE_MERGE]);
+
     // copy result vào a
+    unsigned long long trace_copy_back = traceNow();
     memcpy(a, result, n * sizeof(int));
-    
+
+    double t_copy_back = getCurrentTime();
+    traceSpan("copy-back", trace_copy_back, n);
+
     // giải phóng bộ nhớ
-    for (int t = 0; t < num_threads; t++) {
-        free(temp_arrays[t]);
+    if (!scratch) {
+        for (int c = 0; c < num_chunks; c++) {
+            ogtFree(temp_arrays[c]);
+        }
+        ogtFree(result);
+    }
+    ogtFree(temp_arrays);
+    ogtFree(chunk_sizes);
+    traceSpan("openmp-sort", trace_begin, n);
+
+    if (stats) {
+        // copy và sort nằm chung vùng song song: tách theo luồng có copy lâu nhất
+        double max_copy = 0.0;
+        stats->num_threads = team;
+        int recorded = team < OGT_STATS_MAX_THREADS ? team : OGT_STATS_MAX_THREADS;
+        for (int t = 0; t < recorded; t++) {
+            if (stats->thread_time[t][OGT_PHASE_COPY] > max_copy) {
+                max_copy = stats->thread_time[t][OGT_PHASE_COPY];
+            }
+        }
+        stats->phase_time[OGT_PHASE_SPLIT] = t_split - t_begin;
+        stats->phase_time[OGT_PHASE_COPY] = max_copy;
+        stats->phase_time[OGT_PHASE_SORT] = (t_sort - t_split) - max_copy;
+        stats->phase_time[OGT_PHASE_MERGE] = t_merge - t_merge_begin;
+        for (int t = 0; t < recorded; t++) {
+            addCounterValues(&stats->phase_counters[OGT_PHASE_SORT], &stats->thread_counters[t]);
+        }
+        stats->phase_time[OGT_PHASE_COPY_BACK] = t_copy_back - t_merge;
+        // copy, trộn k-chiều và copy-back đều đọc n rồi ghi n phần tử; trộn cây lặp lại mỗi lượt
+        int merge_passes = 1;
+        if (tuning->merge == OGT_MERGE_TREE) {
+            merge_passes = 0;
+            for (int k = 1; k < num_chunks; k *= 2) merge_passes++;
+            if (merge_passes == 0) merge_passes = 1;
+        }
+        stats->phase_bytes[OGT_PHASE_COPY] = 2.0 * n * sizeof(int);
+        stats->phase_bytes[OGT_PHASE_MERGE] = 2.0 * merge_passes * n * sizeof(int);
+        stats->phase_bytes[OGT_PHASE_COPY_BACK] = 2.0 * n * sizeof(int);
+        stats->total_time = getCurrentTime() - t_begin;
+        memScopeEnd(&memory, &stats->memory);
     }
-    free(temp_arrays);
-    free(chunk_sizes);
-    free(result);
-    free(indices);
-} 
\ No newline at end of file
+}
+
+void parallelInsertionSortStats(int a[], int n, int num_threads, int ascending, OGTSortStats* stats) {
+    parallelInsertionSortScratch(a, n, num_threads, ascending, NULL, stats);
+}
+
+// Sắp xếp chèn song song - thứ tự tăng dần
+void parallelInsertionSortAsc(int a[], int n, int num_threads) {
+    parallelInsertionSortStats(a, n, num_threads, 1, NULL);
+}
+
+// Sắp xếp chèn song song - thứ tự giảm dần
+void parallelInsertionSortDesc(int a[], int n, int num_threads) {
+    parallelInsertionSortStats(a, n, num_threads, 0, NULL);
+}
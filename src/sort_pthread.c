@@ -3,15 +3,6 @@
 #include <string.h>
 #include <sys/time.h>
 
-// Struct chứa dữ liệu để truyền cho hàm thread
-typedef struct {
-    int* array;
-    int start;
-    int end;
-    int thread_id;
-    int ascending;
-} ThreadData;
-
 // Struct chứa thông tin về các phần tử của mảng
 typedef struct {
     int start;
@@ -19,19 +10,41 @@ typedef struct {
     int size;
 } ChunkInfo;
 
+// Struct chứa dữ liệu để truyền cho hàm thread
+typedef struct {
+    int* array;
+    const ChunkInfo* chunks; // các khối của luồng: chunks[thread_id], chunks[thread_id + stride], ...
+    int num_chunks;
+    int stride;
+    int thread_id;
+    int ascending;
+    double sort_time;   // thời gian sắp xếp chunk của luồng này
+    int count_hw;       // đo bộ đếm phần cứng cho pha sort
+    OGTCounterValues counters;
+} ThreadData;
+
 /**
- * Hàm thread để sắp xếp một chunk của mảng
+ * Hàm thread để sắp xếp các chunk của luồng (xoay vòng theo stride)
  */
 void* pthread_sort_chunk(void* arg) {
     ThreadData* data = (ThreadData*)arg;
-    int chunk_size = data->end - data->start + 1;
+    OGTCounterGroup counters;
+    int counting = data->count_hw && counterBegin(&counters);
+    double start_time = getCurrentTime();
     
-    if (data->ascending) {
-        insertionSortAsc(&data->array[data->start], chunk_size);
-    } else {
-        insertionSortDesc(&data->array[data->start], chunk_size);
+    for (int c = data->thread_id; c < data->num_chunks; c += data->stride) {
+        const ChunkInfo* chunk = &data->chunks[c];
+        unsigned long long trace_start = traceNow();
+        if (data->ascending) {
+            insertionSortAsc(&data->array[chunk->start], chunk->size);
+        } else {
+            insertionSortDesc(&data->array[chunk->start], chunk->size);
+        }
+        traceSpan("chunk-sort", trace_start, chunk->size);
     }
     
+    data->sort_time = getCurrentTime() - start_time;
+    if (counting) counterEnd(&counters, &data->counters);
     return NULL;
 }
 
@@ -44,8 +57,8 @@ void merge_two_arrays(int arr[], int left, int mid, int right, int ascending) {
     int n2 = right - mid;
     
     // Tạo mảng tạm thời
-    int* left_arr = (int*)malloc(n1 * sizeof(int));
-    int* right_arr = (int*)malloc(n2 * sizeof(int));
+    int* left_arr = (int*)ogtMalloc(n1 * sizeof(int));
+    int* right_arr = (int*)ogtMalloc(n2 * sizeof(int));
     
     // Sao chép dữ liệu vào mảng tạm thời
     for (i = 0; i < n1; i++)
@@ -91,8 +104,8 @@ void merge_two_arrays(int arr[], int left, int mid, int right, int ascending) {
         j++; k++;
     }
     
-    free(left_arr);
-    free(right_arr);
+    ogtFree(left_arr);
+    ogtFree(right_arr);
 }
 
 /**
@@ -131,40 +144,61 @@ void merge_sorted_chunks_pthread(int arr[], ChunkInfo chunks[], int num_threads,
 
 /**
  * Hàm triển khai pthread cốt lõi
+ * Ghi thời gian từng pha vào stats nếu stats != NULL
  */
-void parallelInsertionSortPthreads(int a[], int n, int num_threads, int ascending) {
+void parallelInsertionSortPthreadsStats(int a[], int n, int num_threads, int ascending, OGTSortStats* stats) {
+    if (stats) resetSortStats(stats);
     if (n <= 1) return;
     
-    // Giới hạn số luồng
+    OGTMemScope memory;
+    if (stats) memScopeBegin(&memory);
+    unsigned long long trace_begin = traceNow();
+    double t_begin = getCurrentTime();
+    
+    // Giới hạn số luồng (giới hạn thực tế lấy từ hồ sơ tinh chỉnh)
+    const OGTTuning* tuning = ogtTuning();
     if (num_threads > n) num_threads = n;
-    if (num_threads > 32) num_threads = 32; // Practical limit
+    if (num_threads > tuning->max_threads) num_threads = tuning->max_threads;
     
-    // Tính chunksize
-    int chunk_size = n / num_threads;
-    int remainder = n % num_threads;
+    // Tính chunksize; mặc định một khối mỗi luồng
+    int num_chunks = tuningChunkCount(n, num_threads);
+
+    // Số khối theo num_threads; số luồng tạo do governor cấp, các khối chia xoay vòng cho chúng
+    num_threads = governorAcquire(num_threads);
+    int chunk_size = n / num_chunks;
+    int remainder = n % num_chunks;
     
     // Tạo mảng thread và chunk info
-    pthread_t* threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
-    ThreadData* thread_data = (ThreadData*)malloc(num_threads * sizeof(ThreadData));
-    ChunkInfo* chunks = (ChunkInfo*)malloc(num_threads * sizeof(ChunkInfo));
+    pthread_t* threads = (pthread_t*)ogtMalloc(num_threads * sizeof(pthread_t));
+    ThreadData* thread_data = (ThreadData*)ogtMalloc(num_threads * sizeof(ThreadData));
+    ChunkInfo* chunks = (ChunkInfo*)ogtMalloc(num_chunks * sizeof(ChunkInfo));
     
     int current_pos = 0;
     
-    // Setup dữ liệu thread và chunk
+    // Setup chunk info
+    for (int c = 0; c < num_chunks; c++) {
+        chunks[c].start = current_pos;
+        chunks[c].size = chunk_size + (c < remainder ? 1 : 0);
+        chunks[c].end = chunks[c].start + chunks[c].size - 1;
+        current_pos += chunks[c].size;
+    }
+    
+    // Setup dữ liệu thread
     for (int i = 0; i < num_threads; i++) {
-        chunks[i].start = current_pos;
-        chunks[i].size = chunk_size + (i < remainder ? 1 : 0);
-        chunks[i].end = chunks[i].start + chunks[i].size - 1;
-        
         thread_data[i].array = a;
-        thread_data[i].start = chunks[i].start;
-        thread_data[i].end = chunks[i].end;
+        thread_data[i].chunks = chunks;
+        thread_data[i].num_chunks = num_chunks;
+        thread_data[i].stride = num_threads;
         thread_data[i].thread_id = i;
         thread_data[i].ascending = ascending;
-        
-        current_pos += chunks[i].size;
+        thread_data[i].sort_time = 0.0;
+        thread_data[i].count_hw = stats != NULL && i < OGT_STATS_MAX_THREADS;
+        memset(&thread_data[i].counters, 0, sizeof(thread_data[i].counters));
     }
     
+    double t_split = getCurrentTime();
+    unsigned long long trace_spawn = traceNow();
+    
     // Tạo và run threads
     for (int i = 0; i < num_threads; i++) {
         int result = pthread_create(&threads[i], NULL, pthread_sort_chunk, &thread_data[i]);
@@ -173,6 +207,8 @@ void parallelInsertionSortPthreads(int a[], int n, int num_threads, int ascendin
             exit(1);
         }
     }
+    traceSpan("spawn", trace_spawn, num_threads);
+    unsigned long long trace_join = traceNow();
     
     // Chờ các luồng hoàn thành
     for (int i = 0; i < num_threads; i++) {
@@ -183,22 +219,78 @@ void parallelInsertionSortPthreads(int a[], int n, int num_threads, int ascendin
         }
     }
     
+    governorRelease(num_threads);
+    double t_sort = getCurrentTime();
+    traceSpan("join", trace_join, num_threads);
+    
+    OGTCounterGroup merge_counters;
+    int counting = stats && counterBegin(&merge_counters);
+    double t_merge_begin = counting ? getCurrentTime() : t_sort;
+    
     // Merge các chunks đã sắp xếp
-    merge_sorted_chunks_pthread(a, chunks, num_threads, n, ascending);
+    unsigned long long trace_merge = traceNow();
+    if (tuning->merge == OGT_MERGE_LINEAR && num_chunks > 1) {
+        // trộn k-chiều tuyến tính vào vùng tạm rồi copy lại
+        int** runs = ogtMalloc(num_chunks * sizeof(int*));
+        int* sizes = ogtMalloc(num_chunks * sizeof(int));
+        int* merged = ogtMalloc((size_t)n * sizeof(int));
+        for (int c = 0; c < num_chunks; c++) {
+            runs[c] = &a[chunks[c].start];
+            sizes[c] = chunks[c].size;
+        }
+        merge_openmp_chunks(runs, sizes, num_chunks, merged, n, ascending);
+        memcpy(a, merged, (size_t)n * sizeof(int));
+        ogtFree(runs);
+        ogtFree(sizes);
+        ogtFree(merged);
+    } else {
+        merge_sorted_chunks_pthread(a, chunks, num_chunks, n, ascending);
+    }
+    
+    double t_merge = getCurrentTime();
+    traceSpan("merge", trace_merge, n);
+    if (counting) counterEnd(&merge_counters, &stats->phase_counters[OGT_PHASE_MERGE]);
+    
+    if (stats) {
+        stats->num_threads = num_threads;
+        stats->phase_time[OGT_PHASE_SPLIT] = t_split - t_begin;
+        stats->phase_time[OGT_PHASE_SORT] = t_sort - t_split;
+        stats->phase_time[OGT_PHASE_MERGE] = t_merge - t_merge_begin;
+        // mỗi vòng trộn cặp đôi copy ra mảng tạm rồi ghi lại: đọc + ghi hai lần
+        // (trộn tuyến tính: một lượt vào vùng tạm cộng copy lại)
+        int passes = 0;
+        if (tuning->merge == OGT_MERGE_LINEAR) {
+            passes = num_chunks > 1 ? 1 : 0;
+        } else {
+            for (int k = 1; k < num_chunks; k *= 2) passes++;
+        }
+        stats->phase_bytes[OGT_PHASE_MERGE] = 4.0 * passes * n * sizeof(int);
+        for (int i = 0; i < num_threads && i < OGT_STATS_MAX_THREADS; i++) {
+            stats->thread_time[i][OGT_PHASE_SORT] = thread_data[i].sort_time;
+            stats->thread_counters[i] = thread_data[i].counters;
+            addCounterValues(&stats->phase_counters[OGT_PHASE_SORT], &thread_data[i].counters);
+        }
+    }
     
     // Dọn dẹp
-    free(threads);
-    free(thread_data);
-    free(chunks);
+    ogtFree(threads);
+    ogtFree(thread_data);
+    ogtFree(chunks);
+    
+    traceSpan("pthreads-sort", trace_begin, n);
+    if (stats) {
+        stats->total_time = getCurrentTime() - t_begin;
+        memScopeEnd(&memory, &stats->memory);
+    }
 }
 
 /**
  * Public API cho sắp xếp song song bằng Pthreads
  */
 void parallelInsertionSortPthreadsAsc(int a[], int n, int num_threads) {
-    parallelInsertionSortPthreads(a, n, num_threads, 1);
+    parallelInsertionSortPthreadsStats(a, n, num_threads, 1, NULL);
 }
 
 void parallelInsertionSortPthreadsDesc(int a[], int n, int num_threads) {
-    parallelInsertionSortPthreads(a, n, num_threads, 0);
+    parallelInsertionSortPthreadsStats(a, n, num_threads, 0, NULL);
 }
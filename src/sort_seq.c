@@ -1,4 +1,5 @@
 #include "sort_ogt.h"
+#include <string.h>
 
 // Sắp xếp chèn tuần tự - thứ tự tăng dần
 void insertionSortAsc(int a[], int n) {
@@ -26,4 +27,38 @@ void insertionSortDesc(int a[], int n) {
         }
         a[j + 1] = key;
     }
-} 
\ No newline at end of file
+}
+
+// Sắp xếp tuần tự có ghi thời gian (chỉ có pha sort)
+void insertionSortStats(int a[], int n, int ascending, OGTSortStats* stats) {
+    OGTCounterGroup counters;
+    OGTCounterValues values;
+    memset(&values, 0, sizeof(values));
+    int counting = stats && counterBegin(&counters);
+    OGTMemScope memory;
+    if (stats) memScopeBegin(&memory);
+
+    unsigned long long trace_start = traceNow();
+    double start = getCurrentTime();
+
+    if (ascending) {
+        insertionSortAsc(a, n);
+    } else {
+        insertionSortDesc(a, n);
+    }
+
+    double end = getCurrentTime();
+    traceSpan("insertion-sort", trace_start, n);
+    if (counting) counterEnd(&counters, &values);
+
+    if (stats) {
+        resetSortStats(stats);
+        stats->num_threads = 1;
+        stats->phase_time[OGT_PHASE_SORT] = end - start;
+        stats->thread_time[0][OGT_PHASE_SORT] = stats->phase_time[OGT_PHASE_SORT];
+        stats->phase_counters[OGT_PHASE_SORT] = values;
+        stats->thread_counters[0] = values;
+        stats->total_time = stats->phase_time[OGT_PHASE_SORT];
+        memScopeEnd(&memory, &stats->memory);
+    }
+}
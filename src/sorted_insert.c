@@ -0,0 +1,99 @@
+#include "sort_ogt.h"
+#include <string.h>
+
+/**
+ * Chèn lô khóa mới vào mảng đã sắp xếp có chỗ trống phía sau
+ *
+ * Lô được sắp xếp riêng (ogt_sort) rồi trộn vào phần đuôi của mảng bắt đầu từ vị trí chèn
+ * của khóa đầu lô; phần đứng trước không bị đọc lại. Lô nhỏ trộn tại chỗ từ cuối lên: mỗi khóa
+ * tìm nhị phân vị trí rồi dời cả khối phần tử cũ sau nó một lần, nên số phép so sánh là
+ * O(m log n) và lượng dữ liệu dời bằng phần đuôi. Lô lớn trộn song song (mergeSortedArrays)
+ * qua vùng tạm cỡ phần đuôi rồi chép về.
+ *
+ * Khóa mới bằng khóa cũ đứng sau khóa cũ, nên thứ tự các lần chèn được giữ.
+ */
+
+// Trộn tại chỗ từ cuối lên: arr[0..n) + batch[0..m) -> arr[0..n + m)
+static void mergeBackward(int arr[], int n, const int batch[], int m, int ascending) {
+    int end = n + m;
+    int hi = n;
+    for (int j = m - 1; j >= 0; j--) {
+        int v = batch[j];
+        int pos = sortedCountUpTo(arr, hi, v, ascending);
+        int moved = hi - pos;
+        end -= moved;
+        memmove(arr + end, arr + pos, (size_t)moved * sizeof(int));
+        arr[--end] = v;
+        hi = pos;
+    }
+}
+
+int sortedInsertBatch(int arr[], int n, int batch[], int m, int num_threads, int ascending,
+                      OGTSortStats* stats) {
+    if (stats) resetSortStats(stats);
+    if (n < 0 || m < 0 || (long long)n + m > 0x7FFFFFFF) {
+        printf(RED "Lỗi: Kích thước không hợp lệ (n = %d, lô = %d)\n" RESET, n, m);
+        return -1;
+    }
+    if (m == 0) return n;
+
+    OGTMemScope memory;
+    if (stats) memScopeBegin(&memory);
+    unsigned long long trace_begin = traceNow();
+    double t_begin = getCurrentTime();
+
+    // Lô nằm trong vùng kết quả (thường là ghi sẵn vào đuôi): chép ra trước khi bị ghi đè
+    int* keys = batch;
+    if (batch < arr + n + m && batch + m > arr) {
+        keys = (int*)ogtMalloc((size_t)m * sizeof(int));
+        if (!keys) {
+            printf(RED "Lỗi: Không đủ bộ nhớ cho lô %d phần tử\n" RESET, m);
+            if (stats) memScopeEnd(&memory, &stats->memory);
+            return -1;
+        }
+        memcpy(keys, batch, (size_t)m * sizeof(int));
+    }
+
+    OGTSortOptions opts;
+    ogt_sort_default_options(&opts);
+    opts.ascending = ascending;
+    opts.max_threads = num_threads > 0 ? num_threads : 0;
+    int status = ogt_sort(keys, m, &opts);
+    double t_sorted = getCurrentTime();
+
+    // Phần đứng trước khóa đầu lô giữ nguyên
+    int first = status == 0 ? sortedCountUpTo(arr, n, keys[0], ascending) : n;
+    int tail = n - first;
+    int threads = 1;
+    if (status == 0 && num_threads != 1 && m >= ogtTuning()->seq_cutoff) {
+        int* scratch = (int*)ogtMalloc(((size_t)tail + m) * sizeof(int));
+        if (scratch) {
+            int* inputs[2] = { arr + first, keys };
+            int lengths[2] = { tail, m };
+            OGTSortStats merge_stats;
+            status = mergeSortedArrays(inputs, lengths, 2, scratch, NULL, num_threads, ascending, &merge_stats);
+            if (status == 0) memcpy(arr + first, scratch, ((size_t)tail + m) * sizeof(int));
+            threads = merge_stats.num_threads;
+            ogtFree(scratch);
+        } else {
+            // Thiếu bộ nhớ tạm: trộn tại chỗ vẫn đúng, chỉ chậm hơn
+            mergeBackward(arr + first, tail, keys, m, ascending);
+        }
+    } else if (status == 0) {
+        mergeBackward(arr + first, tail, keys, m, ascending);
+    }
+
+    double t_end = getCurrentTime();
+    traceSpan("batch-insert", trace_begin, m);
+    if (keys != batch) ogtFree(keys);
+
+    if (stats) {
+        stats->num_threads = threads;
+        stats->phase_time[OGT_PHASE_SORT] = t_sorted - t_begin;
+        stats->phase_time[OGT_PHASE_MERGE] = t_end - t_sorted;
+        stats->phase_bytes[OGT_PHASE_MERGE] = 2.0 * ((double)tail + m) * sizeof(int);
+        stats->total_time = t_end - t_begin;
+        memScopeEnd(&memory, &stats->memory);
+    }
+    return status == 0 ? n + m : -1;
+}
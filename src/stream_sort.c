@@ -0,0 +1,410 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/**
+ * Sắp xếp dạng luồng: sắp xếp trong lúc dữ liệu còn đang đến
+ *
+ * streamSortPush chép dữ liệu vào run cỡ run_size; mỗi run đầy được đưa ngay cho một
+ * worker pthread nền sắp xếp bằng kernel chèn như các backend. Run đã sắp xếp được
+ * xếp theo cấp (cấp k ~ 2^k run gốc): khi hai run cùng cấp gặp nhau, một worker trộn
+ * chúng bằng merge_openmp_chunks thành một run cấp k+1, nên số run luôn cỡ log2(n / run_size).
+ * streamSortFinish chỉ còn đợi các worker xong rồi trộn k-chiều vài run còn lại.
+ *
+ * Một luồng gọi push/read; các worker chỉ chạm vào hàng đợi và bảng cấp dưới khóa.
+ * Số worker do governor đồng thời cấp khi tạo và được giữ tới khi hủy.
+ */
+
+#define OGT_STREAM_MAX_LEVELS 40
+#define OGT_STREAM_READ_BYTES (1024 * 1024)    // khối đọc của streamSortReadFd
+
+typedef struct {
+    int* data;
+    int n;
+    int level;
+} StreamRun;
+
+// Sắp xếp a (b == NULL) hoặc trộn a với b
+typedef struct StreamTask {
+    StreamRun a;
+    StreamRun b;
+    struct StreamTask* next;
+} StreamTask;
+
+struct OGTStreamSort {
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    pthread_t* workers;
+    int num_workers;
+    int granted;                                // luồng governor cấp, trả lại khi hủy
+    int ascending;
+    int run_size;
+
+    StreamTask* head;
+    StreamTask* tail;
+    int active;                                 // task đang chạy
+    int stopping;
+    int failed;
+    StreamRun levels[OGT_STREAM_MAX_LEVELS];    // run đã sắp xếp chờ trộn với run cùng cấp
+
+    int* fill;                                  // run đang gom, chỉ luồng đẩy dùng
+    int fill_count;
+    long long n;
+
+    int runs;
+    int merges;
+    double busy_time;
+    double t_begin;
+    OGTMemScope memory;
+    int memory_open;                            // phạm vi bộ nhớ chưa đóng (chưa finish)
+};
+
+// Gọi khi giữ khóa
+static int enqueueTask(OGTStreamSort* s, StreamRun a, StreamRun b) {
+    StreamTask* task = (StreamTask*)ogtMalloc(sizeof(StreamTask));
+    if (!task) {
+        s->failed = 1;
+        ogtFree(a.data);
+        ogtFree(b.data);
+        return -1;
+    }
+    task->a = a;
+    task->b = b;
+    task->next = NULL;
+    if (s->tail) {
+        s->tail->next = task;
+    } else {
+        s->head = task;
+    }
+    s->tail = task;
+    pthread_cond_signal(&s->work_ready);
+    return 0;
+}
+
+// Gọi khi giữ khóa: giữ run ở cấp của nó hoặc giao việc trộn với run đang chờ
+static void placeRun(OGTStreamSort* s, StreamRun run) {
+    int level = run.level;
+    if (level >= OGT_STREAM_MAX_LEVELS) level = OGT_STREAM_MAX_LEVELS - 1;
+    if (!s->levels[level].data) {
+        s->levels[level] = run;
+        return;
+    }
+    StreamRun other = s->levels[level];
+    s->levels[level].data = NULL;
+    enqueueTask(s, other, run);
+}
+
+static int runTask(StreamTask* task, int ascending, StreamRun* result) {
+    if (!task->b.data) {
+        unsigned long long trace_sort = traceNow();
+        if (ascending) {
+            insertionSortAsc(task->a.data, task->a.n);
+        } else {
+            insertionSortDesc(task->a.data, task->a.n);
+        }
+        traceSpan("stream-sort", trace_sort, task->a.n);
+        *result = task->a;
+        return 0;
+    }
+
+    int n = task->a.n + task->b.n;
+    int* merged = (int*)ogtMalloc((size_t)n * sizeof(int));
+    if (merged) {
+        unsigned long long trace_merge = traceNow();
+        int* chunks[2] = { task->a.data, task->b.data };
+        int sizes[2] = { task->a.n, task->b.n };
+        merge_openmp_chunks(chunks, sizes, 2, merged, n, ascending);
+        traceSpan("stream-merge", trace_merge, n);
+    }
+    ogtFree(task->a.data);
+    ogtFree(task->b.data);
+    if (!merged) return -1;
+
+    int level = task->a.level > task->b.level ? task->a.level : task->b.level;
+    result->data = merged;
+    result->n = n;
+    result->level = level + 1;
+    return 0;
+}
+
+static void* streamWorker(void* arg) {
+    OGTStreamSort* s = (OGTStreamSort*)arg;
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        while (!s->head && !s->stopping) pthread_cond_wait(&s->work_ready, &s->lock);
+        if (!s->head) break;
+
+        StreamTask* task = s->head;
+        s->head = task->next;
+        if (!s->head) s->tail = NULL;
+        s->active++;
+        pthread_mutex_unlock(&s->lock);
+
+        int merge = task->b.data != NULL;
+        double t_task = getCurrentTime();
+        StreamRun result;
+        int status = runTask(task, s->ascending, &result);
+        double busy = getCurrentTime() - t_task;
+
+        pthread_mutex_lock(&s->lock);
+        if (merge) {
+            s->merges++;
+        } else {
+            s->runs++;
+        }
+        s->busy_time += busy;
+        if (status == 0) {
+            placeRun(s, result);
+        } else {
+            s->failed = 1;
+        }
+        ogtFree(task);
+        s->active--;
+        if (!s->head && s->active == 0) pthread_cond_broadcast(&s->work_done);
+    }
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+OGTStreamSort* streamSortCreate(int num_workers, int run_size, int ascending) {
+    if (num_workers < 1) num_workers = 1;
+    if (run_size < 1) run_size = OGT_STREAM_DEFAULT_RUN;
+
+    OGTStreamSort* s = (OGTStreamSort*)ogtCalloc(1, sizeof(OGTStreamSort));
+    if (!s) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho stream sort\n" RESET);
+        return NULL;
+    }
+    memScopeBegin(&s->memory);
+    s->memory_open = 1;
+    s->t_begin = getCurrentTime();
+    s->ascending = ascending;
+    s->run_size = run_size;
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->work_ready, NULL);
+    pthread_cond_init(&s->work_done, NULL);
+
+    s->granted = governorAcquire(num_workers);
+    num_workers = s->granted;
+    s->workers = (pthread_t*)ogtMalloc(num_workers * sizeof(pthread_t));
+    if (s->workers) {
+        for (; s->num_workers < num_workers; s->num_workers++) {
+            if (pthread_create(&s->workers[s->num_workers], NULL, streamWorker, s) != 0) break;
+        }
+    }
+    if (s->num_workers == 0) {
+        printf(RED "Lỗi: Không tạo được worker cho stream sort\n" RESET);
+        streamSortDestroy(s);
+        return NULL;
+    }
+    return s;
+}
+
+// Giao run đang gom cho worker
+static int flushFill(OGTStreamSort* s) {
+    if (s->fill_count == 0) return 0;
+    StreamRun run = { s->fill, s->fill_count, 0 };
+    StreamRun none = { NULL, 0, 0 };
+    s->fill = NULL;
+    s->fill_count = 0;
+
+    pthread_mutex_lock(&s->lock);
+    int status = enqueueTask(s, run, none);
+    pthread_mutex_unlock(&s->lock);
+    return status;
+}
+
+int streamSortPush(OGTStreamSort* s, const int* batch, int n) {
+    if (n < 0 || s->n + n > INT_MAX) {
+        printf(RED "Lỗi: Stream sort vượt quá giới hạn int phần tử\n" RESET);
+        return -1;
+    }
+    if (s->failed) return -1;
+
+    while (n > 0) {
+        if (!s->fill) {
+            s->fill = (int*)ogtMalloc((size_t)s->run_size * sizeof(int));
+            if (!s->fill) {
+                printf(RED "Lỗi: Không đủ bộ nhớ cho run mới\n" RESET);
+                return -1;
+            }
+        }
+        int take = s->run_size - s->fill_count;
+        if (take > n) take = n;
+        memcpy(s->fill + s->fill_count, batch, (size_t)take * sizeof(int));
+        s->fill_count += take;
+        s->n += take;
+        batch += take;
+        n -= take;
+        if (s->fill_count == s->run_size && flushFill(s) != 0) return -1;
+    }
+    return 0;
+}
+
+int streamSortReadFd(OGTStreamSort* s, int fd, int text) {
+    char* buffer = (char*)ogtMalloc(OGT_STREAM_READ_BYTES);
+    int* keys = text ? (int*)ogtMalloc((OGT_STREAM_READ_BYTES / 2 + 1) * sizeof(int)) : NULL;
+    if (!buffer || (text && !keys)) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho bộ đệm đọc\n" RESET);
+        ogtFree(buffer);
+        ogtFree(keys);
+        return -1;
+    }
+
+    int status = 0;
+    size_t filled = 0;          // byte chưa dùng ở đầu bộ đệm (dòng hoặc khóa dở dang)
+    long long consumed = 0;     // byte đã parse, để báo vị trí lỗi
+    for (;;) {
+        ssize_t got = read(fd, buffer + filled, OGT_STREAM_READ_BYTES - filled);
+        if (got < 0) {
+            printf(RED "Lỗi: Đọc dữ liệu vào stream sort thất bại\n" RESET);
+            status = -1;
+            break;
+        }
+        filled += (size_t)got;
+        int eof = got == 0;
+
+        size_t usable;
+        if (!text) {
+            usable = filled - filled % sizeof(int);
+            if (eof && usable != filled) {
+                printf(RED "Lỗi: Dữ liệu nhị phân không chia hết cho 4 byte\n" RESET);
+                status = -1;
+                break;
+            }
+            swapKeyBytes(buffer, usable / sizeof(int), OGT_KEY_INT32);
+            status = streamSortPush(s, (const int*)buffer, (int)(usable / sizeof(int)));
+        } else {
+            // Chỉ parse tới dòng hoàn chỉnh cuối cùng, trừ khi đã hết dữ liệu
+            usable = filled;
+            if (!eof) {
+                while (usable > 0 && buffer[usable - 1] != '\n') usable--;
+                if (usable == 0 && filled == OGT_STREAM_READ_BYTES) {
+                    printf(RED "Lỗi: Dòng dài hơn %d byte\n" RESET, OGT_STREAM_READ_BYTES);
+                    status = -1;
+                    break;
+                }
+            }
+            size_t error_offset = 0;
+            long long count = parseTextKeys(buffer, usable, OGT_KEY_INT32, keys, &error_offset);
+            if (count < 0) {
+                printf(RED "Lỗi: Dòng tại byte %lld không phải số nguyên int32 hợp lệ\n" RESET,
+                       consumed + (long long)error_offset);
+                status = -1;
+                break;
+            }
+            status = streamSortPush(s, keys, (int)count);
+        }
+        if (status != 0) break;
+
+        consumed += (long long)usable;
+        memmove(buffer, buffer + usable, filled - usable);
+        filled -= usable;
+        if (eof) break;
+    }
+
+    ogtFree(buffer);
+    ogtFree(keys);
+    return status;
+}
+
+int streamSortFinish(OGTStreamSort* s, int** result, int* n, OGTStreamSortStats* stats) {
+    OGTStreamSortStats local;
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    *result = NULL;
+    *n = 0;
+
+    double t_finish = getCurrentTime();
+    int status = flushFill(s);
+
+    // Đợi mọi run được sắp xếp và trộn nền rồi dừng worker
+    pthread_mutex_lock(&s->lock);
+    while (s->head || s->active > 0) pthread_cond_wait(&s->work_done, &s->lock);
+    s->stopping = 1;
+    pthread_cond_broadcast(&s->work_ready);
+    pthread_mutex_unlock(&s->lock);
+    for (int w = 0; w < s->num_workers; w++) pthread_join(s->workers[w], NULL);
+    s->num_workers = 0;
+    if (s->failed) status = -1;
+
+    // Run còn lại theo cấp; trộn k-chiều (k ~ log2 số run gốc)
+    int* chunks[OGT_STREAM_MAX_LEVELS];
+    int sizes[OGT_STREAM_MAX_LEVELS];
+    int count = 0;
+    for (int level = 0; level < OGT_STREAM_MAX_LEVELS; level++) {
+        if (!s->levels[level].data) continue;
+        chunks[count] = s->levels[level].data;
+        sizes[count] = s->levels[level].n;
+        count++;
+    }
+
+    if (status == 0 && count == 1) {
+        *result = chunks[0];
+        *n = sizes[0];
+        for (int level = 0; level < OGT_STREAM_MAX_LEVELS; level++) s->levels[level].data = NULL;
+    } else if (status == 0 && count > 1) {
+        int total = (int)s->n;
+        int* merged = (int*)ogtMalloc((size_t)total * sizeof(int));
+        if (merged) {
+            unsigned long long trace_merge = traceNow();
+            merge_openmp_chunks(chunks, sizes, count, merged, total, s->ascending);
+            traceSpan("stream-final-merge", trace_merge, total);
+            *result = merged;
+            *n = total;
+        } else {
+            printf(RED "Lỗi: Không đủ bộ nhớ để trộn %d phần tử\n" RESET, total);
+            status = -1;
+        }
+    }
+
+    double t_end = getCurrentTime();
+    stats->n = s->n;
+    stats->runs = s->runs;
+    stats->merges = s->merges;
+    stats->final_runs = count;
+    stats->ingest_time = t_finish - s->t_begin;
+    stats->finish_time = t_end - t_finish;
+    stats->worker_time = s->busy_time;
+    stats->total_time = t_end - s->t_begin;
+    memScopeEnd(&s->memory, &stats->memory);
+    s->memory_open = 0;
+    return status;
+}
+
+void streamSortDestroy(OGTStreamSort* s) {
+    if (!s) return;
+    if (s->num_workers > 0) {
+        pthread_mutex_lock(&s->lock);
+        s->stopping = 1;
+        pthread_cond_broadcast(&s->work_ready);
+        pthread_mutex_unlock(&s->lock);
+        for (int w = 0; w < s->num_workers; w++) pthread_join(s->workers[w], NULL);
+    }
+    if (s->granted > 0) governorRelease(s->granted);
+
+    // Task chưa chạy (khi hủy mà chưa finish)
+    while (s->head) {
+        StreamTask* task = s->head;
+        s->head = task->next;
+        ogtFree(task->a.data);
+        ogtFree(task->b.data);
+        ogtFree(task);
+    }
+    for (int level = 0; level < OGT_STREAM_MAX_LEVELS; level++) ogtFree(s->levels[level].data);
+    ogtFree(s->fill);
+    ogtFree(s->workers);
+    pthread_mutex_destroy(&s->lock);
+    pthread_cond_destroy(&s->work_ready);
+    pthread_cond_destroy(&s->work_done);
+
+    if (s->memory_open) {
+        OGTMemStats unused;
+        memScopeEnd(&s->memory, &unused);
+    }
+    ogtFree(s);
+}
@@ -0,0 +1,495 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Đọc/ghi file văn bản mỗi dòng một số nguyên
+ *
+ * Đầu vào được map chỉ đọc và chia thành các đoạn theo ranh giới dòng, mỗi luồng OpenMP
+ * một đoạn. Lượt một đếm '\n' để biết vị trí ghi của từng đoạn, lượt hai parse thẳng vào
+ * mảng khóa: 8 chữ số mỗi lần bằng SWAR (phép toán trong một từ 64 bit), phần đuôi từng byte.
+ * Ghi ra cũng hai lượt: tính độ dài văn bản của mỗi đoạn, rồi mỗi luồng định dạng
+ * thẳng vào vùng map của file đầu ra (2 chữ số mỗi lần qua bảng tra).
+ *
+ * Dòng trống được bỏ qua; khoảng trắng và '\r' ở đầu/cuối dòng được chấp nhận.
+ */
+
+#define OGT_TEXT_MIN_SEGMENT (64 * 1024)    // byte tối thiểu mỗi luồng
+
+#define SWAR_ONES   0x0101010101010101ULL
+#define SWAR_HIGHS  0x8080808080808080ULL
+#define SWAR_ZEROS  0x3030303030303030ULL   // '0' ở mọi byte
+
+static const uint64_t powers_of_ten[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static int isLittleEndian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+// Đánh dấu bit cao của mỗi byte khác 0 (không có nhớ tràn giữa các byte)
+static inline uint64_t nonZeroBytes(uint64_t word) {
+    return (((word & ~SWAR_HIGHS) + ~SWAR_HIGHS) | word) & SWAR_HIGHS;
+}
+
+// Số '\n' trong [p, end)
+static long long countNewlines(const char* p, const char* end) {
+    long long count = 0;
+    if (isLittleEndian()) {
+        for (; end - p >= 8; p += 8) {
+            uint64_t word;
+            memcpy(&word, p, sizeof(word));
+            count += __builtin_popcountll(~nonZeroBytes(word ^ ('\n' * SWAR_ONES)) & SWAR_HIGHS);
+        }
+    }
+    for (; p < end; p++) count += *p == '\n';
+    return count;
+}
+
+// Số chữ số liên tiếp ở đầu từ (byte thấp là ký tự đầu tiên), 0..8
+static inline int leadingDigits(uint64_t word) {
+    uint64_t not_digit = ((word & 0xF0F0F0F0F0F0F0F0ULL) ^ SWAR_ZEROS) |
+                         (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) ^ SWAR_ZEROS);
+    uint64_t mask = nonZeroBytes(not_digit);
+    return mask ? __builtin_ctzll(mask) >> 3 : 8;
+}
+
+// Giá trị của 8 chữ số ASCII trong một từ, chữ số đầu ở byte thấp
+static inline uint64_t parseEightDigits(uint64_t word) {
+    word -= SWAR_ZEROS;
+    word = word * 10 + (word >> 8);
+    word = ((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)) +
+            ((word >> 16 & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return word & 0xFFFFFFFFULL;
+}
+
+static inline int isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * Parse các dòng trong [p, end) vào dest
+ * @param swar Dùng SWAR (máy little-endian)
+ * @return Số khóa đã ghi, -1 nếu có dòng không hợp lệ (*error_at là vị trí byte lỗi)
+ */
+static long long parseSegment(const char* p, const char* end, OGTKeyType key, int swar,
+                              void* dest, const char** error_at) {
+    int32_t* out32 = (int32_t*)dest;
+    int64_t* out64 = (int64_t*)dest;
+    uint64_t limit = key == OGT_KEY_INT64 ? (uint64_t)INT64_MAX : (uint64_t)INT32_MAX;
+    long long count = 0;
+
+    while (p < end) {
+        const char* line = p;
+        while (p < end && isBlank(*p)) p++;
+        if (p == end) break;
+        if (*p == '\n') {
+            p++;
+            continue;
+        }
+
+        int negative = 0;
+        if (*p == '-' || *p == '+') {
+            negative = *p == '-';
+            p++;
+        }
+        // Bỏ số 0 đứng đầu để giới hạn 19 chữ số có nghĩa
+        while (p + 1 < end && p[0] == '0' && p[1] >= '0' && p[1] <= '9') p++;
+
+        const char* digits = p;
+        uint64_t value = 0;
+        if (swar) {
+            while (end - p >= 8) {
+                uint64_t word;
+                memcpy(&word, p, sizeof(word));
+                int k = leadingDigits(word);
+                if (k == 0) break;
+                if (p - digits + k > 19) {
+                    *error_at = line;
+                    return -1;
+                }
+                // Dời chữ số lên byte cao; byte thấp trở thành số 0 đứng đầu
+                value = value * powers_of_ten[k] + parseEightDigits(word << (8 * (8 - k)) |
+                                                                    (k == 8 ? 0 : SWAR_ZEROS >> (8 * k)));
+                p += k;
+                if (k < 8) break;
+            }
+        }
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (p - digits >= 19) {
+                *error_at = line;
+                return -1;
+            }
+            value = value * 10 + (uint64_t)(*p - '0');
+            p++;
+        }
+
+        if (p == digits || value > limit + (uint64_t)negative) {
+            *error_at = line;
+            return -1;
+        }
+        while (p < end && isBlank(*p)) p++;
+        if (p < end) {
+            if (*p != '\n') {
+                *error_at = line;
+                return -1;
+            }
+            p++;
+        }
+
+        if (key == OGT_KEY_INT64) {
+            out64[count++] = negative ? (int64_t)(0 - value) : (int64_t)value;
+        } else {
+            out32[count++] = negative ? (int32_t)(0 - (uint32_t)value) : (int32_t)value;
+        }
+    }
+    return count;
+}
+
+long long parseTextKeys(const char* text, size_t bytes, OGTKeyType key, void* keys, size_t* error_offset) {
+    const char* error_at = NULL;
+    long long count = parseSegment(text, text + bytes, key, isLittleEndian(), keys, &error_at);
+    if (count < 0 && error_offset) *error_offset = (size_t)(error_at - text);
+    return count;
+}
+
+static int textThreads(int num_threads, size_t bytes) {
+    int threads = num_threads > 0 ? num_threads : omp_get_max_threads();
+    size_t by_size = bytes / OGT_TEXT_MIN_SEGMENT + 1;
+    if ((size_t)threads > by_size) threads = (int)by_size;
+    return threads < 1 ? 1 : threads;
+}
+
+int readTextKeys(const char* path, OGTKeyType key, int num_threads, void** keys, long long* n) {
+    *keys = NULL;
+    *n = 0;
+    if (key < 0 || key >= OGT_KEY_COUNT) {
+        printf(RED "Lỗi: Kiểu khóa không hợp lệ\n" RESET);
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf(RED "Lỗi: Không mở được file %s\n" RESET, path);
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        printf(RED "Lỗi: Không đọc được kích thước file %s\n" RESET, path);
+        close(fd);
+        return -1;
+    }
+    size_t bytes = (size_t)info.st_size;
+    if (bytes == 0) {
+        close(fd);
+        return 0;
+    }
+
+    const char* data = (const char*)mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf(RED "Lỗi: Không map được file %s\n" RESET, path);
+        return -1;
+    }
+    madvise((void*)data, bytes, MADV_SEQUENTIAL);
+    madvise((void*)data, bytes, MADV_WILLNEED);
+
+    // Ranh giới đoạn: ngay sau '\n' đầu tiên từ vị trí chia đều
+    int threads = textThreads(num_threads, bytes);
+    size_t* bounds = (size_t*)ogtMalloc((threads + 1) * sizeof(size_t));
+    long long* offsets = (long long*)ogtMalloc((threads + 1) * sizeof(long long));
+    long long* counts = (long long*)ogtMalloc(threads * sizeof(long long));
+    if (!bounds || !offsets || !counts) {
+        printf(RED "Lỗi: Không đủ bộ nhớ để parse file %s\n" RESET, path);
+        ogtFree(bounds);
+        ogtFree(offsets);
+        ogtFree(counts);
+        munmap((void*)data, bytes);
+        return -1;
+    }
+    bounds[0] = 0;
+    bounds[threads] = bytes;
+    for (int t = 1; t < threads; t++) {
+        size_t start = bytes / threads * t;
+        if (start < bounds[t - 1]) start = bounds[t - 1];
+        const char* newline = start > 0 ? memchr(data + start - 1, '\n', bytes - start + 1) : data;
+        bounds[t] = newline ? (size_t)(newline - data) + (start > 0) : bytes;
+    }
+
+    // Lượt một: số dòng (cận trên số khóa) mỗi đoạn
+    #pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (int t = 0; t < threads; t++) {
+        counts[t] = countNewlines(data + bounds[t], data + bounds[t + 1]);
+    }
+    offsets[0] = 0;
+    for (int t = 0; t < threads; t++) offsets[t + 1] = offsets[t] + counts[t];
+    if (data[bytes - 1] != '\n') offsets[threads]++;
+
+    size_t width = keyTypeSize(key);
+    long long capacity = offsets[threads];
+    char* dest = (char*)ogtMalloc((size_t)(capacity > 0 ? capacity : 1) * width);
+    if (!dest) {
+        printf(RED "Lỗi: Không đủ bộ nhớ cho %lld khóa\n" RESET, capacity);
+        ogtFree(bounds);
+        ogtFree(offsets);
+        ogtFree(counts);
+        munmap((void*)data, bytes);
+        return -1;
+    }
+
+    // Lượt hai: parse thẳng vào vị trí của đoạn
+    int swar = isLittleEndian();
+    const char* error_at = NULL;
+    #pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (int t = 0; t < threads; t++) {
+        const char* local_error = NULL;
+        counts[t] = parseSegment(data + bounds[t], data + bounds[t + 1], key, swar,
+                                 dest + offsets[t] * width, &local_error);
+        if (counts[t] < 0) {
+            #pragma omp critical(ogt_text_error)
+            if (!error_at || local_error < error_at) error_at = local_error;
+        }
+    }
+
+    int status = 0;
+    long long total = 0;
+    if (error_at) {
+        long long line = countNewlines(data, error_at) + 1;
+        printf(RED "Lỗi: Dòng %lld của %s không phải số nguyên %s hợp lệ\n" RESET,
+               line, path, keyTypeName(key));
+        status = -1;
+    } else {
+        // Dòng trống để lại khoảng hở giữa các đoạn
+        for (int t = 0; t < threads; t++) {
+            if (total != offsets[t]) {
+                memmove(dest + total * width, dest + offsets[t] * width, (size_t)counts[t] * width);
+            }
+            total += counts[t];
+        }
+    }
+
+    ogtFree(bounds);
+    ogtFree(offsets);
+    ogtFree(counts);
+    munmap((void*)data, bytes);
+    if (status != 0) {
+        ogtFree(dest);
+        return -1;
+    }
+    *keys = dest;
+    *n = total;
+    return 0;
+}
+
+// Số chữ số thập phân của value (0 có một chữ số)
+static inline int decimalDigits(uint64_t value) {
+    value |= 1;
+    int guess = ((64 - __builtin_clzll(value)) * 1233) >> 12;
+    return guess + (value >= powers_of_ten[guess]);
+}
+
+static inline uint64_t keyMagnitude(const void* keys, long long i, OGTKeyType key, int* negative) {
+    int64_t value = key == OGT_KEY_INT64 ? ((const int64_t*)keys)[i] : ((const int32_t*)keys)[i];
+    *negative = value < 0;
+    return value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+}
+
+// Ghi các khóa [begin, end) thành văn bản, mỗi khóa một dòng
+static void formatKeys(const void* keys, long long begin, long long end, OGTKeyType key, char* out) {
+    for (long long i = begin; i < end; i++) {
+        int negative;
+        uint64_t value = keyMagnitude(keys, i, key, &negative);
+        if (negative) *out++ = '-';
+        int digits = decimalDigits(value);
+        char* p = out + digits;
+        *p = '\n';
+        while (value >= 100) {
+            unsigned pair = (unsigned)(value % 100) * 2;
+            value /= 100;
+            *--p = digit_pairs[pair + 1];
+            *--p = digit_pairs[pair];
+        }
+        if (value >= 10) {
+            *--p = digit_pairs[value * 2 + 1];
+            *--p = digit_pairs[value * 2];
+        } else {
+            *--p = (char)('0' + value);
+        }
+        out += digits + 1;
+    }
+}
+
+int writeTextKeys(const char* path, const void* keys, long long n, OGTKeyType key, int num_threads) {
+    if (key < 0 || key >= OGT_KEY_COUNT || n < 0) {
+        printf(RED "Lỗi: Kiểu khóa hoặc số khóa không hợp lệ\n" RESET);
+        return -1;
+    }
+
+    int threads = textThreads(num_threads, (size_t)n * 4);
+    long long* offsets = (long long*)ogtMalloc((threads + 1) * sizeof(long long));
+    if (!offsets) {
+        printf(RED "Lỗi: Không đủ bộ nhớ để ghi file %s\n" RESET, path);
+        return -1;
+    }
+
+    // Lượt một: độ dài văn bản của mỗi đoạn khóa
+    offsets[0] = 0;
+    #pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (int t = 0; t < threads; t++) {
+        long long begin = n / threads * t;
+        long long end = t == threads - 1 ? n : n / threads * (t + 1);
+        long long length = 0;
+        for (long long i = begin; i < end; i++) {
+            int negative;
+            uint64_t value = keyMagnitude(keys, i, key, &negative);
+            length += negative + decimalDigits(value) + 1;
+        }
+        offsets[t + 1] = length;
+    }
+    for (int t = 0; t < threads; t++) offsets[t + 1] += offsets[t];
+    size_t bytes = (size_t)offsets[threads];
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf(RED "Lỗi: Không tạo được file %s\n" RESET, path);
+        ogtFree(offsets);
+        return -1;
+    }
+    if (bytes == 0) {
+        ogtFree(offsets);
+        return close(fd);
+    }
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        printf(RED "Lỗi: Không cấp được %zu byte cho file %s\n" RESET, bytes, path);
+        close(fd);
+        ogtFree(offsets);
+        return -1;
+    }
+    char* data = (char*)mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf(RED "Lỗi: Không map được file %s\n" RESET, path);
+        ogtFree(offsets);
+        return -1;
+    }
+
+    // Lượt hai: mỗi luồng định dạng đoạn của mình vào vị trí đã biết
+    #pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (int t = 0; t < threads; t++) {
+        long long begin = n / threads * t;
+        long long end = t == threads - 1 ? n : n / threads * (t + 1);
+        formatKeys(keys, begin, end, key, data + offsets[t]);
+    }
+
+    munmap(data, bytes);
+    ogtFree(offsets);
+    return 0;
+}
+
+int sortTextFile(const char* input, const char* output, OGTKeyType key, OGTBackend backend,
+                 int num_threads, int ascending, OGTTextSortStats* stats) {
+    OGTTextSortStats local;
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    resetSortStats(&stats->sort_stats);
+
+    if (key < 0 || key >= OGT_KEY_COUNT || backend < 0 || backend >= OGT_BACKEND_COUNT) {
+        printf(RED "Lỗi: Kiểu khóa hoặc backend không hợp lệ\n" RESET);
+        return -1;
+    }
+    if (key == OGT_KEY_INT64 && backend == OGT_BACKEND_MPI) {
+        printf(RED "Lỗi: Khóa int64 chưa hỗ trợ backend mpi\n" RESET);
+        return -1;
+    }
+
+    int rank = 0;
+#ifdef HAVE_MPI
+    if (backend == OGT_BACKEND_MPI) MPI_Comm_rank(getMPICommunicator(), &rank);
+#endif
+
+    OGTMemScope memory;
+    memScopeBegin(&memory);
+    double t_begin = getCurrentTime();
+    void* keys = NULL;
+    long long n = 0;
+    int status = 0;
+    // Parse/định dạng trên rank 0 dùng mọi lõi của nó kể cả với backend tuần tự hoặc MPI
+    int io_threads = backend == OGT_BACKEND_OPENMP || backend == OGT_BACKEND_PTHREADS ? num_threads : 0;
+
+    if (rank == 0) {
+        unsigned long long trace_parse = traceNow();
+        status = readTextKeys(input, key, io_threads, &keys, &n);
+        traceSpan("text-parse", trace_parse, n);
+        struct stat info;
+        if (status == 0 && stat(input, &info) == 0) stats->bytes_read = (long long)info.st_size;
+    }
+    stats->parse_time = getCurrentTime() - t_begin;
+
+#ifdef HAVE_MPI
+    if (backend == OGT_BACKEND_MPI) {
+        MPI_Bcast(&status, 1, MPI_INT, 0, getMPICommunicator());
+        MPI_Bcast(&n, 1, MPI_LONG_LONG, 0, getMPICommunicator());
+    }
+#endif
+    if (status != 0) {
+        memScopeEnd(&memory, &stats->memory);
+        return -1;
+    }
+    stats->n = n;
+
+    double t_sort = getCurrentTime();
+    unsigned long long trace_sort = traceNow();
+    status = sortKeys(keys, n, key, backend, num_threads, ascending, &stats->sort_stats);
+    traceSpan("text-sort", trace_sort, n);
+    stats->sort_time = getCurrentTime() - t_sort;
+
+    if (rank == 0) {
+        double t_format = getCurrentTime();
+        unsigned long long trace_format = traceNow();
+        const char* target = output ? output : input;
+        if (status == 0 && writeTextKeys(target, keys, n, key, io_threads) != 0) status = -1;
+        traceSpan("text-format", trace_format, n);
+        struct stat info;
+        if (status == 0 && stat(target, &info) == 0) stats->bytes_written = (long long)info.st_size;
+        stats->format_time = getCurrentTime() - t_format;
+    }
+    ogtFree(keys);
+#ifdef HAVE_MPI
+    if (backend == OGT_BACKEND_MPI) MPI_Bcast(&status, 1, MPI_INT, 0, getMPICommunicator());
+#endif
+
+    stats->total_time = getCurrentTime() - t_begin;
+    memScopeEnd(&memory, &stats->memory);
+    return status;
+}
+
+int textFileIsSorted(const char* path, OGTKeyType key, int ascending) {
+    void* keys;
+    long long n;
+    if (readTextKeys(path, key, 0, &keys, &n) != 0) return -1;
+
+    int sorted = 1;
+    for (long long i = 1; i < n && sorted; i++) {
+        int64_t prev = key == OGT_KEY_INT64 ? ((int64_t*)keys)[i - 1] : ((int32_t*)keys)[i - 1];
+        int64_t next = key == OGT_KEY_INT64 ? ((int64_t*)keys)[i] : ((int32_t*)keys)[i];
+        if (ascending ? next < prev : next > prev) sorted = 0;
+    }
+    ogtFree(keys);
+    return sorted;
+}
@@ -0,0 +1,295 @@
+#include "sort_ogt.h"
+#include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+/**
+ * Trace timeline theo định dạng Chrome trace-event (mở bằng Perfetto hoặc chrome://tracing)
+ *
+ * Mỗi luồng ghi sự kiện vào ring buffer riêng, không khóa: chỉ luồng sở hữu ghi,
+ * head được công bố bằng store release. Khi luồng kết thúc, buffer được trả lại
+ * (in_use = 0) để luồng pthread sau dùng lại qua compare-exchange, nên số buffer
+ * bằng số luồng chạy đồng thời lớn nhất chứ không tăng theo số lần sắp xếp.
+ * Buffer đầy thì sự kiện cũ nhất bị ghi đè.
+ *
+ * traceStop chỉ được gọi khi không còn luồng nào đang sắp xếp.
+ * Với MPI, traceStart/traceStop là hàm tập thể; rank 0 ghi file chung cho mọi rank.
+ */
+
+#ifndef OGT_TRACE_CAPACITY
+#define OGT_TRACE_CAPACITY 16384    // sự kiện mỗi luồng, lũy thừa 2
+#endif
+#define OGT_TRACE_PATH_MAX 1024
+
+typedef struct {
+    const char* name;               // chuỗi hằng, không sao chép
+    unsigned long long start;       // ns, CLOCK_MONOTONIC
+    unsigned long long duration;
+    long long count;                // số phần tử xử lý, -1 nếu không có
+} TraceEvent;
+
+typedef struct TraceBuffer {
+    TraceEvent events[OGT_TRACE_CAPACITY];
+    unsigned long long head;        // tổng số sự kiện đã ghi
+    int slot;                       // tid trên timeline
+    int in_use;
+    struct TraceBuffer* next;
+} TraceBuffer;
+
+static TraceBuffer* trace_buffers = NULL;
+static int trace_slots = 0;
+static int trace_enabled = 0;
+static unsigned long long trace_epoch = 0;
+static char trace_path[OGT_TRACE_PATH_MAX];
+
+static __thread TraceBuffer* local_buffer = NULL;
+static pthread_key_t trace_key;
+static pthread_once_t trace_key_once = PTHREAD_ONCE_INIT;
+
+static unsigned long long traceClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+// Luồng kết thúc: trả buffer về cho luồng khác dùng lại
+static void releaseBuffer(void* buffer) {
+    __atomic_store_n(&((TraceBuffer*)buffer)->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void createTraceKey(void) {
+    pthread_key_create(&trace_key, releaseBuffer);
+}
+
+static TraceBuffer* acquireBuffer(void) {
+    pthread_once(&trace_key_once, createTraceKey);
+
+    // Dùng lại buffer của luồng đã kết thúc
+    TraceBuffer* buffer = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE);
+    for (; buffer; buffer = buffer->next) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&buffer->in_use, &expected, 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    if (!buffer) {
+        buffer = (TraceBuffer*)calloc(1, sizeof(TraceBuffer));
+        if (!buffer) return NULL;
+        buffer->in_use = 1;
+        buffer->slot = __atomic_fetch_add(&trace_slots, 1, __ATOMIC_RELAXED);
+        buffer->next = __atomic_load_n(&trace_buffers, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&trace_buffers, &buffer->next, buffer, 1,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+    }
+
+    pthread_setspecific(trace_key, buffer);
+    local_buffer = buffer;
+    return buffer;
+}
+
+int traceEnabled(void) {
+    return trace_enabled;
+}
+
+// Mốc bắt đầu một sự kiện, 0 nếu trace đang tắt
+unsigned long long traceNow(void) {
+    return trace_enabled ? traceClock() : 0;
+}
+
+/**
+ * Ghi một sự kiện từ start (giá trị của traceNow) tới hiện tại
+ * @param name: Tên sự kiện (chuỗi hằng)
+ * @param start: Mốc bắt đầu; 0 (trace tắt lúc bắt đầu) thì bỏ qua
+ * @param count: Số phần tử xử lý, -1 nếu không có
+ */
+void traceSpan(const char* name, unsigned long long start, long long count) {
+    if (!trace_enabled || start == 0) return;
+    unsigned long long end = traceClock();
+
+    TraceBuffer* buffer = local_buffer ? local_buffer : acquireBuffer();
+    if (!buffer) return;
+
+    unsigned long long head = buffer->head;
+    TraceEvent* event = &buffer->events[head & (OGT_TRACE_CAPACITY - 1)];
+    event->name = name;
+    event->start = start;
+    event->duration = end - start;
+    event->count = count;
+    __atomic_store_n(&buffer->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Bật trace, sự kiện được ghi vào path khi gọi traceStop
+ * Với MPI đã khởi tạo: hàm tập thể, mốc thời gian 0 được đồng bộ bằng barrier
+ * @return 0 nếu thành công, -1 nếu path không hợp lệ
+ */
+int traceStart(const char* path) {
+    if (!path || !*path || strlen(path) >= OGT_TRACE_PATH_MAX) return -1;
+    strcpy(trace_path, path);
+
+    TraceBuffer* buffer = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE);
+    for (; buffer; buffer = buffer->next) {
+        __atomic_store_n(&buffer->head, 0, __ATOMIC_RELAXED);
+    }
+
+    // Luồng gọi traceStart (thường là luồng chính) nhận tid nhỏ nhất
+    if (!local_buffer) acquireBuffer();
+
+#ifdef HAVE_MPI
+    if (isMPIInitialized()) MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    trace_epoch = traceClock();
+    __atomic_store_n(&trace_enabled, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+// Chuỗi tự mở rộng để tuần tự hóa sự kiện
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} TraceText;
+
+static void appendText(TraceText* text, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int needed = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (needed < 0) return;
+
+    if (text->length + (size_t)needed + 1 > text->capacity) {
+        size_t capacity = text->capacity ? text->capacity : 4096;
+        while (text->length + (size_t)needed + 1 > capacity) capacity *= 2;
+        char* data = (char*)realloc(text->data, capacity);
+        if (!data) return;
+        text->data = data;
+        text->capacity = capacity;
+    }
+
+    va_start(args, format);
+    vsnprintf(text->data + text->length, text->capacity - text->length, format, args);
+    va_end(args);
+    text->length += (size_t)needed;
+}
+
+// Tuần tự hóa sự kiện của tiến trình hiện tại, trả về số sự kiện bị ghi đè
+static unsigned long long serializeEvents(TraceText* text, int pid) {
+    unsigned long long dropped = 0;
+
+    // Phần của mỗi rank luôn bắt đầu bằng metadata, các sự kiện sau nối bằng ",\n"
+    appendText(text, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+                     "\"args\":{\"name\":\"rank %d\"}}", pid, pid);
+
+    TraceBuffer* buffer = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE);
+    for (; buffer; buffer = buffer->next) {
+        unsigned long long head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+        if (head == 0) continue;
+
+        unsigned long long first = head > OGT_TRACE_CAPACITY ? head - OGT_TRACE_CAPACITY : 0;
+        dropped += first;
+
+        appendText(text, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                         "\"args\":{\"name\":\"luồng %d\"}}", pid, buffer->slot, buffer->slot);
+
+        for (unsigned long long i = first; i < head; i++) {
+            const TraceEvent* event = &buffer->events[i & (OGT_TRACE_CAPACITY - 1)];
+            double ts = event->start >= trace_epoch ? (event->start - trace_epoch) / 1000.0 : 0.0;
+            appendText(text, ",\n{\"name\":\"%s\",\"cat\":\"ogt\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                             "\"ts\":%.3f,\"dur\":%.3f",
+                       event->name, pid, buffer->slot, ts, event->duration / 1000.0);
+            if (event->count >= 0) {
+                appendText(text, ",\"args\":{\"n\":%lld}", event->count);
+            }
+            appendText(text, "}");
+        }
+    }
+    return dropped;
+}
+
+/**
+ * Tắt trace và ghi file JSON
+ * Với MPI đã khởi tạo: hàm tập thể, sự kiện mọi rank được gom về rank 0
+ * @return 0 nếu thành công (hoặc trace chưa bật), -1 nếu không ghi được file
+ */
+int traceStop(void) {
+    if (!trace_enabled) return 0;
+    __atomic_store_n(&trace_enabled, 0, __ATOMIC_RELEASE);
+
+    int rank = 0, size = 1;
+#ifdef HAVE_MPI
+    int use_mpi = isMPIInitialized();
+    if (use_mpi) getMPIInfo(&rank, &size);
+#endif
+
+    TraceText text = {NULL, 0, 0};
+    unsigned long long dropped = serializeEvents(&text, rank);
+    if (dropped > 0) {
+        fprintf(stderr, YELLOW "Cảnh báo: rank %d có %llu sự kiện trace bị ghi đè "
+                        "(tăng OGT_TRACE_CAPACITY)\n" RESET, rank, dropped);
+    }
+
+    char* all = text.data;
+    size_t all_length = text.length;
+    int* lengths = NULL;
+
+#ifdef HAVE_MPI
+    // Gom chuỗi JSON của mọi rank về rank 0
+    if (use_mpi && size > 1) {
+        int length = (int)text.length;
+        int* displs = NULL;
+        all = NULL;
+        if (rank == 0) {
+            lengths = (int*)malloc(size * sizeof(int));
+            displs = (int*)malloc(size * sizeof(int));
+        }
+        MPI_Gather(&length, 1, MPI_INT, lengths, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            all_length = 0;
+            for (int r = 0; r < size; r++) {
+                displs[r] = (int)all_length;
+                all_length += lengths[r];
+            }
+            all = (char*)malloc(all_length + 1);
+        }
+        MPI_Gatherv(text.data, length, MPI_CHAR, all, lengths, displs, MPI_CHAR, 0, MPI_COMM_WORLD);
+        free(displs);
+    }
+#endif
+
+    int result = 0;
+    if (rank == 0) {
+        FILE* file = fopen(trace_path, "w");
+        if (!file) {
+            printf(RED "Lỗi: Không mở được file trace %s\n" RESET, trace_path);
+            result = -1;
+        } else {
+            fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+            if (lengths) {
+                // Nối phần của từng rank, mỗi phần bắt đầu bằng metadata process_name
+                size_t offset = 0;
+                for (int r = 0; r < size; r++) {
+                    if (r > 0) fprintf(file, ",\n");
+                    fwrite(all + offset, 1, lengths[r], file);
+                    offset += lengths[r];
+                }
+            } else if (all_length > 0) {
+                fwrite(all, 1, all_length, file);
+            }
+            fprintf(file, "\n]}\n");
+            fclose(file);
+        }
+    }
+
+    if (all != text.data) free(all);
+    free(lengths);
+    free(text.data);
+
+#ifdef HAVE_MPI
+    if (use_mpi) MPI_Bcast(&result, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+    return result;
+}
@@ -0,0 +1,232 @@
+#include "sort_ogt.h"
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/**
+ * Hồ sơ tinh chỉnh theo máy
+ *
+ * Các hằng số trước đây cố định lúc biên dịch (ngưỡng tuần tự n < 1000, một khối mỗi luồng,
+ * giới hạn 32 luồng, NUM_RUNS) được đọc từ một file key=value ở lần dùng đầu tiên.
+ * Đường dẫn: OGT_TUNING nếu đặt ("off" để dùng giá trị mặc định), ngược lại
+ * $XDG_CONFIG_HOME/sort_ogt/tuning-<hostname>.conf (hoặc ~/.config/...). Tên máy trong
+ * tên file cho phép nhiều loại máy dùng chung thư mục home mà mỗi máy giữ tối ưu riêng.
+ * ogt_tune đo trên máy hiện tại và ghi file này.
+ */
+
+static const OGTTuning default_tuning = {
+    .seq_cutoff = 1000,
+    .chunks_per_thread = 1,
+    .block_size = 0,
+    .merge = OGT_MERGE_NATIVE,
+    .max_threads = 32,
+    .bench_runs = 7
+};
+
+static OGTTuning active_tuning;
+static char active_source[OGT_TUNING_PATH_MAX];
+static pthread_once_t tuning_once = PTHREAD_ONCE_INIT;
+
+static const char* merge_strategy_names[OGT_MERGE_COUNT] = { "native", "linear", "tree" };
+
+const char* mergeStrategyName(OGTMergeStrategy merge) {
+    if (merge < 0 || merge >= OGT_MERGE_COUNT) return "?";
+    return merge_strategy_names[merge];
+}
+
+int parseMergeStrategy(const char* name) {
+    for (int m = 0; m < OGT_MERGE_COUNT; m++) {
+        if (strcmp(name, merge_strategy_names[m]) == 0) return m;
+    }
+    return -1;
+}
+
+void defaultTuning(OGTTuning* tuning) {
+    *tuning = default_tuning;
+}
+
+int tuningProfilePath(char* path, size_t size) {
+    const char* env = getenv("OGT_TUNING");
+    if (env && *env) {
+        if (strcmp(env, "off") == 0) return -1;
+        snprintf(path, size, "%s", env);
+        return 0;
+    }
+
+    char host[128];
+    if (gethostname(host, sizeof(host)) != 0) snprintf(host, sizeof(host), "localhost");
+    host[sizeof(host) - 1] = '\0';
+
+    const char* config = getenv("XDG_CONFIG_HOME");
+    const char* home = getenv("HOME");
+    if (config && *config) {
+        snprintf(path, size, "%s/sort_ogt/tuning-%s.conf", config, host);
+    } else if (home && *home) {
+        snprintf(path, size, "%s/.config/sort_ogt/tuning-%s.conf", home, host);
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static char* trim(char* text) {
+    while (isspace((unsigned char)*text)) text++;
+    char* end = text + strlen(text);
+    while (end > text && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return text;
+}
+
+// Số nguyên trong [min, max], -1 nếu không hợp lệ
+static int parseTuningInt(const char* value, int min, int max, int* out) {
+    char* end;
+    long parsed = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || parsed < min || parsed > max) return -1;
+    *out = (int)parsed;
+    return 0;
+}
+
+int loadTuningProfile(const char* path, OGTTuning* tuning) {
+    FILE* file = fopen(path, "r");
+    if (!file) return -1;
+
+    defaultTuning(tuning);
+    char line[256];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_no++;
+        char* text = trim(line);
+        if (*text == '\0' || *text == '#') continue;
+
+        char* eq = strchr(text, '=');
+        if (!eq) {
+            fprintf(stderr, YELLOW "⚠️  %s:%d: thiếu '=', bỏ qua" RESET "\n", path, line_no);
+            continue;
+        }
+        *eq = '\0';
+        char* key = trim(text);
+        char* value = trim(eq + 1);
+
+        int status = 0;
+        if (strcmp(key, "seq_cutoff") == 0) {
+            status = parseTuningInt(value, 2, 1 << 24, &tuning->seq_cutoff);
+        } else if (strcmp(key, "chunks_per_thread") == 0) {
+            status = parseTuningInt(value, 1, OGT_TUNING_MAX_CHUNKS, &tuning->chunks_per_thread);
+        } else if (strcmp(key, "block_size") == 0) {
+            status = parseTuningInt(value, 0, 1 << 30, &tuning->block_size);
+        } else if (strcmp(key, "merge") == 0) {
+            int merge = parseMergeStrategy(value);
+            status = merge < 0 ? -1 : 0;
+            if (merge >= 0) tuning->merge = (OGTMergeStrategy)merge;
+        } else if (strcmp(key, "max_threads") == 0) {
+            status = parseTuningInt(value, 1, 4096, &tuning->max_threads);
+        } else if (strcmp(key, "bench_runs") == 0) {
+            status = parseTuningInt(value, 1, OGT_TUNING_MAX_RUNS, &tuning->bench_runs);
+        } else {
+            fprintf(stderr, YELLOW "⚠️  %s:%d: khóa '%s' không xác định, bỏ qua" RESET "\n", path, line_no, key);
+        }
+        if (status != 0) {
+            fprintf(stderr, YELLOW "⚠️  %s:%d: giá trị '%s' không hợp lệ cho %s, giữ mặc định" RESET "\n",
+                    path, line_no, value, key);
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+// Tạo các thư mục cha của path (mkdir -p)
+static void makeParentDirs(const char* path) {
+    char dir[OGT_TUNING_PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s", path);
+    for (char* p = dir + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(dir, 0755) != 0 && errno != EEXIST) return;
+        *p = '/';
+    }
+}
+
+int saveTuningProfile(const char* path, const OGTTuning* tuning, const char* comment) {
+    makeParentDirs(path);
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, RED "Lỗi: Không ghi được hồ sơ tinh chỉnh %s\n" RESET, path);
+        return -1;
+    }
+    fprintf(file, "# Hồ sơ tinh chỉnh sort_ogt %s\n", SORT_OGT_VERSION);
+    if (comment) fprintf(file, "# %s\n", comment);
+    fprintf(file, "seq_cutoff=%d\n", tuning->seq_cutoff);
+    fprintf(file, "chunks_per_thread=%d\n", tuning->chunks_per_thread);
+    fprintf(file, "block_size=%d\n", tuning->block_size);
+    fprintf(file, "merge=%s\n", mergeStrategyName(tuning->merge));
+    fprintf(file, "max_threads=%d\n", tuning->max_threads);
+    fprintf(file, "bench_runs=%d\n", tuning->bench_runs);
+    if (fclose(file) != 0) {
+        fprintf(stderr, RED "Lỗi: Không ghi được hồ sơ tinh chỉnh %s\n" RESET, path);
+        return -1;
+    }
+    return 0;
+}
+
+static void loadActiveTuning(void) {
+    defaultTuning(&active_tuning);
+    snprintf(active_source, sizeof(active_source), "mặc định");
+
+    char path[OGT_TUNING_PATH_MAX];
+    if (tuningProfilePath(path, sizeof(path)) != 0) return;
+    if (loadTuningProfile(path, &active_tuning) == 0) {
+        snprintf(active_source, sizeof(active_source), "%s", path);
+    } else if (getenv("OGT_TUNING")) {
+        // Chỉ cảnh báo khi người dùng chỉ định file; hồ sơ mặc định có thể chưa được tạo
+        fprintf(stderr, YELLOW "⚠️  Không đọc được hồ sơ tinh chỉnh %s, dùng mặc định" RESET "\n", path);
+    }
+}
+
+const OGTTuning* ogtTuning(void) {
+    pthread_once(&tuning_once, loadActiveTuning);
+    return &active_tuning;
+}
+
+const char* tuningSource(void) {
+    ogtTuning();
+    return active_source;
+}
+
+static int clampTuningInt(int value, int min, int max) {
+    return value < min ? min : value > max ? max : value;
+}
+
+void setTuning(const OGTTuning* tuning) {
+    ogtTuning();
+    if (tuning) {
+        // Cùng miền giá trị như loadTuningProfile: bench_runs định cỡ mảng mẫu OGT_TUNING_MAX_RUNS
+        active_tuning = *tuning;
+        active_tuning.seq_cutoff = clampTuningInt(tuning->seq_cutoff, 2, 1 << 24);
+        active_tuning.chunks_per_thread = clampTuningInt(tuning->chunks_per_thread, 1, OGT_TUNING_MAX_CHUNKS);
+        active_tuning.block_size = clampTuningInt(tuning->block_size, 0, 1 << 30);
+        if ((int)tuning->merge < 0 || (int)tuning->merge >= OGT_MERGE_COUNT) active_tuning.merge = default_tuning.merge;
+        active_tuning.max_threads = clampTuningInt(tuning->max_threads, 1, 4096);
+        active_tuning.bench_runs = clampTuningInt(tuning->bench_runs, 1, OGT_TUNING_MAX_RUNS);
+        snprintf(active_source, sizeof(active_source), "đặt bởi chương trình");
+    } else {
+        defaultTuning(&active_tuning);
+        snprintf(active_source, sizeof(active_source), "mặc định");
+    }
+}
+
+int tuningChunkCount(int n, int num_threads) {
+    const OGTTuning* tuning = ogtTuning();
+    long long chunks = (long long)num_threads * tuning->chunks_per_thread;
+    if (tuning->block_size > 0) {
+        long long by_block = ((long long)n + tuning->block_size - 1) / tuning->block_size;
+        if (by_block > chunks) chunks = by_block;
+    }
+    if (chunks > OGT_TUNING_MAX_CHUNKS * (long long)num_threads) {
+        chunks = OGT_TUNING_MAX_CHUNKS * (long long)num_threads;
+    }
+    if (chunks > n) chunks = n;
+    return chunks < 1 ? 1 : (int)chunks;
+}
@@ -1,13 +1,46 @@
 #include "sort_ogt.h"
-#include <sys/time.h>
+#include <time.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
 
-// lấy thời gian hiện tại
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// lấy thời gian hiện tại (giây) theo đồng hồ đơn điệu, độ phân giải nano giây
 double getCurrentTime(void) {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec + tv.tv_usec / 1000000.0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+// đọc bộ đếm chu kỳ (TSC trên x86, nano giây đơn điệu trên kiến trúc khác)
+unsigned long long getTimestampCounter(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// tần số bộ đếm chu kỳ (Hz), đo một lần rồi lưu lại
+double getTimestampCounterHz(void) {
+    static double hz = 0.0;
+    if (hz > 0.0) return hz;
+
+    double t0 = getCurrentTime();
+    unsigned long long c0 = getTimestampCounter();
+    while (getCurrentTime() - t0 < 0.02);
+    double t1 = getCurrentTime();
+    unsigned long long c1 = getTimestampCounter();
+
+    hz = (double)(c1 - c0) / (t1 - t0);
+    return hz;
 }
 
 // cop mảng từ src sang dest
@@ -15,9 +48,529 @@ void copyArray(int src[], int dest[], int n) {
     memcpy(dest, src, n * sizeof(int));
 }
 
-// Tạo mảng random
+// ========== SINH SỐ NGẪU NHIÊN ==========
+// Philox4x32-10 (bộ sinh dựa trên bộ đếm): phần tử thứ i của dòng chỉ phụ thuộc
+// vào (seed, i), nên kết quả giống nhau với mọi số luồng / tiến trình.
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+static unsigned long long random_seed = 0x5EED0C71ULL;
+static long long random_offset = 0;   // vị trí tiếp theo trong dòng của generateRandomArray
+
+static void philox4x32(uint32_t ctr[4], uint32_t key0, uint32_t key1) {
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * ctr[0];
+        uint64_t p1 = (uint64_t)PHILOX_M1 * ctr[2];
+        uint32_t x0 = (uint32_t)(p1 >> 32) ^ ctr[1] ^ key0;
+        uint32_t x2 = (uint32_t)(p0 >> 32) ^ ctr[3] ^ key1;
+        ctr[1] = (uint32_t)p1;
+        ctr[3] = (uint32_t)p0;
+        ctr[0] = x0;
+        ctr[2] = x2;
+        key0 += PHILOX_W0;
+        key1 += PHILOX_W1;
+    }
+}
+
+// Giá trị 32 bit thứ index của dòng (seed), lần thử attempt
+static uint32_t philoxWord(unsigned long long seed, long long index, uint32_t attempt) {
+    uint64_t block = (uint64_t)index >> 2;
+    uint32_t ctr[4] = { (uint32_t)block, (uint32_t)(block >> 32), attempt, 0 };
+    philox4x32(ctr, (uint32_t)seed, (uint32_t)(seed >> 32));
+    return ctr[index & 3];
+}
+
+// Số nguyên trong [0, max_val) không lệch modulo (phương pháp nhân của Lemire)
+static int philoxBounded(unsigned long long seed, long long index, uint32_t range) {
+    uint32_t attempt = 0;
+    uint64_t m = (uint64_t)philoxWord(seed, index, attempt) * range;
+    uint32_t low = (uint32_t)m;
+    if (low < range) {
+        uint32_t threshold = (uint32_t)(-range) % range;
+        while (low < threshold) {
+            m = (uint64_t)philoxWord(seed, index, ++attempt) * range;
+            low = (uint32_t)m;
+        }
+    }
+    return (int)(m >> 32);
+}
+
+void setRandomSeed(unsigned long long seed) {
+    random_seed = seed;
+    random_offset = 0;
+}
+
+unsigned long long getRandomSeed(void) {
+    return random_seed;
+}
+
+// Lấy vị trí bắt đầu cho n phần tử tiếp theo của dòng ngẫu nhiên chung (an toàn đa luồng)
+long long reserveRandomStream(int n) {
+    return __atomic_fetch_add(&random_offset, (long long)n, __ATOMIC_RELAXED);
+}
+
+// Sinh các phần tử [first_index, first_index + count) của dòng (seed), song song
+void generateRandomRange(int arr[], long long first_index, int count, int max_val, unsigned long long seed) {
+    if (count <= 0) return;
+
+    if (max_val <= 0) {
+        memset(arr, 0, (size_t)count * sizeof(int));
+        return;
+    }
+
+    uint32_t range = (uint32_t)max_val;
+    long long first_block = first_index >> 2;
+    long long last_block = (first_index + count - 1) >> 2;
+
+    // Mỗi lần gọi Philox cho 4 từ 32 bit = 4 phần tử liên tiếp
+    #pragma omp parallel for schedule(static)
+    for (long long block = first_block; block <= last_block; block++) {
+        uint32_t ctr[4] = { (uint32_t)block, (uint32_t)((uint64_t)block >> 32), 0, 0 };
+        philox4x32(ctr, (uint32_t)seed, (uint32_t)(seed >> 32));
+
+        for (int j = 0; j < 4; j++) {
+            long long index = block * 4 + j;
+            if (index < first_index || index >= first_index + count) continue;
+
+            uint64_t m = (uint64_t)ctr[j] * range;
+            // Trường hợp hiếm có thể bị lệch: chuyển sang đường chậm có loại bỏ
+            arr[index - first_index] = (uint32_t)m < range ? philoxBounded(seed, index, range) : (int)(m >> 32);
+        }
+    }
+}
+
+void generateRandomArraySeeded(int arr[], int n, int max_val, unsigned long long seed) {
+    generateRandomRange(arr, 0, n, max_val, seed);
+}
+
+// Tạo mảng random: lấy n phần tử tiếp theo của dòng theo seed hiện tại,
+// mỗi lần gọi cho dữ liệu khác nhau nhưng cả chuỗi lặp lại được với cùng seed
 void generateRandomArray(int arr[], int n, int max_val) {
+    generateRandomRange(arr, reserveRandomStream(n), n, max_val, random_seed);
+}
+
+// ========== CÁC PHÂN PHỐI DỮ LIỆU ==========
+
+#define DIST_FEW_UNIQUE_VALUES 8
+#define DIST_SAWTOOTH_TEETH 16
+#define DIST_SORTED_RUNS 16
+#define DIST_ZIPF_MAX_KEYS (1 << 20)
+
+static const char* distribution_names[OGT_DIST_COUNT] = {
+    "uniform", "sorted", "reverse", "nearly-sorted", "few-unique",
+    "zipf", "organ-pipe", "sawtooth", "all-equal", "sorted-runs"
+};
+
+const char* distributionName(OGTDistribution dist) {
+    if (dist < 0 || dist >= OGT_DIST_COUNT) return "?";
+    return distribution_names[dist];
+}
+
+// Trả về phân phối theo tên, -1 nếu không hợp lệ
+int parseDistribution(const char* name) {
+    for (int d = 0; d < OGT_DIST_COUNT; d++) {
+        if (strcmp(name, distribution_names[d]) == 0) return d;
+    }
+    return -1;
+}
+
+// "tên" hoặc "tên:K"; chỉ nearly-sorted nhận K (số cặp hoán đổi, >= 0)
+int parseDistributionSpec(const char* spec, int* param) {
+    *param = OGT_DIST_DEFAULT_PARAM;
+    const char* colon = strchr(spec, ':');
+    if (!colon) return parseDistribution(spec);
+
+    char name[32];
+    size_t len = (size_t)(colon - spec);
+    if (len >= sizeof(name)) return -1;
+    memcpy(name, spec, len);
+    name[len] = '\0';
+    if (parseDistribution(name) != OGT_DIST_NEARLY_SORTED) return -1;
+
+    char* end;
+    long value = strtol(colon + 1, &end, 10);
+    if (end == colon + 1 || *end != '\0' || value < 0 || value > INT_MAX) return -1;
+    *param = (int)value;
+    return OGT_DIST_NEARLY_SORTED;
+}
+
+const char* distributionSpec(OGTDistribution dist, int param, char* buf, size_t size) {
+    if (dist == OGT_DIST_NEARLY_SORTED && param >= 0) {
+        snprintf(buf, size, "%s:%d", distributionName(dist), param);
+    } else {
+        snprintf(buf, size, "%s", distributionName(dist));
+    }
+    return buf;
+}
+
+static const char* backend_names[OGT_BACKEND_COUNT] = {
+    "seq", "openmp", "pthreads", "mpi"
+};
+
+const char* backendName(OGTBackend backend) {
+    if (backend < 0 || backend >= OGT_BACKEND_COUNT) return "?";
+    return backend_names[backend];
+}
+
+// Trả về backend theo tên, -1 nếu không hợp lệ
+int parseBackend(const char* name) {
+    for (int b = 0; b < OGT_BACKEND_COUNT; b++) {
+        if (strcmp(name, backend_names[b]) == 0) return b;
+    }
+    return -1;
+}
+
+// Giá trị thứ i của dãy tăng dần trải đều trên [0, max_val)
+static int rampValue(long long i, long long len, int max_val) {
+    return len > 0 ? (int)(i * max_val / len) : 0;
+}
+
+// Số thực trong [0, 1) từ dòng Philox
+static double philoxUnit(unsigned long long seed, long long index) {
+    return philoxWord(seed, index, 0) / 4294967296.0;
+}
+
+// Zipf (s = 1) trên max_val khóa bằng bảng CDF, khóa nhỏ xuất hiện nhiều nhất
+static void generateZipfArray(int arr[], int n, int max_val, unsigned long long seed) {
+    int keys = max_val < DIST_ZIPF_MAX_KEYS ? max_val : DIST_ZIPF_MAX_KEYS;
+    double* cdf = malloc(keys * sizeof(double));
+    double sum = 0.0;
+    for (int k = 0; k < keys; k++) {
+        sum += 1.0 / (k + 1);
+        cdf[k] = sum;
+    }
+
+    #pragma omp parallel for schedule(static)
     for (int i = 0; i < n; i++) {
-        arr[i] = rand() % max_val;
+        double u = philoxUnit(seed, i) * sum;
+        int lo = 0, hi = keys - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u) lo = mid + 1; else hi = mid;
+        }
+        arr[i] = lo;
     }
-} 
\ No newline at end of file
+
+    free(cdf);
+}
+
+void generateDistributionArray(int arr[], int n, int max_val, OGTDistribution dist, unsigned long long seed) {
+    generateDistributionArrayParam(arr, n, max_val, dist, OGT_DIST_DEFAULT_PARAM, seed);
+}
+
+/**
+ * Sinh mảng theo phân phối dist, tái lập được theo seed
+ * @param arr: Mảng kết quả
+ * @param n: Số phần tử
+ * @param max_val: Giá trị tối đa (không bao gồm)
+ * @param dist: Phân phối dữ liệu
+ * @param param: Số cặp hoán đổi của nearly-sorted; OGT_DIST_DEFAULT_PARAM là n/100
+ * @param seed: Seed cho các phân phối có yếu tố ngẫu nhiên
+ */
+void generateDistributionArrayParam(int arr[], int n, int max_val, OGTDistribution dist, int param,
+                                    unsigned long long seed) {
+    if (n <= 0) return;
+    if (max_val <= 0) max_val = 1;
+
+    switch (dist) {
+        case OGT_DIST_SORTED:
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) arr[i] = rampValue(i, n, max_val);
+            break;
+
+        case OGT_DIST_REVERSE:
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) arr[i] = rampValue(n - 1 - i, n, max_val);
+            break;
+
+        case OGT_DIST_NEARLY_SORTED: {
+            // Mảng đã sắp xếp với param (mặc định n/100) cặp bị hoán đổi ngẫu nhiên
+            int swaps = param >= 0 ? param : n / 100 > 0 ? n / 100 : 1;
+            generateDistributionArray(arr, n, max_val, OGT_DIST_SORTED, seed);
+            for (int k = 0; k < swaps; k++) {
+                int i = philoxBounded(seed, 2LL * k, (uint32_t)n);
+                int j = philoxBounded(seed, 2LL * k + 1, (uint32_t)n);
+                int tmp = arr[i];
+                arr[i] = arr[j];
+                arr[j] = tmp;
+            }
+            break;
+        }
+
+        case OGT_DIST_FEW_UNIQUE: {
+            int step = max_val / DIST_FEW_UNIQUE_VALUES > 0 ? max_val / DIST_FEW_UNIQUE_VALUES : 1;
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) {
+                arr[i] = philoxBounded(seed, i, DIST_FEW_UNIQUE_VALUES) * step;
+            }
+            break;
+        }
+
+        case OGT_DIST_ZIPF:
+            generateZipfArray(arr, n, max_val, seed);
+            break;
+
+        case OGT_DIST_ORGAN_PIPE: {
+            // Tăng dần tới giữa mảng rồi giảm dần
+            int half = (n + 1) / 2;
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) {
+                arr[i] = i < half ? rampValue(i, half, max_val) : rampValue(n - 1 - i, half, max_val);
+            }
+            break;
+        }
+
+        case OGT_DIST_SAWTOOTH: {
+            int period = n / DIST_SAWTOOTH_TEETH > 0 ? n / DIST_SAWTOOTH_TEETH : 1;
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) arr[i] = rampValue(i % period, period, max_val);
+            break;
+        }
+
+        case OGT_DIST_ALL_EQUAL:
+            for (int i = 0; i < n; i++) arr[i] = max_val / 2;
+            break;
+
+        case OGT_DIST_SORTED_RUNS: {
+            // Nối DIST_SORTED_RUNS dãy tăng dần, mỗi dãy có bước tăng ngẫu nhiên
+            int run_len = n / DIST_SORTED_RUNS > 0 ? n / DIST_SORTED_RUNS : 1;
+            int num_runs = (n + run_len - 1) / run_len;
+            #pragma omp parallel for schedule(static)
+            for (int r = 0; r < num_runs; r++) {
+                int start = r * run_len;
+                int end = start + run_len < n ? start + run_len : n;
+                double max_step = 2.0 * max_val / run_len;
+                double value = 0.0;
+                for (int i = start; i < end; i++) {
+                    value += philoxUnit(seed, i) * max_step;
+                    arr[i] = value < max_val ? (int)value : max_val - 1;
+                }
+            }
+            break;
+        }
+
+        case OGT_DIST_UNIFORM:
+        default:
+            generateRandomArraySeeded(arr, n, max_val, seed);
+            break;
+    }
+}
+
+// ========== THỐNG KÊ THEO PHA ==========
+
+void resetSortStats(OGTSortStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+const char* phaseName(OGTPhase phase) {
+    static const char* names[OGT_PHASE_COUNT] = {
+        "split", "copy", "sort", "merge", "copy-back", "comm"
+    };
+    if (phase < 0 || phase >= OGT_PHASE_COUNT) return "?";
+    return names[phase];
+}
+
+// Cộng dồn stats của một lần chạy vào sum (để lấy trung bình nhiều lần chạy)
+void accumulateSortStats(OGTSortStats* sum, const OGTSortStats* stats) {
+    sum->total_time += stats->total_time;
+    if (stats->num_threads > sum->num_threads) sum->num_threads = stats->num_threads;
+    for (int p = 0; p < OGT_PHASE_COUNT; p++) {
+        sum->phase_time[p] += stats->phase_time[p];
+        sum->phase_bytes[p] += stats->phase_bytes[p];
+        addCounterValues(&sum->phase_counters[p], &stats->phase_counters[p]);
+    }
+    for (int t = 0; t < OGT_STATS_MAX_THREADS; t++) {
+        for (int p = 0; p < OGT_PHASE_COUNT; p++) {
+            sum->thread_time[t][p] += stats->thread_time[t][p];
+        }
+        addCounterValues(&sum->thread_counters[t], &stats->thread_counters[t]);
+    }
+    sum->memory.bytes_allocated += stats->memory.bytes_allocated;
+    sum->memory.allocations += stats->memory.allocations;
+    sum->memory.peak_bytes += stats->memory.peak_bytes;
+    sum->memory.peak_rss_kb += stats->memory.peak_rss_kb;
+}
+
+void scaleSortStats(OGTSortStats* stats, double factor) {
+    stats->total_time *= factor;
+    for (int p = 0; p < OGT_PHASE_COUNT; p++) {
+        stats->phase_time[p] *= factor;
+        stats->phase_bytes[p] *= factor;
+        for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+            stats->phase_counters[p].value[c] *= factor;
+        }
+    }
+    for (int t = 0; t < OGT_STATS_MAX_THREADS; t++) {
+        for (int p = 0; p < OGT_PHASE_COUNT; p++) {
+            stats->thread_time[t][p] *= factor;
+        }
+        for (int c = 0; c < OGT_COUNTER_COUNT; c++) {
+            stats->thread_counters[t].value[c] *= factor;
+        }
+    }
+    stats->memory.bytes_allocated = (long long)(stats->memory.bytes_allocated * factor);
+    stats->memory.allocations = (long long)(stats->memory.allocations * factor);
+    stats->memory.peak_bytes = (long long)(stats->memory.peak_bytes * factor);
+    stats->memory.peak_rss_kb = (long long)(stats->memory.peak_rss_kb * factor);
+}
+
+// ========== THỐNG KÊ MẪU ĐO ==========
+
+static int compareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Phân vị q (0..1) của mảng đã sắp xếp, nội suy tuyến tính
+static double sortedQuantile(const double sorted[], int n, double q) {
+    if (n <= 0) return 0.0;
+    double pos = q * (n - 1);
+    int lo = (int)pos;
+    if (lo >= n - 1) return sorted[n - 1];
+    return sorted[lo] + (pos - lo) * (sorted[lo + 1] - sorted[lo]);
+}
+
+// Giá trị tới hạn t hai phía 95% của phân phối Student với dof bậc tự do
+double studentT95(double dof) {
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (dof < 1.0) return table[0];
+    if (dof <= 30.0) return table[(int)dof - 1];
+    return 1.96 + 2.4 / dof;
+}
+
+/**
+ * Tính thống kê của các lần đo sau khi loại ngoại lai
+ * Ngoại lai: nằm ngoài [Q1 - 1.5 IQR, Q3 + 1.5 IQR] (chỉ áp dụng khi có >= 4 mẫu)
+ * @param samples: Thời gian các lần đo (giây)
+ * @param n: Số lần đo
+ * @param out: Kết quả
+ */
+void computeSampleStats(const double samples[], int n, OGTSampleStats* out) {
+    memset(out, 0, sizeof(*out));
+    if (n <= 0) return;
+
+    double* sorted = malloc(n * sizeof(double));
+    memcpy(sorted, samples, n * sizeof(double));
+    qsort(sorted, n, sizeof(double), compareDouble);
+
+    // Loại ngoại lai theo hàng rào Tukey, mảng vẫn giữ thứ tự tăng dần
+    int first = 0, last = n;
+    if (n >= 4) {
+        double q1 = sortedQuantile(sorted, n, 0.25);
+        double q3 = sortedQuantile(sorted, n, 0.75);
+        double low = q1 - 1.5 * (q3 - q1);
+        double high = q3 + 1.5 * (q3 - q1);
+        while (first < last && sorted[first] < low) first++;
+        while (last > first && sorted[last - 1] > high) last--;
+    }
+
+    const double* kept = sorted + first;
+    int count = last - first;
+    out->count = count;
+    out->outliers = n - count;
+    out->min = kept[0];
+    out->max = kept[count - 1];
+    out->median = sortedQuantile(kept, count, 0.5);
+    out->p95 = sortedQuantile(kept, count, 0.95);
+
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += kept[i];
+    out->mean = sum / count;
+
+    double sq = 0.0;
+    for (int i = 0; i < count; i++) sq += (kept[i] - out->mean) * (kept[i] - out->mean);
+    out->stddev = count > 1 ? sqrt(sq / (count - 1)) : 0.0;
+
+    // Khoảng tin cậy 95% của giá trị trung bình
+    double half = count > 1 ? studentT95(count - 1) * out->stddev / sqrt(count) : 0.0;
+    out->ci_low = out->mean - half;
+    out->ci_high = out->mean + half;
+
+    free(sorted);
+}
+
+/**
+ * So sánh hai tập đo bằng kiểm định t Welch (mức ý nghĩa 5%)
+ * @param base: Thống kê của tập gốc
+ * @param cur: Thống kê của tập mới
+ * @param min_effect: Thay đổi tương đối tối thiểu để được tính (vd 0.02 = 2%)
+ * @return 1 nếu cur nhanh hơn có ý nghĩa, -1 nếu chậm hơn có ý nghĩa, 0 nếu không đổi
+ */
+int compareSampleStats(const OGTSampleStats* base, const OGTSampleStats* cur, double min_effect) {
+    if (base->count == 0 || cur->count == 0 || base->mean <= 0.0) return 0;
+
+    double diff = cur->mean - base->mean;
+    if (fabs(diff) / base->mean < min_effect) return 0;
+
+    double vb = base->count > 1 ? base->stddev * base->stddev / base->count : 0.0;
+    double vc = cur->count > 1 ? cur->stddev * cur->stddev / cur->count : 0.0;
+    double se = sqrt(vb + vc);
+
+    if (se > 0.0) {
+        // Bậc tự do Welch–Satterthwaite
+        double dof_den = 0.0;
+        if (base->count > 1) dof_den += vb * vb / (base->count - 1);
+        if (cur->count > 1) dof_den += vc * vc / (cur->count - 1);
+        double dof = dof_den > 0.0 ? (vb + vc) * (vb + vc) / dof_den : 1.0;
+        if (fabs(diff) / se <= studentT95(dof)) return 0;
+    }
+
+    return diff < 0.0 ? 1 : -1;
+}
+
+// ========== PHÂN TÍCH MỞ RỘNG ==========
+
+static const char* scaling_mode_names[] = { "strong", "weak" };
+
+const char* scalingModeName(OGTScalingMode mode) {
+    if (mode < OGT_SCALING_STRONG || mode > OGT_SCALING_WEAK) return "?";
+    return scaling_mode_names[mode];
+}
+
+int parseScalingMode(const char* name) {
+    for (int m = OGT_SCALING_STRONG; m <= OGT_SCALING_WEAK; m++) {
+        if (strcmp(name, scaling_mode_names[m]) == 0) return m;
+    }
+    return -1;
+}
+
+/**
+ * Tỉ lệ tuần tự Karp–Flatt: e = (1/S - 1/p) / (1 - 1/p)
+ * e tăng theo p cho thấy chi phí phụ trội song song (giao tiếp, trộn) tăng,
+ * e gần như không đổi cho thấy giới hạn là phần tuần tự của thuật toán
+ * @return e, hoặc 0 khi p <= 1 hoặc speedup không hợp lệ
+ */
+double karpFlattFraction(double speedup, int workers) {
+    if (workers <= 1 || speedup <= 0.0) return 0.0;
+    double inv_p = 1.0 / workers;
+    return (1.0 / speedup - inv_p) / (1.0 - inv_p);
+}
+
+/**
+ * Tính speedup, hiệu suất và Karp–Flatt của một điểm đo
+ * @param mode: strong (S = T1/Tp, E = S/p) hoặc weak (S = p*T1/Tp, E = T1/Tp)
+ * @param base_time: Thời gian với 1 worker
+ * @param time: Thời gian với workers worker
+ */
+void computeScalingPoint(OGTScalingMode mode, int workers, double base_time, double time, OGTScalingPoint* point) {
+    memset(point, 0, sizeof(*point));
+    point->workers = workers;
+    point->time = time;
+    if (time <= 0.0 || base_time <= 0.0 || workers <= 0) return;
+
+    if (mode == OGT_SCALING_WEAK) {
+        point->efficiency = base_time / time;
+        point->speedup = workers * point->efficiency;
+    } else {
+        point->speedup = base_time / time;
+        point->efficiency = point->speedup / workers;
+    }
+    point->karp_flatt = karpFlattFraction(point->speedup, workers);
+}